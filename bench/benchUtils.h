@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include "../neighborsProblem/item/item.h"
+#include "../neighborsProblem/utils/utils.h"
+
+/* Helpers for microbenchmarks - Same items in every run */
+
+/* Dimensions of kernels: 32, 64, ..., 4096 */
+#define BENCH_MIN_DIM 32
+#define BENCH_MAX_DIM 4096
+
+/* Item with random components in [MY_MIN_RANDOM, MY_MAX_RANDOM] */
+static inline Item randomItem(int dim, unsigned seed){
+    randomGenerator generator(seed);
+    std::vector<double> components(dim);
+    errorCode status;
+
+    for(int i = 0; i < dim; i++)
+        components[i] = generator.uniform(MY_MIN_RANDOM, MY_MAX_RANDOM);
+
+    return Item(components, status);
+}
+
+// Petropoulakis Panagiotis
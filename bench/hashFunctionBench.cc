@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include "benchUtils.h"
+#include "../neighborsProblem/item/item.h"
+#include "../neighborsProblem/utils/utils.h"
+#include "../neighborsProblem/hashFunction/hashFunction.h"
+
+/* Microbenchmarks of hash functions - Default parameters of the models */
+
+static void BM_hEuclideanHash(benchmark::State& state){
+    int dim = state.range(0);
+    Item p = randomItem(dim, 1);
+    hEuclidean function(dim, 500, DEFAULT_SEED);
+    errorCode status;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(function.hash(p, status));
+}
+BENCHMARK(BM_hEuclideanHash)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+/* k = 4, w = 500, table size = 2500(10000 points) */
+static void BM_hashFunctionEuclideanHash(benchmark::State& state){
+    int dim = state.range(0);
+    Item p = randomItem(dim, 1);
+    hashFunctionEuclidean function(dim, 4, 500, 2500, DEFAULT_SEED);
+    errorCode status;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(function.hash(p, status));
+}
+BENCHMARK(BM_hashFunctionEuclideanHash)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+/* k = 8 */
+static void BM_hashFunctionCosineHash(benchmark::State& state){
+    int dim = state.range(0);
+    Item p = randomItem(dim, 1);
+    hashFunctionCosine function(dim, 8, DEFAULT_SEED);
+    errorCode status;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(function.hash(p, status));
+}
+BENCHMARK(BM_hashFunctionCosineHash)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+/* k = 9, w = 800 */
+static void BM_hashFunctionEuclideanHypercubeHash(benchmark::State& state){
+    int dim = state.range(0);
+    Item p = randomItem(dim, 1);
+    hashFunctionEuclideanHypercube function(dim, 9, 800, DEFAULT_SEED);
+    errorCode status;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(function.hash(p, status));
+}
+BENCHMARK(BM_hashFunctionEuclideanHypercubeHash)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+// Petropoulakis Panagiotis
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include "benchUtils.h"
+#include "../neighborsProblem/item/item.h"
+#include "../neighborsProblem/utils/utils.h"
+
+/* Microbenchmarks of distance kernels */
+
+static void BM_euclideanDist(benchmark::State& state){
+    int dim = state.range(0);
+    Item x = randomItem(dim, 1), y = randomItem(dim, 2);
+    errorCode status;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(x.euclideanDist(y, status));
+
+    state.SetBytesProcessed(state.iterations() * 2 * dim * sizeof(double));
+}
+BENCHMARK(BM_euclideanDist)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+static void BM_cosineDist(benchmark::State& state){
+    int dim = state.range(0);
+    Item x = randomItem(dim, 1), y = randomItem(dim, 2);
+    errorCode status;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(x.cosineDist(y, status));
+
+    state.SetBytesProcessed(state.iterations() * 2 * dim * sizeof(double));
+}
+BENCHMARK(BM_cosineDist)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+/* Bound of half the distance - Partial sums reach it before the last dimension */
+static void BM_euclideanDistBounded(benchmark::State& state){
+    int dim = state.range(0);
+    Item x = randomItem(dim, 1), y = randomItem(dim, 2);
+    errorCode status;
+    double bound = x.euclideanDist(y, status) / 2;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(x.euclideanDist(y, bound, status));
+
+    state.SetBytesProcessed(state.iterations() * 2 * dim * sizeof(double));
+}
+BENCHMARK(BM_euclideanDistBounded)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+static void BM_innerProduct(benchmark::State& state){
+    int dim = state.range(0);
+    Item x = randomItem(dim, 1), y = randomItem(dim, 2);
+    errorCode status;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(x.innerProduct(y, status));
+
+    state.SetBytesProcessed(state.iterations() * 2 * dim * sizeof(double));
+}
+BENCHMARK(BM_innerProduct)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+/* DOT_TILE products per call - Bytes of x are counted once */
+static void BM_dotProducts(benchmark::State& state){
+    int i, dim = state.range(0);
+    Item x = randomItem(dim, 1);
+    std::vector<Item> y;
+    const double* yData[DOT_TILE];
+    double products[DOT_TILE];
+
+    for(i = 0; i < DOT_TILE; i++)
+        y.push_back(randomItem(dim, i + 2));
+    for(i = 0; i < DOT_TILE; i++)
+        yData[i] = y[i].getComponents().data();
+
+    for(auto _ : state){
+        dotProducts(x.getComponents().data(), yData, dim, products);
+        benchmark::DoNotOptimize(products);
+    }
+
+    state.SetBytesProcessed(state.iterations() * (DOT_TILE + 1) * dim * sizeof(double));
+}
+BENCHMARK(BM_dotProducts)->RangeMultiplier(2)->Range(BENCH_MIN_DIM, BENCH_MAX_DIM);
+
+// Petropoulakis Panagiotis
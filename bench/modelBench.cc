@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <list>
+#include "benchUtils.h"
+#include "../neighborsProblem/item/item.h"
+#include "../neighborsProblem/utils/utils.h"
+#include "../neighborsProblem/model/model.h"
+#include "../neighborsProblem/model/lsh/lsh.h"
+#include "../neighborsProblem/model/hypercube/hypercube.h"
+
+/* Microbenchmarks of lsh and hypercube queries - nNeighbor of fitted models, */
+/* so bucket scans, probes and the rerank stage of the models are measured    */
+
+/* Points of fitted models and queries of a run */
+#define MODEL_POINTS MIN_POINTS
+#define MODEL_QUERIES 64
+
+/* Dimensions of models: 32 to 512 - Fit is not measured */
+#define MODEL_MAX_DIM 512
+
+/* Fit given model with MODEL_POINTS random points - Arguments are dim and rerank */
+static void fitModel(model& newModel, int dim, int rerank, int sketch, std::vector<Item>& queries, benchmark::State& state){
+    std::list<Item> points;
+    errorCode status;
+    int i;
+
+    for(i = 0; i < MODEL_POINTS; i++)
+        points.push_back(randomItem(dim, i + 1));
+
+    for(i = 0; i < MODEL_QUERIES; i++)
+        queries.push_back(randomItem(dim, MODEL_POINTS + i + 1));
+
+    newModel.setRerank(rerank, sketch, status);
+    if(status == SUCCESS)
+        newModel.fit(points, status);
+
+    if(status != SUCCESS)
+        state.SkipWithError("Model can't be fitted");
+}
+
+/* Nearest neighbor of every query - Items processed are queries */
+static void runQueries(model& newModel, std::vector<Item>& queries, benchmark::State& state){
+    Item neighbor;
+    double neighborDistance;
+    errorCode status;
+    size_t i = 0;
+
+    for(auto _ : state){
+        newModel.nNeighbor(queries[i], neighbor, &neighborDistance, status);
+        benchmark::DoNotOptimize(neighborDistance);
+
+        i = (i + 1) % queries.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_lshEuclideanNNeighbor(benchmark::State& state){
+    lshEuclidean newModel;
+    std::vector<Item> queries;
+
+    fitModel(newModel, state.range(0), state.range(1), 0, queries, state);
+    runQueries(newModel, queries, state);
+}
+BENCHMARK(BM_lshEuclideanNNeighbor)->ArgsProduct({benchmark::CreateRange(BENCH_MIN_DIM, MODEL_MAX_DIM, 4), {0, 20}});
+
+/* Third argument: 1 ranks candidates by sign sketches, 0 by quantized codes */
+static void BM_lshCosineNNeighbor(benchmark::State& state){
+    lshCosine newModel;
+    std::vector<Item> queries;
+
+    fitModel(newModel, state.range(0), state.range(1), state.range(2), queries, state);
+    runQueries(newModel, queries, state);
+}
+BENCHMARK(BM_lshCosineNNeighbor)->ArgsProduct({benchmark::CreateRange(BENCH_MIN_DIM, MODEL_MAX_DIM, 4), {0, 20}, {0, 1}});
+
+static void BM_cubeEuclideanNNeighbor(benchmark::State& state){
+    hypercubeEuclidean newModel;
+    std::vector<Item> queries;
+
+    fitModel(newModel, state.range(0), state.range(1), 0, queries, state);
+    runQueries(newModel, queries, state);
+}
+BENCHMARK(BM_cubeEuclideanNNeighbor)->ArgsProduct({benchmark::CreateRange(BENCH_MIN_DIM, MODEL_MAX_DIM, 4), {0, 20}});
+
+// Petropoulakis Panagiotis
@@ -0,0 +1,289 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <fstream>
+#include <string.h>
+#include "../../neighborsProblem/utils/utils.h" // For errors etc.
+#include "../../neighborsProblem/fileHandler/fileHandler.h" // Read files
+#include "../../neighborsProblem/item/item.h" // Items in sets
+#include "../../neighborsProblem/evaluation/evaluation.h" // Benchmarks
+#include "../../neighborsProblem/trace/trace.h" // Regions of fit and queries
+
+using namespace std;
+
+/* Arguments of benchmark */
+typedef struct arguments{
+    string name; // Model
+    string inputFile;
+    string queryFile;
+    string cacheDir; // Ground truth cache - Optional
+    string outputFile; // Empty: stdout
+    string format; // csv or json
+    string traceFile; // Chrome trace(TRACE_REGIONS) - Optional
+    string loadFile; // Saved index to be mapped and measured instead of the grid - Optional
+    string saveFile; // Every configuration is saved here and checked against its mapped index - Optional
+    int warmup; // Batches before measurements
+    int repeats; // Timed batches
+    int topK; // Neighbors of recall@k(models with kNeighbors)
+    uint64_t seed; // Seed of every model
+    vector<int> k, l, w, m, probes, efConstruction, efSearch, rerank, sketch; // Grid
+    vector<float> coefficient;
+}arguments;
+
+/* Read arguments from the user */
+int readArguments(int argc, char **argv, arguments& args);
+
+/* Non interactive benchmark: fit every configuration of the grid and measure it */
+int main(int argc, char **argv){
+    char delim = ' '; // For data set
+    double radius;
+    int mismatches; // Queries of a mapped index that differ
+    list<Item> dataSetPoints, querySetPoints;
+    string metrice; // Metrice
+    errorCode status; // Errors
+    arguments args;
+
+    vector<modelConfig> grid; // Configurations to be measured
+    vector<vector<int> > groundTruth; // Exact topK nearest neighbors
+    vector<double> trueDistances;
+    vector<benchmarkResult> results;
+    benchmarkResult result;
+
+    ofstream resultsFile;
+
+    /* Read arguments */
+    if(readArguments(argc, argv, args) == -1){
+        cerr << "Usage: ./benchmark -m <lsh|cube|forest|hnsw|ivf|pq|exhaustive> -d <data set> -q <query set> [-k list] [-L list] [-w list] [-c list] [-M list] [-probes list] [-efc list] [-efs list] [-R list] [-S list] [-seed n] [-warmup n] [-repeats n] [-topk n] [-format csv|json] [-g ground truth cache] [-trace file] [-save index] [-load index] [-o output]\n";
+        return 1;
+    }
+
+    cerr << "benchmark: Reading data set\n";
+
+    /* Read data set */
+    readDataSet(args.inputFile, 1, delim, dataSetPoints, metrice, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    cerr << "benchmark: Reading query set\n";
+
+    /* Read query set */
+    readQuerySet(args.queryFile, 0, delim, querySetPoints, radius, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    /* Configurations of given model - A loaded index has its own */
+    if(args.loadFile.length() == 0)
+        createGrid(args.name, metrice, args.k, args.l, args.w, args.coefficient, args.m, args.probes, args.efConstruction, args.efSearch, args.rerank, args.sketch, grid, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    for(modelConfig& config : grid)
+        config.seed = args.seed;
+
+    cerr << "benchmark: Computing ground truth\n";
+
+    /* Exact nearest neighbors - Once for every configuration */
+    if(args.cacheDir.length() != 0)
+        loadGroundTruth(args.cacheDir, args.inputFile, args.queryFile, dataSetPoints, querySetPoints, metrice, args.topK, groundTruth, status);
+    else
+        computeGroundTruth(dataSetPoints, querySetPoints, metrice, args.topK, groundTruth, status);
+    if(status == SUCCESS)
+        groundTruthDistances(dataSetPoints, querySetPoints, metrice, groundTruth, trueDistances, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    /* Measure saved index */
+    if(args.loadFile.length() != 0){
+        cerr << "benchmark: Mapping " << args.loadFile << "\n";
+
+        benchmarkIndex(args.loadFile, metrice, dataSetPoints, querySetPoints, trueDistances, groundTruth, args.warmup, args.repeats, result, status);
+        if(status != SUCCESS){
+            printError(status);
+            return 1;
+        }
+
+        results.push_back(result);
+    }
+
+    /* Measure every configuration */
+    for(modelConfig& config : grid){
+        cerr << "benchmark: Configuration " << results.size() + 1 << "/" << grid.size() << "\n";
+
+        benchmarkModel(config, dataSetPoints, querySetPoints, trueDistances, groundTruth, args.warmup, args.repeats, result, status);
+        if(status != SUCCESS){
+            printError(status);
+            return 1;
+        }
+
+        /* Counters of queries(QUERY_STATS) */
+        if(result.stats.getQueries() > 0)
+            result.stats.print(cerr);
+
+        results.push_back(result);
+
+        /* Round trip: queries of the saved and mapped index match the fitted model */
+        if(args.saveFile.length() != 0){
+            checkMappedIndex(config, dataSetPoints, querySetPoints, args.saveFile, mismatches, status);
+            if(status != SUCCESS){
+                printError(status);
+                return 1;
+            }
+
+            if(mismatches != 0){
+                cerr << "benchmark: " << mismatches << " queries of the mapped index differ from the fitted model\n";
+                return 1;
+            }
+        }
+    } // End for - Configurations
+
+    /* Write results */
+    if(args.outputFile.length() == 0){
+        if(args.format == "json")
+            writeResultsJson(cout, results);
+        else
+            writeResultsCsv(cout, results);
+    }
+    else{
+        resultsFile.open(args.outputFile, ios::trunc);
+        if(!resultsFile){
+            cerr << "Can't open given output file\n";
+            return 1;
+        }
+
+        if(args.format == "json")
+            writeResultsJson(resultsFile, results);
+        else
+            writeResultsCsv(resultsFile, results);
+    }
+
+    /* Regions of every fit and query */
+    if(args.traceFile.length() != 0){
+    #ifdef TRACE_REGIONS
+        writeTrace(args.traceFile, status);
+        if(status != SUCCESS){
+            printError(status);
+            return 1;
+        }
+    #else
+        cerr << "benchmark: Build with TRACE=-DTRACE_REGIONS to record a trace\n";
+    #endif
+    }
+
+    return 0;
+}
+
+/* Read arguments from the user */
+/* Arguments provided: 1        */
+/* Invalid arguments: -1        */
+int readArguments(int argc, char **argv, arguments& args){
+    int i;
+    errorCode status = SUCCESS;
+
+    /* Defaults */
+    args.format = "csv";
+    args.warmup = 1;
+    args.repeats = 3;
+    args.seed = DEFAULT_SEED;
+    args.topK = 1;
+
+    /* Every flag has a value */
+    if(argc % 2 == 0)
+        return -1;
+
+    for(i = 1; i < argc; i += 2){
+        if(!strcmp(argv[i], "-m"))
+            args.name = argv[i + 1];
+        else if(!strcmp(argv[i], "-d"))
+            args.inputFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-q"))
+            args.queryFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-o"))
+            args.outputFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-g"))
+            args.cacheDir = argv[i + 1];
+        else if(!strcmp(argv[i], "-trace"))
+            args.traceFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-load"))
+            args.loadFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-save"))
+            args.saveFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-format"))
+            args.format = argv[i + 1];
+        else if(!strcmp(argv[i], "-k"))
+            parseIntList(argv[i + 1], args.k, status);
+        else if(!strcmp(argv[i], "-L"))
+            parseIntList(argv[i + 1], args.l, status);
+        else if(!strcmp(argv[i], "-w"))
+            parseIntList(argv[i + 1], args.w, status);
+        else if(!strcmp(argv[i], "-c"))
+            parseFloatList(argv[i + 1], args.coefficient, status);
+        else if(!strcmp(argv[i], "-M"))
+            parseIntList(argv[i + 1], args.m, status);
+        else if(!strcmp(argv[i], "-probes"))
+            parseIntList(argv[i + 1], args.probes, status);
+        else if(!strcmp(argv[i], "-efc"))
+            parseIntList(argv[i + 1], args.efConstruction, status);
+        else if(!strcmp(argv[i], "-efs"))
+            parseIntList(argv[i + 1], args.efSearch, status);
+        else if(!strcmp(argv[i], "-R"))
+            parseIntList(argv[i + 1], args.rerank, status);
+        else if(!strcmp(argv[i], "-S"))
+            parseIntList(argv[i + 1], args.sketch, status);
+        else if(!strcmp(argv[i], "-seed")){
+            try{
+                args.seed = stoull(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "-warmup") || !strcmp(argv[i], "-repeats")){
+            try{
+                (argv[i][1] == 'w' ? args.warmup : args.repeats) = stoi(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "-topk")){
+            try{
+                args.topK = stoi(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else
+            return -1;
+
+        if(status != SUCCESS)
+            return -1;
+    } // End for
+
+    /* Check arguments */
+    if((args.name.length() == 0 && args.loadFile.length() == 0) || args.inputFile.length() == 0 || args.queryFile.length() == 0)
+        return -1;
+
+    /* Only lsh and exhaustive search are saved */
+    if(args.saveFile.length() != 0 && args.name != "lsh" && args.name != "exhaustive")
+        return -1;
+
+    if(args.format != "csv" && args.format != "json")
+        return -1;
+
+    if(args.warmup < 0 || args.repeats <= 0 || args.topK < 1)
+        return -1;
+
+    return 1;
+}
+
+// Petropoulakis Panagiotis
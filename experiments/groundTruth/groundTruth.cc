@@ -0,0 +1,112 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <chrono>
+#include <string.h>
+#include "../../neighborsProblem/utils/utils.h" // For errors etc.
+#include "../../neighborsProblem/fileHandler/fileHandler.h" // Read files
+#include "../../neighborsProblem/item/item.h" // Items in sets
+#include "../../neighborsProblem/evaluation/evaluation.h" // Ground truth
+
+using namespace std;
+
+/* Read arguments from the user */
+int readArguments(int argc, char **argv, int& topK, string& inputFile, string& queryFile, string& cacheDir);
+
+/* Compute exact neighbors of a data set and a query set once and save them in a cache directory */
+/* Benchmarks load them(-g) instead of running exhaustive search                              */
+int main(int argc, char **argv){
+    char delim = ' '; // For data set
+    double radius;
+    int topK;
+    list<Item> dataSetPoints, querySetPoints;
+    string metrice; // Metrice
+    string inputFile, queryFile, cacheDir, fileName;
+    errorCode status; // Errors
+
+    /* Measure time */
+    chrono::steady_clock::time_point begin, end;
+
+    /* Read arguments */
+    if(readArguments(argc, argv, topK, inputFile, queryFile, cacheDir) == -1){
+        cerr << "Usage: ./groundTruth -d <data set> -q <query set> [-k top k] [-o cache directory]\n";
+        return 1;
+    }
+
+    cerr << "groundTruth: Reading data set\n";
+
+    /* Read data set */
+    readDataSet(inputFile, 1, delim, dataSetPoints, metrice, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    cerr << "groundTruth: Reading query set\n";
+
+    /* Read query set */
+    readQuerySet(queryFile, 0, delim, querySetPoints, radius, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    cerr << "groundTruth: Computing top " << topK << " neighbors\n";
+
+    begin = chrono::steady_clock::now();
+    saveGroundTruth(cacheDir, inputFile, queryFile, dataSetPoints, querySetPoints, metrice, topK, fileName, status);
+    end = chrono::steady_clock::now();
+
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    cerr << "groundTruth: Done in " << chrono::duration<double>(end - begin).count() << " sec\n";
+    cout << fileName << "\n";
+
+    return 0;
+}
+
+/* Read arguments from the user */
+/* Arguments provided: 1        */
+/* Invalid arguments: -1        */
+int readArguments(int argc, char **argv, int& topK, string& inputFile, string& queryFile, string& cacheDir){
+    int i;
+
+    /* Defaults */
+    topK = 10;
+    cacheDir = ".";
+
+    /* Every flag has a value */
+    if(argc % 2 == 0)
+        return -1;
+
+    for(i = 1; i < argc; i += 2){
+        if(!strcmp(argv[i], "-d"))
+            inputFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-q"))
+            queryFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-o"))
+            cacheDir = argv[i + 1];
+        else if(!strcmp(argv[i], "-k")){
+            try{
+                topK = stoi(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else
+            return -1;
+    } // End for
+
+    /* Check arguments */
+    if(inputFile.length() == 0 || queryFile.length() == 0 || topK <= 0)
+        return -1;
+
+    return 1;
+}
+
+// Petropoulakis Panagiotis
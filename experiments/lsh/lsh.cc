@@ -9,60 +9,49 @@
 #include "../../neighborsProblem/utils/utils.h" // For errors etc.
 #include "../../neighborsProblem/fileHandler/fileHandler.h" // Read files 
 #include "../../neighborsProblem/item/item.h" // Items in sets
+#include "../../neighborsProblem/trace/trace.h" // Regions of fit and queries
 #include "../../neighborsProblem/model/lsh/lsh.h" // Models
-#include "../../neighborsProblem/model/exhaustiveSearch/exhaustiveSearch.h" // Models
+#include "../../neighborsProblem/evaluation/evaluation.h" // Ground truth
 
 using namespace std;
 
 /* Read arguments from the user */
-int readArguments(int argc, char **argv, int& k, int& l, string& inputFile, string& queryFile, string& outputFile);
-int scanArguments(int& k, int& l, string& inputFile, string& queryFile, string& outputFile);
+int readArguments(int argc, char **argv, int& k, int& l, string& inputFile, string& queryFile, string& outputFile, string& cacheDir);
 
 int main(int argc, char **argv){
     char delim = ' '; // For data set
-    int argumentsProvided; // User provided arguments 
     double radius;
-    list<Item> dataSetPoints, querySetPoints; // Points in data set
+    list<Item> querySetPoints; // Points in query set
     string metrice; // Metrice
     errorCode status; // Errors
+    memoryReport report; // Memory of fitted model
 
     /* Arguments */
-    int k = -1, l;
+    int k = -1, l = -1;
     string inputFile, queryFile, outputFile;
+    string cacheDir; // Ground truth cache - Optional
     ofstream resultsFile; 
     
-    /* Read possible arugments from the user */
-    argumentsProvided = readArguments(argc, argv, k, l, inputFile, queryFile, outputFile);
-    if(argumentsProvided == -1){
-        cout << "Please give valid arguments. Try again later\n";
-        return 0;
-    }
-   
-    if(argumentsProvided == 1 && k < 0){
-        cout << "Please give valid arguments. Try again later\n";
+    /* Read arguments from the user */
+    if(readArguments(argc, argv, k, l, inputFile, queryFile, outputFile, cacheDir) == -1){
+        cout << "Usage: ./lsh -d <data set> -q <query set> -o <output> [-k sub hash functions -L tables] [-g ground truth cache]\n";
         return 0;
     }
 
     cout << "Welcome to lsh search\n";
     cout << "-----------------------\n\n";
     
-    /* Scan arguments from the stdin */
-    if(argumentsProvided == 0){
-        argumentsProvided = scanArguments(k, l, inputFile, queryFile, outputFile);
-        if(argumentsProvided == -1){
-            cout << "Please give valid arguments. Try again later\n";
-            return 0;
-        }
-    }
-
     /* Models to be tested */
     model* myModel; // Euclidean or cosine lsh 
-    model* optimalModel; // For exhaustive search
+    list<Item> dataSetPoints; // Points of data set - Ground truth
+    vector<vector<int> > groundTruth; // Exact nearest neighbor of every query
+    vector<double> trueDistances;
 
     double nearestDistanceSubOpt, nearestDistanceOpt;
+    int queryIndex;
     list<Item>::iterator iterQueries; // Iterate through queries 
     list<Item>::iterator iterNeighbors; // Iterate through neighbors 
-    Item nearestNeighborSubOpt, nearestNeighborOpt;
+    Item nearestNeighborSubOpt;
     list<Item> radiusNeighbors;
 
     double mApproximation = -1; // Maximum approximation fraction (dist nearest sub opt / dist nearest opt)
@@ -74,388 +63,244 @@ int main(int argc, char **argv){
     double avgTimeNearestOpt = 0; 
 
     int flag = 0;
-    int flag1 = 0;
 
-    string inputStr;
-    int fitAgain = 0, newQuery = 0;
+    cout << "lsh: Reading data set\n";
 
-    /* Read queries sets, find neighbors and print statistics */
-    while(1){
+    /* Read data set - Points are kept for the ground truth */
+    readDataSet(inputFile, 1, delim, dataSetPoints, metrice, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 0;
+    }
 
-        if(fitAgain == 0){
-            
-            cout << "lsh: Reading data set\n";
+    /* Create model */
+    if(metrice == "euclidean"){
+        if(k != -1)
+            myModel = new lshEuclidean(k,l, status);
+        else
+            myModel = new lshEuclidean();
+    }
+    else if(metrice == "cosine"){
+        if(k != -1)
+            myModel = new lshCosine(k,l, status);
+        else
+            myModel = new lshCosine();
+    }
 
-            /* Read data set */
-            readDataSet(inputFile, 1, delim, dataSetPoints, metrice, status);
-            if(status != SUCCESS){
-                printError(status);
-                return 0;
-            }
+    if(status != SUCCESS){
+        printError(status);
+        delete myModel;
+        return -1;
+    }
 
-            /* Create model */
-            if(metrice == "euclidean"){
-                if(k != -1)
-                    myModel = new lshEuclidean(k,l, status);
-                else
-                    myModel = new lshEuclidean();
-            }
-            else if(metrice == "cosine"){
-                if(k != -1)
-                    myModel = new lshCosine(k,l, status);
-                else
-                    myModel = new lshCosine();
-            }
+    if(myModel == NULL){
+        status = ALLOCATION_FAILED;
+        printError(status);
+        return -1;
+    }
 
-            if(status != SUCCESS){
-                printError(status);
-                delete myModel;
-                return -1;
-            }
+    cout << "lsh: Fitting sub-opt model\n";
 
-            if(myModel == NULL){
-                status = ALLOCATION_FAILED;
-                printError(status);
-                return -1;
-            }
+    /* Fit data set */
+    myModel->fit(dataSetPoints, status);
+    if(status != SUCCESS){
+        delete myModel;
+        printError(status);
+        return 0;
+    }
 
-            /* Create optimal model */
-            optimalModel = new exhaustiveSearch(metrice);
-            if(optimalModel == NULL){
-                status = ALLOCATION_FAILED;
-                printError(status);
-                delete myModel;
-                return -1;
-            }
+    cout << "lsh: Sub-opt model is fitted correctly. Memory consumption is: " << myModel->size() << " bytes\n";
 
-            cout << "lsh: Fitting sub-opt model\n";
-            
-            /* Fit data set */
-            myModel->fit(dataSetPoints,status);
-            if(status != SUCCESS){
-                delete myModel;
-                delete optimalModel;
-                printError(status);
-                return 0;
-            }
+    myModel->getMemoryReport(report, status);
+    if(status == SUCCESS)
+        printMemoryReport(report);
 
-            cout << "lsh: Sub-opt model is fitted correctly. Memory consumption is: " << myModel->size() << " bytes\n";
-            
-            cout << "lsh: Fitting opt model\n";
+    cout << "lsh: Reading query set\n";
 
-            /* Fit optimal model */
-            optimalModel->fit(dataSetPoints,status);
-            if(status != SUCCESS){
-                delete myModel;
-                delete optimalModel;
-                printError(status);
-                return 0;
-            }
+    /* Read query set */
+    readQuerySet(queryFile, 0, delim, querySetPoints, radius, status);
+    if(status != SUCCESS){
+        printError(status);   
+        delete myModel;
+        return 0;
+    }
 
-            cout << "lsh: Opt model is fitted correctly. Memory consumption is: " << optimalModel->size() << " bytes\n";
-        } 
+    cout << "lsh: Loading ground truth\n";
+
+    /* Exact nearest neighbors - Cached by data set and query set(-g) */
+    beginOpt = chrono::steady_clock::now();
+    if(cacheDir.length() != 0)
+        loadGroundTruth(cacheDir, inputFile, queryFile, dataSetPoints, querySetPoints, metrice, 1, groundTruth, status);
+    else
+        computeGroundTruth(dataSetPoints, querySetPoints, metrice, 1, groundTruth, status);
+    if(status == SUCCESS)
+        groundTruthDistances(dataSetPoints, querySetPoints, metrice, groundTruth, trueDistances, status);
+    endOpt = chrono::steady_clock::now();
+
+    if(status != SUCCESS){
+        printError(status);
+        delete myModel;
+        return 0;
+    }
 
-        if(newQuery == 0){
+    /* Exact search of a query - Time of ground truth per query */
+    avgTimeNearestOpt = chrono::duration_cast<chrono::microseconds>(endOpt - beginOpt).count() / 1000000.0 / querySetPoints.size();
 
-            cout << "lsh: Reading query set\n";
+    cout << "lsh: Opening output file\n";
 
-            /* Read query set */
-            readQuerySet(queryFile, 0, delim, querySetPoints, radius, status);
-            if(status != SUCCESS){
-                printError(status);   
-                delete myModel;
-                delete optimalModel;
-                return 0;
-            }
-        }
+    /* Truncate if file exists */
+    resultsFile.open(outputFile, ios::trunc);
+    if(!resultsFile){
+        cout << "Can't open given output file\n";
+        delete myModel;
+        return 0;
+    }
 
-        cout << "lsh: Opening output file\n";
 
-        /* Truncate if file exists */
-        resultsFile.open(outputFile, ios::trunc);
-        if(!resultsFile){
-            cout << "Can't open given output file\n";
-            delete myModel;
-            delete optimalModel;
-            return 0;
-        }
+    cout << "lsh: Searching for neighbors with given radius: " << radius << "\n";
 
-            
-        cout << "lsh: Searching for neighbors with given radius: " << radius << "\n";
-
-        /* Find neighbors */
-        for(iterQueries = querySetPoints.begin(); iterQueries != querySetPoints.end(); iterQueries++){
-
-            /* Find radius */
-            if(radius != 0){
-                myModel->radiusNeighbors(*iterQueries, radius, radiusNeighbors, NULL, status);
-                if(status != SUCCESS){
-                    printError(status);
-                    delete myModel;
-                    delete optimalModel;
-                    return 0;
-                }
-            }
+    /* Find neighbors */
+    for(iterQueries = querySetPoints.begin(), queryIndex = 0; iterQueries != querySetPoints.end(); iterQueries++, queryIndex++){
 
-            /* Find nearest */
-            beginSubOpt = chrono::steady_clock::now();
-            myModel->nNeighbor(*iterQueries, nearestNeighborSubOpt, &nearestDistanceSubOpt, status);
-            if(status != SUCCESS){
-                printError(status);
-                delete myModel;
-                delete optimalModel;
-                return 0;
-            }
-            endSubOpt = chrono::steady_clock::now();
-           
-            beginOpt = chrono::steady_clock::now();
-            optimalModel->nNeighbor(*iterQueries, nearestNeighborOpt, &nearestDistanceOpt, status);
+        /* Find radius */
+        if(radius != 0){
+            myModel->radiusNeighbors(*iterQueries, radius, radiusNeighbors, NULL, status);
             if(status != SUCCESS){
                 printError(status);
                 delete myModel;
-                delete optimalModel;
                 return 0;
             }
-            endOpt = chrono::steady_clock::now();
-            
-            /* Fix fraction */
-            if(nearestDistanceSubOpt != -1 && mApproximation < nearestDistanceSubOpt / nearestDistanceOpt)
-                mApproximation = nearestDistanceSubOpt / nearestDistanceOpt;
-
-            ///////////////////////////
-            /* Write results in file */
-            ///////////////////////////
-
-            /* Print id */
-            resultsFile << "Query: " << iterQueries->getId() << "\n";
-            
-            /* Radius exists */
-            if(radius != 0){
-                resultsFile << "R-near neighbors:\n";
-
-                /* R-neighbors */
-                for(iterNeighbors = radiusNeighbors.begin(); iterNeighbors != radiusNeighbors.end(); iterNeighbors++)
-                   resultsFile << iterNeighbors->getId() << "\n";     
-            }
-            /* Nearest */ 
-            resultsFile << "Nearest neighbor: " << nearestNeighborSubOpt.getId() << "\n";
-            resultsFile << "distanceLSH: " << nearestDistanceSubOpt << "\n";
-            resultsFile << "distanceTrue: " << nearestDistanceOpt << "\n"; 
-            resultsFile << "tLSH: " << chrono::duration_cast<chrono::microseconds>(endSubOpt - beginSubOpt).count() / 1000000.0 << " sec\n";
-            resultsFile << "tTrue: " << chrono::duration_cast<chrono::microseconds>(endOpt - beginOpt).count() / 1000000.0 << " sec\n"; 
-
-            if(flag == 0 && nearestDistanceSubOpt != -1)
-                avgTimeNearestSubOpt = chrono::duration_cast<chrono::microseconds>(endSubOpt - beginSubOpt).count() / 1000000.0;
-            else if(nearestDistanceSubOpt != -1){
-                avgTimeNearestSubOpt += chrono::duration_cast<chrono::microseconds>(endSubOpt - beginSubOpt).count() / 1000000.0;
-                avgTimeNearestSubOpt /= 2;
-                flag = 1;
-            }           
-           
-            if(flag1 == 0)
-                avgTimeNearestOpt = chrono::duration_cast<chrono::microseconds>(endOpt - beginOpt).count() / 1000000.0;
-            else if(nearestDistanceOpt != -1){
-                avgTimeNearestOpt += chrono::duration_cast<chrono::microseconds>(endOpt - beginOpt).count() / 1000000.0;
-                avgTimeNearestOpt /= 2;
-                flag1 = 1;
-            }
-
-            resultsFile << "\n";
-        } // End for - query points  
-
-        if(mApproximation == -1)
-            cout << "lsh: Can't find nearest neighbors for given data set\n";
-        else
-            cout << "lsh: Max approximation fraction: " << mApproximation << "\n";
-
-        cout << "lsh: Average time for nearest neighbors - sub opt: " << avgTimeNearestSubOpt << " sec\n";
-        cout << "lsh: Average time for nearest neighbors - opt: " << avgTimeNearestOpt << " sec\n";
-            
-        cout << "lsh: Closing output file: " << outputFile << "\n";
-        
-        cout << "\nDo you want to repeat the procedure with different sets(y/n)?:";
-        while(1){
-            cin >> inputStr;
-
-            /* Check answer */
-            if(inputStr == "y" || inputStr == "n")
-                break;
-            else
-                cout << "Please pres y or n:";
-        } // End while
-
-        if(inputStr == "n"){
-            cout << "lsh: Deleting models\n";
+        }
 
-            /* Delete models */
-            delete optimalModel;    
+        /* Find nearest */
+        beginSubOpt = chrono::steady_clock::now();
+        myModel->nNeighbor(*iterQueries, nearestNeighborSubOpt, &nearestDistanceSubOpt, status);
+        if(status != SUCCESS){
+            printError(status);
             delete myModel;
-            
-            cout << "lsh: Terminating\n";
-            break;
+            return 0;
         }
-        else{       
-
-            resultsFile.close();
-            
-            cout << "\nDo you want to fit different data set(y/n)?:";
-            while(1){
-                cin >> inputStr;
-
-                /* Check answer */
-                if(inputStr == "y" || inputStr == "n")
-                    break;
-                else
-                cout << "Please pres y or n:";
-            } // End while
-
-            if(inputStr == "n")
-                fitAgain = 1;
-            else{
-                fitAgain = 0;
-                cout << "lsh: Deleting models\n";
-
-                /* Delete models */
-                delete optimalModel;    
-                delete myModel;
-                
-                cout << "Give input file name:";
-                cin >> inputStr;
-                inputFile = inputStr;
-            }
+        endSubOpt = chrono::steady_clock::now();
 
-            cout << "\nDo you want to give different query set(y/n)?:";
-            while(1){
-                cin >> inputStr;
-
-                /* Check answer */
-                if(inputStr == "y" || inputStr == "n")
-                    break;
-                else
-                cout << "Please pres y or n:";
-            } // End while
-
-            if(inputStr == "n")
-                newQuery = 1;
-            else{
-                
-                newQuery = 0;
-                cout << "Give query file name:";
-                cin >> inputStr;
-
-                queryFile = inputStr;
-            }
+        /* Exact nearest distance */
+        nearestDistanceOpt = trueDistances[queryIndex];
 
-            cout << "Give output file name:";
-            cin >> inputStr;
+        /* Fix fraction */
+        if(nearestDistanceSubOpt != -1 && mApproximation < nearestDistanceSubOpt / nearestDistanceOpt)
+            mApproximation = nearestDistanceSubOpt / nearestDistanceOpt;
 
-            cout << "\n";
-        }
-    } // End while
+        ///////////////////////////
+        /* Write results in file */
+        ///////////////////////////
 
-    return 0;
-}
+        /* Print id */
+        resultsFile << "Query: " << iterQueries->getId() << "\n";
 
-/* Read arguments from the user */
-/* No arguments: 0              */
-/* Arguments provided: 1        */
-/* Invalid arguments: -1        */
-int readArguments(int argc, char **argv, int& k, int& l, string& inputFile, string& queryFile, string& outputFile){
+        /* Radius exists */
+        if(radius != 0){
+            resultsFile << "R-near neighbors:\n";
 
-    /* No argumets */
-    if(argc == 1)
-        return 0;
+            /* R-neighbors */
+            for(iterNeighbors = radiusNeighbors.begin(); iterNeighbors != radiusNeighbors.end(); iterNeighbors++)
+               resultsFile << iterNeighbors->getId() << "\n";     
+        }
+        /* Nearest */ 
+        resultsFile << "Nearest neighbor: " << nearestNeighborSubOpt.getId() << "\n";
+        resultsFile << "distanceLSH: " << nearestDistanceSubOpt << "\n";
+        resultsFile << "distanceTrue: " << nearestDistanceOpt << "\n"; 
+        resultsFile << "tLSH: " << chrono::duration_cast<chrono::microseconds>(endSubOpt - beginSubOpt).count() / 1000000.0 << " sec\n";
+        resultsFile << "tTrue: " << avgTimeNearestOpt << " sec\n"; 
 
-    /* Invalid arguments */
-    if(argc != 11)
-        return -1;
+        if(flag == 0 && nearestDistanceSubOpt != -1)
+            avgTimeNearestSubOpt = chrono::duration_cast<chrono::microseconds>(endSubOpt - beginSubOpt).count() / 1000000.0;
+        else if(nearestDistanceSubOpt != -1){
+            avgTimeNearestSubOpt += chrono::duration_cast<chrono::microseconds>(endSubOpt - beginSubOpt).count() / 1000000.0;
+            avgTimeNearestSubOpt /= 2;
+            flag = 1;
+        }           
 
-    if(strcmp(argv[1], "-d") || strcmp(argv[3], "-q") || strcmp(argv[5], "-k") || strcmp(argv[7], "-L") || strcmp(argv[9], "-o"))
-        return -1;
+        resultsFile << "\n";
+    } // End for - query points  
 
-    /* Copy arguments */
-    try{
-        k = stoi(argv[6]);
-    }
-    catch(...){
-        return -1;
-    }
+    if(mApproximation == -1)
+        cout << "lsh: Can't find nearest neighbors for given data set\n";
+    else
+        cout << "lsh: Max approximation fraction: " << mApproximation << "\n";
 
-    try{
-        l = stoi(argv[8]);
-    }
-    catch(...){
-        return -1;
-    }
-
-    inputFile = argv[2];
-    queryFile = argv[4];
-    outputFile = argv[10];
+    cout << "lsh: Average time for nearest neighbors - sub opt: " << avgTimeNearestSubOpt << " sec\n";
+    cout << "lsh: Average time for nearest neighbors - opt: " << avgTimeNearestOpt << " sec\n";
 
-    return 1;
-}
+    cout << "lsh: Closing output file: " << outputFile << "\n";
 
-/* Read arguments from stdin */
-/* Arguments provided: 1     */
-/* Invalid arguments: -1     */
-int scanArguments(int& k, int& l, string& inputFile, string& queryFile, string& outputFile){
-    string inputStr;
+#ifdef TRACE_REGIONS
+    /* Regions of fit and queries */
+    writeTrace(outputFile + ".trace.json", status);
+    if(status != SUCCESS)
+        printError(status);
+    else
+        cout << "lsh: Trace of regions: " << outputFile << ".trace.json\n";
+#endif
 
-    cout << "Give input file name:";
-    cin >> inputStr;
+    resultsFile.close();
 
-    inputFile = inputStr;
+    cout << "lsh: Deleting models\n";
 
-    cout << "Give query file name:";
-    cin >> inputStr;
+    /* Delete models */
+    delete myModel;
 
-    queryFile = inputStr;
+    cout << "lsh: Terminating\n";
 
-    cout << "Give output file name:";
-    cin >> inputStr;
+    return 0;
+}
 
-    outputFile = inputStr;
+/* Read arguments from the user - Hyperparameters(all or none) */
+/* and ground truth cache are optional                         */
+/* Arguments provided: 1                                       */
+/* Invalid arguments: -1                                       */
+int readArguments(int argc, char **argv, int& k, int& l, string& inputFile, string& queryFile, string& outputFile, string& cacheDir){
+    int i, value;
 
-    cout << "Do you want to provide hyperparameters for lsh(y/n)?:";
-    while(1){
-        cin >> inputStr;
+    /* Every flag has a value */
+    if(argc % 2 == 0)
+        return -1;
 
-        /* Check answer */
-        if(inputStr == "y" || inputStr == "n")
-            break;
-        else
-            cout << "Please pres y or n:";
-    } // End while
+    for(i = 1; i < argc; i += 2){
+        if(!strcmp(argv[i], "-d"))
+            inputFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-q"))
+            queryFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-o"))
+            outputFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-g"))
+            cacheDir = argv[i + 1];
+        else if(!strcmp(argv[i], "-k") || !strcmp(argv[i], "-L")){
+            try{
+                value = stoi(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
 
-    if(inputStr == "n"){
-        cout << "\n";
-        return 1;
-    }
+            if(value < 0)
+                return -1;
 
-    cout << "Give k hyperparameter:";
-    
-    cin >> inputStr;
+            if(argv[i][1] == 'k')
+                k = value;
+            else
+                l = value;
+        }
+        else
+            return -1;
+    } // End for
 
-    try{
-        k = stoi(inputStr);
-    }
-    catch(...){
+    /* Check arguments */
+    if(inputFile.length() == 0 || queryFile.length() == 0 || outputFile.length() == 0)
         return -1;
-    }
-
-    cout << "Give l hyperparameter:";
-    
-    cin >> inputStr;
 
-    try{
-        l = stoi(inputStr);
-    }
-    catch(...){
+    /* Default model without hyperparameters */
+    if((k == -1) != (l == -1))
         return -1;
-    }
 
-    cout << "\n";
-    
     return 1;
 }
 
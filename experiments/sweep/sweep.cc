@@ -0,0 +1,289 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <fstream>
+#include <string.h>
+#include "../../neighborsProblem/utils/utils.h" // For errors etc.
+#include "../../neighborsProblem/fileHandler/fileHandler.h" // Read files
+#include "../../neighborsProblem/item/item.h" // Items in sets
+#include "../../neighborsProblem/evaluation/evaluation.h" // Benchmarks
+
+using namespace std;
+
+/* Arguments of sweep */
+typedef struct arguments{
+    string name; // Model
+    string inputFile;
+    string queryFile;
+    string cacheDir; // Ground truth cache - Optional
+    string outputFile; // Every result(csv) - Optional
+    double targetRecall;
+    int warmup; // Batches before measurements
+    int repeats; // Timed batches
+    int topK; // Neighbors of recall@k(models with kNeighbors)
+    uint64_t seed; // Seed of every model
+    vector<int> k, l, w, m, probes, efConstruction, efSearch, rerank, sketch; // Grid
+    vector<float> coefficient;
+}arguments;
+
+/* Read arguments from the user */
+int readArguments(int argc, char **argv, arguments& args);
+
+/* Evaluate a grid of parameters, print the recall-qps pareto frontier and */
+/* the cheapest configuration with the target recall                      */
+int main(int argc, char **argv){
+    int i, best;
+    char delim = ' '; // For data set
+    double radius;
+    list<Item> dataSetPoints, querySetPoints;
+    string metrice; // Metrice
+    errorCode status; // Errors
+    arguments args;
+
+    vector<modelConfig> grid; // Configurations to be measured
+    vector<vector<int> > groundTruth; // Exact topK nearest neighbors
+    vector<double> trueDistances;
+    vector<benchmarkResult> results, frontierResults;
+    vector<int> frontier;
+    benchmarkResult result;
+
+    ofstream resultsFile;
+
+    /* Read arguments */
+    if(readArguments(argc, argv, args) == -1){
+        cerr << "Usage: ./sweep -m <lsh|cube|forest|hnsw|ivf|pq> -d <data set> -q <query set> [-recall target] [-k list] [-L list] [-w list] [-c list] [-M list] [-probes list] [-efc list] [-efs list] [-R list] [-S list] [-seed n] [-warmup n] [-repeats n] [-topk n] [-g ground truth cache] [-o output]\n";
+        return 1;
+    }
+
+    /* Default grid - Given values replace it */
+    if(args.k.size() == 0)
+        args.k = (args.name == "lsh") ? vector<int>{2, 4, 6, 8} : (args.name == "ivf") ? vector<int>{50, 100, 200} : (args.name == "pq") ? vector<int>{8, 16, 32} : vector<int>{3, 6, 9, 12};
+    if(args.l.size() == 0)
+        args.l = (args.name == "forest") ? vector<int>{1, 2, 4, 8} : vector<int>{1, 3, 5, 10};
+    if(args.m.size() == 0)
+        args.m = (args.name == "forest") ? vector<int>{64, 256, 1024, 4096} : (args.name == "hnsw") ? vector<int>{8, 16, 32} : vector<int>{100, 500, 1000};
+    if(args.probes.size() == 0)
+        args.probes = (args.name == "ivf") ? vector<int>{1, 2, 4, 8, 16} : vector<int>{1, 10, 50};
+    if(args.efConstruction.size() == 0)
+        args.efConstruction = {200};
+    if(args.efSearch.size() == 0)
+        args.efSearch = {16, 32, 64, 128, 256};
+    if(args.rerank.size() == 0)
+        args.rerank = (args.name == "pq") ? vector<int>{0, 10, 100} : vector<int>{0};
+
+    cerr << "sweep: Reading data set\n";
+
+    /* Read data set */
+    readDataSet(args.inputFile, 1, delim, dataSetPoints, metrice, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    cerr << "sweep: Reading query set\n";
+
+    /* Read query set */
+    readQuerySet(args.queryFile, 0, delim, querySetPoints, radius, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    /* Configurations of given model */
+    createGrid(args.name, metrice, args.k, args.l, args.w, args.coefficient, args.m, args.probes, args.efConstruction, args.efSearch, args.rerank, args.sketch, grid, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    for(modelConfig& config : grid)
+        config.seed = args.seed;
+
+    cerr << "sweep: Computing ground truth\n";
+
+    /* Exact nearest neighbors - Once for the whole grid */
+    if(args.cacheDir.length() != 0)
+        loadGroundTruth(args.cacheDir, args.inputFile, args.queryFile, dataSetPoints, querySetPoints, metrice, args.topK, groundTruth, status);
+    else
+        computeGroundTruth(dataSetPoints, querySetPoints, metrice, args.topK, groundTruth, status);
+    if(status == SUCCESS)
+        groundTruthDistances(dataSetPoints, querySetPoints, metrice, groundTruth, trueDistances, status);
+    if(status != SUCCESS){
+        printError(status);
+        return 1;
+    }
+
+    /* Measure every configuration - Skip invalid combinations */
+    for(i = 0; i < (int)grid.size(); i++){
+        cerr << "sweep: Configuration " << i + 1 << "/" << grid.size() << "\n";
+
+        benchmarkModel(grid[i], dataSetPoints, querySetPoints, trueDistances, groundTruth, args.warmup, args.repeats, result, status);
+        if(status == INVALID_PARAMETERS || status == INVALID_METHOD)
+            continue;
+
+        if(status != SUCCESS){
+            printError(status);
+            return 1;
+        }
+
+        results.push_back(result);
+    } // End for - Configurations
+
+    /* Every result */
+    if(args.outputFile.length() != 0){
+        resultsFile.open(args.outputFile, ios::trunc);
+        if(!resultsFile){
+            cerr << "Can't open given output file\n";
+            return 1;
+        }
+
+        writeResultsCsv(resultsFile, results);
+    }
+
+    /* Pareto frontier */
+    paretoFrontier(results, frontier);
+    for(i = 0; i < (int)frontier.size(); i++)
+        frontierResults.push_back(results[frontier[i]]);
+
+    cout << "Pareto frontier(recall - qps):\n";
+    writeResultsCsv(cout, frontierResults);
+
+    /* Suggestion */
+    best = cheapestConfig(results, args.targetRecall);
+    if(best == -1){
+        cout << "\nNo configuration reaches recall " << args.targetRecall << "\n";
+        return 0;
+    }
+
+    cout << "\nCheapest configuration with recall >= " << args.targetRecall << ":";
+    if(args.name == "forest")
+        cout << " trees=" << results[best].config.l << " checks=" << results[best].config.m;
+    else if(args.name == "pq")
+        cout << " subquantizers=" << results[best].config.k << " rerank=" << results[best].config.rerank;
+    else if(args.name == "ivf")
+        cout << " lists=" << results[best].config.k << " probes=" << results[best].config.probes;
+    else if(args.name == "hnsw")
+        cout << " M=" << results[best].config.m << " efConstruction=" << results[best].config.efConstruction << " efSearch=" << results[best].config.efSearch;
+    else
+        cout << " k=" << results[best].config.k;
+
+    if(args.name == "lsh"){
+        cout << " L=" << results[best].config.l;
+        if(metrice == "euclidean")
+            cout << " w=" << results[best].config.w << " c=" << results[best].config.coefficient;
+    }
+    else if(args.name == "cube"){
+        cout << " M=" << results[best].config.m << " probes=" << results[best].config.probes;
+        if(metrice == "euclidean")
+            cout << " w=" << results[best].config.w;
+    }
+
+    /* Two stage search of hashing models */
+    if((args.name == "lsh" || args.name == "cube") && results[best].config.rerank > 0)
+        cout << " rerank=" << results[best].config.rerank << " sketch=" << results[best].config.sketch;
+
+    cout << " (recall " << results[best].recall << ", qps " << results[best].qps << ", " << results[best].indexBytes << " bytes)\n";
+
+    return 0;
+}
+
+/* Read arguments from the user */
+/* Arguments provided: 1        */
+/* Invalid arguments: -1        */
+int readArguments(int argc, char **argv, arguments& args){
+    int i;
+    errorCode status = SUCCESS;
+
+    /* Defaults */
+    args.targetRecall = 0.9;
+    args.warmup = 0;
+    args.repeats = 1;
+    args.seed = DEFAULT_SEED;
+    args.topK = 1;
+
+    /* Every flag has a value */
+    if(argc % 2 == 0)
+        return -1;
+
+    for(i = 1; i < argc; i += 2){
+        if(!strcmp(argv[i], "-m"))
+            args.name = argv[i + 1];
+        else if(!strcmp(argv[i], "-d"))
+            args.inputFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-q"))
+            args.queryFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-o"))
+            args.outputFile = argv[i + 1];
+        else if(!strcmp(argv[i], "-g"))
+            args.cacheDir = argv[i + 1];
+        else if(!strcmp(argv[i], "-k"))
+            parseIntList(argv[i + 1], args.k, status);
+        else if(!strcmp(argv[i], "-L"))
+            parseIntList(argv[i + 1], args.l, status);
+        else if(!strcmp(argv[i], "-w"))
+            parseIntList(argv[i + 1], args.w, status);
+        else if(!strcmp(argv[i], "-c"))
+            parseFloatList(argv[i + 1], args.coefficient, status);
+        else if(!strcmp(argv[i], "-M"))
+            parseIntList(argv[i + 1], args.m, status);
+        else if(!strcmp(argv[i], "-probes"))
+            parseIntList(argv[i + 1], args.probes, status);
+        else if(!strcmp(argv[i], "-efc"))
+            parseIntList(argv[i + 1], args.efConstruction, status);
+        else if(!strcmp(argv[i], "-efs"))
+            parseIntList(argv[i + 1], args.efSearch, status);
+        else if(!strcmp(argv[i], "-R"))
+            parseIntList(argv[i + 1], args.rerank, status);
+        else if(!strcmp(argv[i], "-S"))
+            parseIntList(argv[i + 1], args.sketch, status);
+        else if(!strcmp(argv[i], "-recall")){
+            try{
+                args.targetRecall = stod(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "-seed")){
+            try{
+                args.seed = stoull(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "-warmup") || !strcmp(argv[i], "-repeats")){
+            try{
+                (argv[i][1] == 'w' ? args.warmup : args.repeats) = stoi(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "-topk")){
+            try{
+                args.topK = stoi(argv[i + 1]);
+            }
+            catch(...){
+                return -1;
+            }
+        }
+        else
+            return -1;
+
+        if(status != SUCCESS)
+            return -1;
+    } // End for
+
+    /* Check arguments */
+    if((args.name != "lsh" && args.name != "cube" && args.name != "forest" && args.name != "hnsw" && args.name != "ivf" && args.name != "pq") || args.inputFile.length() == 0 || args.queryFile.length() == 0)
+        return -1;
+
+    if(args.targetRecall < 0 || args.targetRecall > 1 || args.warmup < 0 || args.repeats <= 0 || args.topK < 1)
+        return -1;
+
+    return 1;
+}
+
+// Petropoulakis Panagiotis
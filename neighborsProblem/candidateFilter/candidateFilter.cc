@@ -0,0 +1,358 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "candidateFilter.h"
+#include "../item/item.h"
+#include "../utils/utils.h"
+#include "../indexStats/indexStats.h"
+#include "../metric/metric.h"
+
+using namespace std;
+
+/* Sketches are computed in ranges of points by threads - Small */
+/* sets are sketched by one thread                              */
+#define MIN_POINTS_PER_THREAD 1000
+
+//////////////////////////////////////////////
+/* Implementation of scalar quantizer class */
+//////////////////////////////////////////////
+
+scalarQuantizer::scalarQuantizer(int cosine):low(0),step(1),n(0),dim(0),cosine(cosine){}
+
+/* Components are mapped in [low, low + 255 * step] - Values out of range are clipped */
+void scalarQuantizer::encode(const vector<double>& components, uint8_t* code){
+    int i;
+    double value;
+
+    for(i = 0; i < this->dim; i++){
+        value = round((components[i] - this->low) / this->step);
+        if(value < 0)
+            value = 0;
+        else if(value > 255)
+            value = 255;
+
+        code[i] = (uint8_t)value;
+    } // End for
+}
+
+double scalarQuantizer::decodedNorm(const uint8_t* code, int32_t& sum){
+    int i;
+    double value, norm = 0;
+
+    sum = 0;
+    for(i = 0; i < this->dim; i++){
+        value = this->low + this->step * code[i];
+        norm += value * value;
+        sum += code[i];
+    } // End for
+
+    return sqrt(norm);
+}
+
+/* Range of components of all points and a code per point */
+void scalarQuantizer::fit(vector<Item*>& points, errorCode& status){
+    int i, j;
+    double high;
+
+    status = SUCCESS;
+
+    this->n = points.size();
+    if(this->n == 0){
+        status = INVALID_POINTS;
+        return;
+    }
+
+    this->dim = points[0]->getDim();
+
+    /* Find range of components */
+    this->low = points[0]->getComponents()[0];
+    high = this->low;
+
+    for(i = 0; i < this->n; i++){
+        const vector<double>& components = points[i]->getComponents();
+
+        for(j = 0; j < this->dim; j++){
+            if(components[j] < this->low)
+                this->low = components[j];
+            else if(components[j] > high)
+                high = components[j];
+        }
+    } // End for - Points
+
+    this->step = (high - this->low) / 255;
+    if(this->step <= 0)
+        this->step = 1;
+
+    this->codes.resize((size_t)this->n * this->dim);
+
+    if(this->cosine == 1){
+        this->sums.resize(this->n);
+        this->norms.resize(this->n);
+    }
+
+    /* Encode points */
+    for(i = 0; i < this->n; i++){
+        encode(points[i]->getComponents(), &this->codes[(size_t)i * this->dim]);
+
+        if(this->cosine == 1)
+            this->norms[i] = decodedNorm(&this->codes[(size_t)i * this->dim], this->sums[i]);
+    } // End for - Points
+}
+
+void scalarQuantizer::setQuery(Item& query, filterQuery& encoded, errorCode& status){
+    status = SUCCESS;
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    encoded.code.resize(this->dim);
+    encode(query.getComponents(), &encoded.code[0]);
+
+    if(this->cosine == 1)
+        encoded.norm = decodedNorm(&encoded.code[0], encoded.sum);
+}
+
+/* Euclidean: squared distance of codes                                              */
+/* Cosine: x * q = dim * low^2 + low * step * (sum(x) + sum(q)) + step^2 * dot(x, q) */
+/* of decoded points, where x and q are codes                                        */
+double scalarQuantizer::distance(filterQuery& encoded, int index){
+    int i;
+    int32_t sum = 0, diff;
+    const uint8_t* code = &this->codes[(size_t)index * this->dim];
+    const uint8_t* query = &encoded.code[0];
+    double product;
+
+    if(this->cosine == 0){
+        for(i = 0; i < this->dim; i++){
+            diff = (int32_t)code[i] - (int32_t)query[i];
+            sum += diff * diff;
+        }
+
+        return sum;
+    }
+
+    for(i = 0; i < this->dim; i++)
+        sum += (int32_t)code[i] * (int32_t)query[i];
+
+    if(this->norms[index] == 0 || encoded.norm == 0)
+        return 1;
+
+    product = this->dim * this->low * this->low + this->low * this->step * (this->sums[index] + encoded.sum) + this->step * this->step * sum;
+
+    return 1 - product / (this->norms[index] * encoded.norm);
+}
+
+void scalarQuantizer::getMemoryReport(memoryReport& report){
+    addAllocation(this->codes.capacity() * sizeof(uint8_t), report.points, report);
+    addAllocation(this->sums.capacity() * sizeof(int32_t), report.points, report);
+    addAllocation(this->norms.capacity() * sizeof(double), report.points, report);
+}
+
+/////////////////////////////////////////
+/* Implementation of sign sketch class */
+/////////////////////////////////////////
+
+signSketch::signSketch(uint64_t seed):seed(seed),n(0),dim(0){}
+
+void signSketch::sketch(const double* components, uint64_t* result){
+    int i;
+
+    for(i = 0; i < SKETCH_WORDS; i++)
+        result[i] = 0;
+
+    for(i = 0; i < SKETCH_BITS; i++)
+        if(dotProduct(&this->hyperplanes[(size_t)i * this->dim], components, this->dim) >= 0)
+            result[i / 64] |= (uint64_t)1 << (i % 64);
+}
+
+/* Hyperplanes are normal vectors like the ones of hCosine - Ranges of points are sketched in parallel */
+void signSketch::fit(vector<Item*>& points, errorCode& status){
+    int i, ranges;
+    size_t j;
+    vector<thread> pool;
+    randomGenerator generator(this->seed);
+
+    status = SUCCESS;
+
+    this->n = points.size();
+    if(this->n == 0){
+        status = INVALID_POINTS;
+        return;
+    }
+
+    this->dim = points[0]->getDim();
+
+    /* Random hyperplanes */
+    this->hyperplanes.resize((size_t)SKETCH_BITS * this->dim);
+    for(j = 0; j < this->hyperplanes.size(); j++)
+        this->hyperplanes[j] = generator.normal();
+
+    this->sketches.resize((size_t)this->n * SKETCH_WORDS);
+
+    ranges = thread::hardware_concurrency();
+    if(ranges > this->n / MIN_POINTS_PER_THREAD)
+        ranges = this->n / MIN_POINTS_PER_THREAD;
+    if(ranges <= 0)
+        ranges = 1;
+
+    auto work = [&](int first, int last){
+        int i;
+
+        for(i = first; i < last; i++)
+            sketch(points[i]->getComponents().data(), &this->sketches[(size_t)i * SKETCH_WORDS]);
+    };
+
+    for(i = 1; i < ranges; i++)
+        pool.push_back(thread(work, (int)((long)i * this->n / ranges), (int)((long)(i + 1) * this->n / ranges)));
+
+    work(0, (int)((long)this->n / ranges));
+
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+}
+
+void signSketch::setQuery(Item& query, filterQuery& encoded, errorCode& status){
+    status = SUCCESS;
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    sketch(query.getComponents().data(), encoded.sketch);
+}
+
+/* Number of different bits - Loop of SKETCH_WORDS is unrolled */
+double signSketch::distance(filterQuery& encoded, int index){
+    int i, bits = 0;
+    const uint64_t* currSketch = &this->sketches[(size_t)index * SKETCH_WORDS];
+
+    for(i = 0; i < SKETCH_WORDS; i++)
+        bits += __builtin_popcountll(currSketch[i] ^ encoded.sketch[i]);
+
+    return bits;
+}
+
+void signSketch::getMemoryReport(memoryReport& report){
+    addAllocation(this->sketches.capacity() * sizeof(uint64_t), report.points, report);
+    addAllocation(this->hyperplanes.capacity() * sizeof(double), report.hashFunctions, report);
+}
+
+//////////////////////////////////////////
+/* Implementation of rerank stage class */
+//////////////////////////////////////////
+
+rerankStage::rerankStage():filter(NULL),rerank(0),type(FILTER_QUANTIZED_EUCLIDEAN){}
+
+rerankStage::~rerankStage(){
+    if(this->filter != NULL)
+        delete this->filter;
+}
+
+void rerankStage::setRerank(int rerank, filterType type, errorCode& status){
+    status = SUCCESS;
+
+    if(rerank < MIN_RERANK || rerank > MAX_RERANK){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    /* Filter is built already */
+    if(this->filter != NULL){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    this->rerank = rerank;
+    this->type = type;
+}
+
+int rerankStage::getRerank(void){
+    return this->rerank;
+}
+
+filterType rerankStage::getType(void){
+    return this->type;
+}
+
+void rerankStage::fit(vector<Item*>& points, uint64_t seed, errorCode& status){
+    status = SUCCESS;
+
+    /* Stage is disabled */
+    if(this->rerank == 0)
+        return;
+
+    if(this->filter != NULL){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    if(this->type == FILTER_SIGN_SKETCH)
+        this->filter = new signSketch(seed);
+    else
+        this->filter = new scalarQuantizer(this->type == FILTER_QUANTIZED_COSINE);
+
+    if(this->filter == NULL){
+        status = ALLOCATION_FAILED;
+        return;
+    }
+
+    this->filter->fit(points, status);
+    if(status != SUCCESS){
+        delete this->filter;
+        this->filter = NULL;
+    }
+}
+
+int rerankStage::enabled(void){
+    return this->filter != NULL;
+}
+
+void rerankStage::begin(Item& query, rerankQuery& scratch, errorCode& status){
+    scratch.best.clear();
+    scratch.best.reserve(this->rerank);
+    scratch.visited.clear();
+
+    this->filter->setQuery(query, scratch.encoded, status);
+}
+
+/* Keep the rerank smallest distances - The largest is on top of the heap */
+int rerankStage::add(rerankQuery& scratch, int index){
+    double currDist;
+
+    /* Candidate of other table or vertice */
+    if(scratch.visited.insert(index).second == false)
+        return 0;
+
+    currDist = this->filter->distance(scratch.encoded, index);
+
+    if((int)scratch.best.size() < this->rerank){
+        scratch.best.push_back(make_pair(currDist, index));
+        push_heap(scratch.best.begin(), scratch.best.end());
+    }
+    else if(currDist < scratch.best.front().first){
+        pop_heap(scratch.best.begin(), scratch.best.end());
+        scratch.best.back() = make_pair(currDist, index);
+        push_heap(scratch.best.begin(), scratch.best.end());
+    }
+
+    return 1;
+}
+
+vector<pair<double, int> >& rerankStage::candidates(rerankQuery& scratch){
+    sort_heap(scratch.best.begin(), scratch.best.end());
+
+    return scratch.best;
+}
+
+void rerankStage::getMemoryReport(memoryReport& report){
+    if(this->filter == NULL)
+        return;
+
+    this->filter->getMemoryReport(report);
+}
+
+// Petropoulakis Panagiotis
@@ -0,0 +1,140 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <unordered_set>
+#include <cstdint>
+#include "../item/item.h"
+#include "../utils/utils.h"
+#include "../indexStats/indexStats.h"
+
+/* Two stage search of hashing models: candidates of buckets are ranked by a cheap */
+/* approximate distance and only the rerank best are checked with exact distances  */
+
+/* Bits of a sign sketch - A multiple of 64 up to 256 */
+#define SKETCH_BITS 256
+#define SKETCH_WORDS (SKETCH_BITS / 64)
+
+/* Filters of the rerank stage */
+typedef enum filterType{
+    FILTER_QUANTIZED_EUCLIDEAN, // Scalar quantization, euclidean distance of codes
+    FILTER_QUANTIZED_COSINE, // Scalar quantization, cosine distance of decoded points
+    FILTER_SIGN_SKETCH // Hamming distance of sign sketches(cosine)
+}filterType;
+
+/* Compressed query of a filter - Kept by the caller, so queries only read a fitted filter */
+typedef struct filterQuery{
+    std::vector<uint8_t> code; // Scalar quantization
+    int32_t sum; // Sum of code(cosine)
+    double norm; // Norm of decoded query(cosine)
+    uint64_t sketch[SKETCH_WORDS]; // Sign sketch
+}filterQuery;
+
+/* Approximate distances of fitted points from a query */
+class candidateFilter{
+    public:
+        virtual ~candidateFilter() {};
+
+        /* Compressed copies of given points - Point-i has index i */
+        virtual void fit(std::vector<Item*>& points, errorCode& status) = 0;
+
+        /* Compress a query - Called before distance */
+        virtual void setQuery(Item& query, filterQuery& encoded, errorCode& status) = 0;
+
+        /* Approximate distance of an encoded query and point-index - Only the order matters */
+        virtual double distance(filterQuery& encoded, int index) = 0;
+
+        /* Bytes of compressed points */
+        virtual void getMemoryReport(memoryReport& report) = 0;
+};
+
+/* Scalar quantization - A component is kept in one byte. All dimensions share the same  */
+/* step, so distances of codes are sums of integers(int accumulators hold 255^2 * MAX_DIM) */
+class scalarQuantizer: public candidateFilter{
+    private:
+        std::vector<uint8_t> codes; // dim per point
+        std::vector<int32_t> sums; // Sum of code of every point(cosine)
+        std::vector<double> norms; // Norm of decoded point(cosine)
+        double low; // Component of code 0
+        double step; // Difference of consecutive codes
+        int n;
+        int dim;
+        int cosine; // Rank by cosine distance of decoded points
+
+        /* Closest code of every component */
+        void encode(const std::vector<double>& components, uint8_t* code);
+
+        /* Norm of a decoded point and sum of its code */
+        double decodedNorm(const uint8_t* code, int32_t& sum);
+
+    public:
+        scalarQuantizer(int cosine);
+
+        void fit(std::vector<Item*>& points, errorCode& status);
+        void setQuery(Item& query, filterQuery& encoded, errorCode& status);
+        double distance(filterQuery& encoded, int index);
+        void getMemoryReport(memoryReport& report);
+};
+
+/* Sign sketches(SimHash) - Bit i of a point is the side of random hyperplane i, so the  */
+/* hamming distance of two sketches estimates the angle of the points. Candidates are   */
+/* ranked by xor and popcount of SKETCH_WORDS words, a point takes SKETCH_BITS / 8 bytes */
+class signSketch: public candidateFilter{
+    private:
+        std::vector<double> hyperplanes; // SKETCH_BITS normal vectors of dim components
+        std::vector<uint64_t> sketches; // SKETCH_WORDS per point
+        uint64_t seed; // Seed of hyperplanes
+        int n;
+        int dim;
+
+        /* Sides of every hyperplane */
+        void sketch(const double* components, uint64_t* result);
+
+    public:
+        signSketch(uint64_t seed);
+
+        void fit(std::vector<Item*>& points, errorCode& status);
+        void setQuery(Item& query, filterQuery& encoded, errorCode& status);
+        double distance(filterQuery& encoded, int index);
+        void getMemoryReport(memoryReport& report);
+};
+
+/* Candidates of a query in the rerank stage - One per call, so concurrent */
+/* queries of a fitted model have their own heaps and marks               */
+typedef struct rerankQuery{
+    filterQuery encoded; // Compressed query
+    std::vector<std::pair<double, int> > best; // Max heap of approximate distances and indexes
+    std::unordered_set<int> visited; // Candidates of other tables or vertices
+}rerankQuery;
+
+/* Candidates of a query - The rerank smallest approximate distances, without duplicates */
+class rerankStage{
+    private:
+        candidateFilter* filter; // Built at fit - NULL if stage is disabled
+        int rerank; // Candidates checked with exact distances - 0 disables the stage
+        filterType type;
+
+    public:
+        rerankStage();
+        ~rerankStage();
+
+        void setRerank(int rerank, filterType type, errorCode& status);
+        int getRerank(void);
+        filterType getType(void);
+
+        /* Build the filter of given points if stage is enabled - Seed of random filters */
+        void fit(std::vector<Item*>& points, uint64_t seed, errorCode& status);
+        int enabled(void);
+
+        /* Start the candidates of a query in given scratch */
+        void begin(Item& query, rerankQuery& scratch, errorCode& status);
+
+        /* Add point-index - 0 if it is a candidate of the query already */
+        int add(rerankQuery& scratch, int index);
+
+        /* Best candidates sorted by approximate distance */
+        std::vector<std::pair<double, int> >& candidates(rerankQuery& scratch);
+
+        void getMemoryReport(memoryReport& report);
+};
+
+// Petropoulakis Panagiotis
@@ -0,0 +1,965 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <stdint.h>
+#include "evaluation.h"
+#include "../fileHandler/fileHandler.h"
+#include "../item/item.h"
+#include "../utils/utils.h"
+#include "../metric/metric.h"
+#include "../model/model.h"
+#include "../model/lsh/lsh.h"
+#include "../model/hypercube/hypercube.h"
+#include "../model/exhaustiveSearch/exhaustiveSearch.h"
+#include "../model/kdForest/kdForest.h"
+#include "../model/hnsw/hnsw.h"
+#include "../model/ivf/ivf.h"
+#include "../model/productQuantization/productQuantization.h"
+#include "../model/mappedIndex/mappedIndex.h"
+
+using namespace std;
+
+/////////////////////
+/* Parameter grids */
+/////////////////////
+
+/* Split comma separated values */
+void parseIntList(string values, vector<int>& result, errorCode& status){
+    stringstream stream(values);
+    string value;
+
+    status = SUCCESS;
+
+    result.clear();
+
+    while(getline(stream, value, ',')){
+        try{
+            result.push_back(stoi(value));
+        }
+        catch(...){
+            status = INVALID_PARAMETERS;
+            return;
+        }
+    } // End while
+}
+
+void parseFloatList(string values, vector<float>& result, errorCode& status){
+    stringstream stream(values);
+    string value;
+
+    status = SUCCESS;
+
+    result.clear();
+
+    while(getline(stream, value, ',')){
+        try{
+            result.push_back(stof(value));
+        }
+        catch(...){
+            status = INVALID_PARAMETERS;
+            return;
+        }
+    } // End while
+}
+
+/* Every combination of given values - Only parameters of given model are combined */
+/* Empty values are replaced with the defaults of the model. Sketch is a parameter  */
+/* of the rerank stage only, so configurations with rerank 0 have no sketch         */
+void createGrid(string name, string metrice, vector<int>& k, vector<int>& l, vector<int>& w, vector<float>& coefficient, vector<int>& m, vector<int>& probes, vector<int>& efConstruction, vector<int>& efSearch, vector<int>& rerank, vector<int>& sketch, vector<modelConfig>& grid, errorCode& status){
+    int euclidean = (metrice == "euclidean");
+    modelConfig config;
+
+    /* Values of current grid - Unused parameters have a single value -1 */
+    vector<int> valuesK(1, -1), valuesL(1, -1), valuesW(1, -1), valuesM(1, -1), valuesProbes(1, -1), valuesEfConstruction(1, -1), valuesEfSearch(1, -1), valuesRerank(1, -1), valuesSketch(1, -1);
+    vector<float> valuesCoefficient(1, -1);
+    vector<int> noSketch(1, -1); // Sketches of configurations without rerank
+
+    status = SUCCESS;
+
+    grid.clear();
+
+    /* Check parameters */
+    if(metrice != "euclidean" && metrice != "cosine"){
+        status = INVALID_METRICE;
+        return;
+    }
+
+    if(name == "lsh"){
+        valuesK = k.size() ? k : vector<int>(1, euclidean ? 4 : 8);
+        valuesL = l.size() ? l : vector<int>(1, 5);
+
+        if(euclidean){
+            valuesW = w.size() ? w : vector<int>(1, 500);
+            valuesCoefficient = coefficient.size() ? coefficient : vector<float>(1, 0.25);
+        }
+
+        valuesRerank = rerank.size() ? rerank : vector<int>(1, 0);
+        valuesSketch = sketch.size() ? sketch : vector<int>(1, 0);
+    }
+    else if(name == "cube"){
+        valuesK = k.size() ? k : vector<int>(1, euclidean ? 9 : 5);
+        valuesM = m.size() ? m : vector<int>(1, MAX_M);
+        valuesProbes = probes.size() ? probes : vector<int>(1, euclidean ? 35 : 1);
+
+        if(euclidean)
+            valuesW = w.size() ? w : vector<int>(1, 800);
+
+        valuesRerank = rerank.size() ? rerank : vector<int>(1, 0);
+        valuesSketch = sketch.size() ? sketch : vector<int>(1, 0);
+    }
+    else if(name == "forest"){
+        valuesL = l.size() ? l : vector<int>(1, 4);
+        valuesM = m.size() ? m : vector<int>(1, 256);
+    }
+    else if(name == "hnsw"){
+        valuesM = m.size() ? m : vector<int>(1, 16);
+        valuesEfConstruction = efConstruction.size() ? efConstruction : vector<int>(1, 200);
+        valuesEfSearch = efSearch.size() ? efSearch : vector<int>(1, 64);
+    }
+    else if(name == "ivf"){
+        valuesK = k.size() ? k : vector<int>(1, 100);
+        valuesProbes = probes.size() ? probes : vector<int>(1, 8);
+    }
+    else if(name == "pq"){
+        valuesK = k.size() ? k : vector<int>(1, 16);
+        valuesRerank = rerank.size() ? rerank : vector<int>(1, 100);
+    }
+    else if(name != "exhaustive"){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    config.name = name;
+    config.metrice = metrice;
+    config.seed = DEFAULT_SEED;
+
+    /* Combine values */
+    for(int currK : valuesK)
+        for(int currL : valuesL)
+            for(int currW : valuesW)
+                for(float currCoefficient : valuesCoefficient)
+                    for(int currM : valuesM)
+                        for(int currProbes : valuesProbes)
+                            for(int currEfConstruction : valuesEfConstruction)
+                                for(int currEfSearch : valuesEfSearch)
+                                    for(int currRerank : valuesRerank)
+                                        for(int currSketch : (currRerank == 0) ? noSketch : valuesSketch){
+                                            config.k = currK;
+                                            config.l = currL;
+                                            config.w = currW;
+                                            config.coefficient = currCoefficient;
+                                            config.m = currM;
+                                            config.probes = currProbes;
+                                            config.efConstruction = currEfConstruction;
+                                            config.efSearch = currEfSearch;
+                                            config.rerank = currRerank;
+                                            config.sketch = currSketch;
+
+                                            grid.push_back(config);
+                                        } // End for - sketch
+}
+
+/* Create an unfitted model of given configuration */
+model* createModel(modelConfig& config, errorCode& status){
+    model* newModel = NULL;
+
+    status = SUCCESS;
+
+    if(config.name == "lsh" && config.metrice == "euclidean")
+        newModel = new lshEuclidean(config.l, config.k, config.w, config.coefficient, status);
+    else if(config.name == "lsh" && config.metrice == "cosine")
+        newModel = new lshCosine(config.k, config.l, status);
+    else if(config.name == "cube" && config.metrice == "euclidean")
+        newModel = new hypercubeEuclidean(config.k, config.m, config.probes, config.w, status);
+    else if(config.name == "cube" && config.metrice == "cosine")
+        newModel = new hypercubeCosine(config.k, config.m, config.probes, status);
+    else if(config.name == "exhaustive")
+        newModel = new exhaustiveSearch(config.metrice);
+    else if(config.name == "forest")
+        newModel = new kdForest(config.l, config.m, config.metrice, status);
+    else if(config.name == "hnsw")
+        newModel = new hnsw(config.m, config.efConstruction, config.efSearch, config.metrice, status);
+    else if(config.name == "ivf")
+        newModel = new ivf(config.k, config.probes, config.metrice, status);
+    else if(config.name == "pq")
+        newModel = new productQuantization(config.k, config.rerank, config.metrice, status);
+    else
+        status = INVALID_METHOD;
+
+    /* Random choices of fit */
+    if(status == SUCCESS)
+        newModel->setSeed(config.seed);
+
+    /* Two stage search of hashing models */
+    if(status == SUCCESS && (config.name == "lsh" || config.name == "cube") && config.rerank > 0)
+        newModel->setRerank(config.rerank, config.sketch, status);
+
+    /* Invalid parameters */
+    if(status != SUCCESS){
+        delete newModel;
+        return NULL;
+    }
+
+    return newModel;
+}
+
+//////////////////
+/* Ground truth */
+//////////////////
+
+/* Distance of given items with given metrice */
+static double distance(Item& x, Item& y, string& metrice, errorCode& status){
+    if(metrice == "euclidean")
+        return x.euclideanDist(y, status);
+    else
+        return x.cosineDist(y, status);
+}
+
+/* Queries are split in blocks that are scanned by a pool of threads */
+/* Points are scanned in blocks that stay in cache for every query    */
+#define QUERY_BLOCK 16
+#define POINT_BLOCK_BYTES (1 << 17)
+
+/* Insert point in sorted neighbors - Keep the topK closest */
+static inline void insertNeighbor(vector<pair<double, int> >& neighbors, int topK, double dist, int index){
+    int j;
+
+    /* Far point */
+    if((int)neighbors.size() == topK && dist >= neighbors.back().first)
+        return;
+
+    if((int)neighbors.size() < topK)
+        neighbors.push_back(make_pair(dist, index));
+    else
+        neighbors.back() = make_pair(dist, index);
+
+    for(j = neighbors.size() - 1; j > 0 && neighbors[j].first < neighbors[j - 1].first; j--)
+        swap(neighbors[j], neighbors[j - 1]);
+}
+
+/* Indexes(in data set) of the exact topK neighbors of every query                */
+/* Neighbors of a query are sorted by distance. Euclidean ranks squared distances */
+void computeGroundTruth(list<Item>& points, list<Item>& queries, string metrice, int topK, vector<vector<int> >& groundTruth, errorCode& status){
+    int i, n, dim, blocks, blockPoints, threads, cosine;
+    vector<const double*> pointsData, queriesData; // Components in place
+    vector<double> pointsNorm, queriesNorm; // Squared norms(euclidean) or norms(cosine)
+    vector<thread> pool;
+    atomic<int> nextBlock(0);
+
+    /* Iteratiors */
+    list<Item>::iterator iter;
+
+    status = SUCCESS;
+
+    groundTruth.clear();
+
+    /* Check parameters */
+    n = points.size();
+    if(topK <= 0 || topK > n || queries.size() == 0){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    if(metrice != "euclidean" && metrice != "cosine"){
+        status = INVALID_METRICE;
+        return;
+    }
+
+    cosine = (metrice == "cosine");
+    dim = points.front().getDim();
+
+    /* Access items by index */
+    for(iter = points.begin(); iter != points.end(); iter++){
+        if(iter->getDim() != dim){
+            status = INVALID_DIM;
+            return;
+        }
+
+        pointsData.push_back(iter->getComponents().data());
+        pointsNorm.push_back(dotProduct(pointsData.back(), pointsData.back(), dim));
+        if(cosine)
+            pointsNorm.back() = sqrt(pointsNorm.back());
+    } // End for
+
+    for(iter = queries.begin(); iter != queries.end(); iter++){
+        if(iter->getDim() != dim){
+            status = INVALID_DIM;
+            return;
+        }
+
+        queriesData.push_back(iter->getComponents().data());
+        queriesNorm.push_back(dotProduct(queriesData.back(), queriesData.back(), dim));
+        if(cosine)
+            queriesNorm.back() = sqrt(queriesNorm.back());
+    } // End for
+
+    groundTruth.resize(queriesData.size());
+
+    blocks = (queriesData.size() + QUERY_BLOCK - 1) / QUERY_BLOCK;
+    blockPoints = POINT_BLOCK_BYTES / (dim * sizeof(double));
+    if(blockPoints == 0)
+        blockPoints = 1;
+
+    /* Scan blocks of queries - Ranks of the dot product identity are rounded, so every point */
+    /* that may be nearer than the topK best upper bounds(rank + margin) is checked exactly  */
+    auto scan = [&](auto policy){
+        typedef decltype(policy) metricPolicy;
+        int block, first, last, q, p, t, tileSize, pFirst, pLast;
+        double rank, margin, bound;
+        const double* tileData[DOT_TILE];
+        double products[DOT_TILE];
+        vector<vector<pair<double, int> > > upper(QUERY_BLOCK); // TopK upper bounds of ranks
+        vector<vector<pair<double, int> > > candidates(QUERY_BLOCK); // Lower bounds of ranks in order of points
+        vector<int> pruned(QUERY_BLOCK); // Candidates after the last prune
+
+        while((block = nextBlock++) < blocks){
+            first = block * QUERY_BLOCK;
+            last = min(first + QUERY_BLOCK, (int)queriesData.size());
+
+            for(q = first; q < last; q++){
+                upper[q - first].clear();
+                candidates[q - first].clear();
+                pruned[q - first] = 0;
+            }
+
+            /* Every query of the block scans a block of points */
+            for(pFirst = 0; pFirst < n; pFirst += blockPoints){
+                pLast = min(pFirst + blockPoints, n);
+
+                /* Tiles of DOT_TILE queries - Last tile repeats its last query */
+                for(q = first; q < last; q += DOT_TILE){
+                    tileSize = min(DOT_TILE, last - q);
+                    for(t = 0; t < DOT_TILE; t++)
+                        tileData[t] = queriesData[q + min(t, tileSize - 1)];
+
+                    for(p = pFirst; p < pLast; p++){
+                        dotProducts(pointsData[p], tileData, dim, products);
+
+                        for(t = 0; t < tileSize; t++){
+                            vector<pair<double, int> >& currUpper = upper[q + t - first];
+                            vector<pair<double, int> >& curr = candidates[q + t - first];
+
+                            rank = metricPolicy::rank(products[t], pointsNorm[p], queriesNorm[q + t]);
+                            margin = metricPolicy::rankMargin(pointsNorm[p], queriesNorm[q + t]);
+                            bound = ((int)currUpper.size() == topK) ? currUpper.back().first : HUGE_VAL;
+
+                            if(rank - margin > bound)
+                                continue;
+
+                            curr.push_back(make_pair(rank - margin, p));
+                            insertNeighbor(currUpper, topK, rank + margin, p);
+
+                            /* Drop candidates of older bounds - Lists stay linear in the survivors */
+                            if((int)curr.size() >= 2 * pruned[q + t - first] + 64 && (int)currUpper.size() == topK){
+                                bound = currUpper.back().first;
+                                curr.erase(remove_if(curr.begin(), curr.end(), [&](const pair<double, int>& candidate){
+                                    return candidate.first > bound;
+                                }), curr.end());
+                                pruned[q + t - first] = curr.size();
+                            }
+                        } // End for - Queries of tile
+                    } // End for - Points
+                } // End for - Tiles
+            } // End for - Blocks of points
+
+            /* Exact ranks of candidates - Ties keep the order of points */
+            for(q = first; q < last; q++){
+                vector<pair<double, int> >& curr = candidates[q - first];
+                vector<pair<double, int> > exact;
+
+                bound = upper[q - first].back().first;
+                for(auto& candidate : curr){
+                    if(candidate.first > bound)
+                        continue;
+
+                    p = candidate.second;
+                    exact.push_back(make_pair(metricPolicy::rankBounded(pointsData[p], queriesData[q], dim, pointsNorm[p], queriesNorm[q], HUGE_VAL), p));
+                } // End for - Candidates
+
+                sort(exact.begin(), exact.end());
+
+                for(t = 0; t < topK; t++)
+                    groundTruth[q].push_back(exact[t].second);
+            } // End for
+        } // End while - Blocks of queries
+    };
+
+    auto worker = [&](){
+        if(cosine)
+            scan(cosineMetric());
+        else
+            scan(euclideanMetric());
+    };
+
+    threads = thread::hardware_concurrency();
+    if(threads <= 0)
+        threads = 1;
+    if(threads > blocks)
+        threads = blocks;
+
+    for(i = 0; i < threads - 1; i++)
+        pool.push_back(thread(worker));
+
+    worker();
+
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+}
+
+/* Cached file of given sets: <cacheDir>/gt_<data set hash>_<query set hash>.ivecs */
+static string groundTruthFileName(string cacheDir, string inputFile, string queryFile, errorCode& status){
+    uint64_t dataHash, queryHash;
+    char name[64];
+
+    dataHash = hashFile(inputFile, status);
+    if(status != SUCCESS)
+        return "";
+
+    queryHash = hashFile(queryFile, status);
+    if(status != SUCCESS)
+        return "";
+
+    snprintf(name, sizeof(name), "gt_%016llx_%016llx.ivecs", (unsigned long long)dataHash, (unsigned long long)queryHash);
+
+    return cacheDir + "/" + name;
+}
+
+/* Load exact neighbors of given sets from cache directory                     */
+/* Missing or smaller files are computed(computeGroundTruth) and saved again */
+void loadGroundTruth(string cacheDir, string inputFile, string queryFile, list<Item>& points, list<Item>& queries, string metrice, int topK, vector<vector<int> >& groundTruth, errorCode& status){
+    int i, j, valid;
+    string fileName;
+
+    status = SUCCESS;
+
+    fileName = groundTruthFileName(cacheDir, inputFile, queryFile, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Check cached file */
+    readIvecs(fileName, groundTruth, status);
+    valid = (status == SUCCESS && groundTruth.size() == queries.size());
+
+    for(i = 0; valid && i < (int)groundTruth.size(); i++){
+        if((int)groundTruth[i].size() < topK){
+            valid = 0;
+            break;
+        }
+
+        for(j = 0; j < (int)groundTruth[i].size(); j++){
+            if(groundTruth[i][j] < 0 || groundTruth[i][j] >= (int)points.size()){
+                valid = 0;
+                break;
+            }
+        }
+
+        /* Keep the topK neighbors */
+        groundTruth[i].resize(topK);
+    } // End for
+
+    if(valid){
+        status = SUCCESS;
+        return;
+    }
+
+    /* Compute and save */
+    computeGroundTruth(points, queries, metrice, topK, groundTruth, status);
+    if(status != SUCCESS)
+        return;
+
+    writeIvecs(fileName, groundTruth, status);
+}
+
+/* Compute exact neighbors of given sets and save them in cache directory */
+void saveGroundTruth(string cacheDir, string inputFile, string queryFile, list<Item>& points, list<Item>& queries, string metrice, int topK, string& fileName, errorCode& status){
+    vector<vector<int> > groundTruth;
+
+    status = SUCCESS;
+
+    fileName = groundTruthFileName(cacheDir, inputFile, queryFile, status);
+    if(status != SUCCESS)
+        return;
+
+    computeGroundTruth(points, queries, metrice, topK, groundTruth, status);
+    if(status != SUCCESS)
+        return;
+
+    writeIvecs(fileName, groundTruth, status);
+}
+
+/* Distance of every query and its exact nearest neighbor */
+void groundTruthDistances(list<Item>& points, list<Item>& queries, string metrice, vector<vector<int> >& groundTruth, vector<double>& distances, errorCode& status){
+    int i;
+    vector<Item*> pointsIndex; // Access points by index
+    list<Item>::iterator iter;
+
+    status = SUCCESS;
+
+    distances.clear();
+
+    /* Check parameters */
+    if(groundTruth.size() != queries.size()){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    pointsIndex.reserve(points.size());
+    for(iter = points.begin(); iter != points.end(); iter++)
+        pointsIndex.push_back(&(*iter));
+
+    distances.reserve(queries.size());
+
+    for(iter = queries.begin(), i = 0; iter != queries.end(); iter++, i++){
+        if(groundTruth[i].size() == 0 || groundTruth[i][0] < 0 || groundTruth[i][0] >= (int)pointsIndex.size()){
+            status = INVALID_PARAMETERS;
+            return;
+        }
+
+        distances.push_back(distance(*iter, *pointsIndex[groundTruth[i][0]], metrice, status));
+        if(status != SUCCESS)
+            return;
+    } // End for
+}
+
+////////////////
+/* Benchmarks */
+////////////////
+
+/* Latency at given percentile - Latencies are sorted */
+static double percentile(vector<double>& latencies, double p){
+    int index;
+
+    if(latencies.size() == 0)
+        return 0;
+
+    index = (int)ceil(p * latencies.size()) - 1;
+    if(index < 0)
+        index = 0;
+
+    return latencies[index];
+}
+
+/* Run warmup and repeated timed batches of queries of a fitted model */
+/* Recall is measured in the first batch                              */
+static void measureModel(model* myModel, list<Item>& points, list<Item>& queries, vector<double>& trueDistances, vector<vector<int> >& groundTruth, int warmup, int repeats, benchmarkResult& result, errorCode& status){
+    int i, r, found = 0;
+    size_t expected = 0; // Neighbors of recall@k
+    double currDist, kthDist, totalTime = 0;
+    Item currNeighbor;
+    list<Item> neighbors; // Of kNeighbors
+    vector<Item*> pointsIndex; // Access points by index(ground truth)
+    vector<double> latencies; // Of every query in microseconds
+    list<Item>::iterator iterQueries;
+    unordered_map<string, Item*> pointsById; // Items of returned neighbors
+    unordered_map<string, Item*>::iterator iterPoints;
+    indexStats occupancy; // Buckets of fitted model
+
+    /* Measure time */
+    chrono::steady_clock::time_point begin, end;
+    chrono::steady_clock::time_point beginBatch, endBatch;
+
+    status = SUCCESS;
+
+    result.queries = queries.size();
+    result.n = myModel->getNumberOfPoints(status);
+    result.dim = myModel->getDim(status);
+    result.topK = groundTruth[0].size();
+    result.recallK = -1;
+
+    /* Occupancy of buckets - Exhaustive search hasn't buckets */
+    result.maxBucket = -1;
+    result.expectedCandidates = -1;
+
+    myModel->getIndexStats(occupancy, status);
+    if(status == SUCCESS){
+        result.expectedCandidates = occupancy.expectedCandidates;
+
+        for(i = 0; i < (int)occupancy.tables.size(); i++)
+            if(occupancy.tables[i].maxSize > result.maxBucket)
+                result.maxBucket = occupancy.tables[i].maxSize;
+    }
+    status = SUCCESS;
+
+    /* Distances of models can be approximate(pq) - Recall uses the exact */
+    /* distance of the item with the id of the returned neighbor          */
+    pointsIndex.reserve(points.size());
+    for(Item& point : points){
+        pointsById[point.getId()] = &point;
+        pointsIndex.push_back(&point);
+    }
+
+    /* Warmup - Not measured */
+    for(r = 0; r < warmup; r++){
+        for(iterQueries = queries.begin(); iterQueries != queries.end(); iterQueries++){
+            myModel->nNeighbor(*iterQueries, currNeighbor, &currDist, status);
+            if(status != SUCCESS)
+                return;
+        } // End for - Queries
+    } // End for - Warmup
+
+    /* Count only timed queries */
+    myModel->clearQueryStats();
+
+    latencies.reserve((size_t)repeats * queries.size());
+
+    /* Timed batches */
+    for(r = 0; r < repeats; r++){
+        beginBatch = chrono::steady_clock::now();
+
+        for(iterQueries = queries.begin(), i = 0; iterQueries != queries.end(); iterQueries++, i++){
+            begin = chrono::steady_clock::now();
+            myModel->nNeighbor(*iterQueries, currNeighbor, &currDist, status);
+            end = chrono::steady_clock::now();
+
+            if(status != SUCCESS)
+                return;
+
+            latencies.push_back(chrono::duration<double, micro>(end - begin).count());
+
+            /* Exact neighbor or neighbor with same distance */
+            if(r == 0){
+                iterPoints = pointsById.find(currNeighbor.getId());
+                if(iterPoints != pointsById.end())
+                    currDist = distance(*iterQueries, *iterPoints->second, result.config.metrice, status);
+
+                if(status != SUCCESS)
+                    return;
+
+                if(currDist != -1 && currDist <= trueDistances[i] + 1e-9 * max(1.0, trueDistances[i]))
+                    found += 1;
+            }
+        } // End for - Queries
+
+        endBatch = chrono::steady_clock::now();
+        totalTime += chrono::duration<double>(endBatch - beginBatch).count();
+    } // End for - Batches
+
+    sort(latencies.begin(), latencies.end());
+
+    result.qps = latencies.size() / totalTime;
+    result.p50 = percentile(latencies, 0.50);
+    result.p95 = percentile(latencies, 0.95);
+    result.p99 = percentile(latencies, 0.99);
+    result.recall = (double)found / queries.size();
+
+    /* Counters are empty without QUERY_STATS */
+    queryStats lastStats;
+    myModel->getQueryStats(lastStats, result.stats, status);
+    status = SUCCESS;
+
+    /* Recall@k of models with kNeighbors - Not timed. A neighbor within the exact */
+    /* distance of the k-th neighbor is found(ties of same distance match)         */
+    if(result.topK < 2)
+        return;
+
+    found = 0;
+    for(iterQueries = queries.begin(), i = 0; iterQueries != queries.end(); iterQueries++, i++){
+        if(groundTruth[i].size() == 0 || groundTruth[i].back() < 0 || groundTruth[i].back() >= (int)pointsIndex.size()){
+            status = INVALID_PARAMETERS;
+            return;
+        }
+
+        myModel->kNeighbors(*iterQueries, groundTruth[i].size(), neighbors, NULL, status);
+        if(status == METHOD_NOT_IMPLEMENTED){
+            status = SUCCESS;
+            return;
+        }
+
+        if(status != SUCCESS)
+            return;
+
+        kthDist = distance(*iterQueries, *pointsIndex[groundTruth[i].back()], result.config.metrice, status);
+        if(status != SUCCESS)
+            return;
+
+        for(Item& neighbor : neighbors){
+            iterPoints = pointsById.find(neighbor.getId());
+            if(iterPoints == pointsById.end())
+                continue;
+
+            currDist = distance(*iterQueries, *iterPoints->second, result.config.metrice, status);
+            if(status != SUCCESS)
+                return;
+
+            if(currDist <= kthDist + 1e-9 * max(1.0, kthDist))
+                found += 1;
+        } // End for - Neighbors
+
+        expected += groundTruth[i].size();
+    } // End for - Queries
+
+    result.recallK = (double)found / expected;
+}
+
+/* Fit a model of given configuration, run warmup and repeated timed batches of queries - */
+/* Recall@k uses the exact neighbors of ground truth(indexes in data set)                */
+void benchmarkModel(modelConfig& config, list<Item>& points, list<Item>& queries, vector<double>& trueDistances, vector<vector<int> >& groundTruth, int warmup, int repeats, benchmarkResult& result, errorCode& status){
+    model* myModel;
+    size_t heapBefore, heapAfter; // Measure memory of model
+
+    /* Measure time */
+    chrono::steady_clock::time_point begin, end;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(warmup < 0 || repeats <= 0 || trueDistances.size() != queries.size() || groundTruth.size() != queries.size() || queries.size() == 0){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    result.config = config;
+
+    /* Heap of process without the model */
+    heapBefore = heapBytesInUse();
+
+    myModel = createModel(config, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Fit model */
+    begin = chrono::steady_clock::now();
+    myModel->fit(points, status);
+    end = chrono::steady_clock::now();
+
+    if(status != SUCCESS){
+        delete myModel;
+        return;
+    }
+
+    result.fitTime = chrono::duration<double>(end - begin).count();
+    result.indexBytes = myModel->size();
+
+    /* Heap kept by the model - Temporary allocations of fit are freed */
+    heapAfter = heapBytesInUse();
+    result.heapBytes = (heapAfter > heapBefore) ? heapAfter - heapBefore : 0;
+
+    measureModel(myModel, points, queries, trueDistances, groundTruth, warmup, repeats, result, status);
+
+    delete myModel;
+}
+
+/* Map a saved index(lsh or exhaustive) and measure it like a fitted model         */
+/* Fit time is the time of mapping - Heap bytes are the hash functions of the file */
+void benchmarkIndex(string indexFile, string metrice, list<Item>& points, list<Item>& queries, vector<double>& trueDistances, vector<vector<int> >& groundTruth, int warmup, int repeats, benchmarkResult& result, errorCode& status){
+    mappedIndex* myModel;
+    size_t heapBefore, heapAfter;
+
+    /* Measure time */
+    chrono::steady_clock::time_point begin, end;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(warmup < 0 || repeats <= 0 || trueDistances.size() != queries.size() || groundTruth.size() != queries.size() || queries.size() == 0){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    /* Parameters are saved in the index */
+    result.config.name = "mapped";
+    result.config.metrice = metrice;
+    result.config.k = result.config.l = result.config.w = result.config.m = result.config.probes = -1;
+    result.config.efConstruction = result.config.efSearch = result.config.rerank = result.config.sketch = -1;
+    result.config.coefficient = -1;
+    result.config.seed = 0;
+
+    heapBefore = heapBytesInUse();
+
+    begin = chrono::steady_clock::now();
+    myModel = new mappedIndex(indexFile, status);
+    end = chrono::steady_clock::now();
+
+    if(status != SUCCESS){
+        delete myModel;
+        return;
+    }
+
+    result.fitTime = chrono::duration<double>(end - begin).count();
+    result.indexBytes = myModel->size();
+
+    heapAfter = heapBytesInUse();
+    result.heapBytes = (heapAfter > heapBefore) ? heapAfter - heapBefore : 0;
+
+    /* Points of the index must be the given data set */
+    if(myModel->getNumberOfPoints(status) != (int)points.size()){
+        delete myModel;
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    measureModel(myModel, points, queries, trueDistances, groundTruth, warmup, repeats, result, status);
+
+    delete myModel;
+}
+
+/* Save a model of given configuration(lsh or exhaustive), map the saved index and compare */
+/* nearest neighbors of both. Saved indexes keep no filter, so the model is fitted without */
+/* rerank - Returns queries whose neighbors differ(ties of same distance match)            */
+void checkMappedIndex(modelConfig& config, list<Item>& points, list<Item>& queries, string indexFile, int& mismatches, errorCode& status){
+    model* myModel;
+    mappedIndex* myIndex;
+    modelConfig savedConfig = config;
+    Item fittedNeighbor, mappedNeighbor;
+    double fittedDist, mappedDist;
+
+    status = SUCCESS;
+    mismatches = 0;
+
+    if(config.name != "lsh" && config.name != "exhaustive"){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    savedConfig.rerank = -1;
+    savedConfig.sketch = -1;
+
+    myModel = createModel(savedConfig, status);
+    if(status != SUCCESS)
+        return;
+
+    myModel->fit(points, status);
+    if(status == SUCCESS)
+        myModel->save(indexFile, status);
+    if(status != SUCCESS){
+        delete myModel;
+        return;
+    }
+
+    myIndex = new mappedIndex(indexFile, status);
+    if(status != SUCCESS){
+        delete myIndex;
+        delete myModel;
+        return;
+    }
+
+    for(Item& query : queries){
+        myModel->nNeighbor(query, fittedNeighbor, &fittedDist, status);
+        if(status == SUCCESS)
+            myIndex->nNeighbor(query, mappedNeighbor, &mappedDist, status);
+        if(status != SUCCESS)
+            break;
+
+        if(fittedNeighbor.getId() != mappedNeighbor.getId() && fabs(fittedDist - mappedDist) > 1e-9 * max(1.0, fabs(fittedDist)))
+            mismatches += 1;
+    } // End for - Queries
+
+    delete myIndex;
+    delete myModel;
+}
+
+/* Results that are not dominated in recall and qps - Sorted by recall */
+void paretoFrontier(vector<benchmarkResult>& results, vector<int>& frontier){
+    int i;
+    double bestRecall = -1;
+    vector<int> order; // Results by qps(descending)
+
+    frontier.clear();
+
+    for(i = 0; i < (int)results.size(); i++)
+        order.push_back(i);
+
+    sort(order.begin(), order.end(), [&](int x, int y){
+        if(results[x].qps != results[y].qps)
+            return results[x].qps > results[y].qps;
+        return results[x].recall > results[y].recall;
+    });
+
+    /* A result is dominated by every faster result with at least its recall */
+    for(i = 0; i < (int)order.size(); i++){
+        if(results[order[i]].recall > bestRecall){
+            frontier.push_back(order[i]);
+            bestRecall = results[order[i]].recall;
+        }
+    } // End for
+}
+
+/* Fastest result with at least given recall(smaller index in ties) - Returns -1 if none */
+int cheapestConfig(vector<benchmarkResult>& results, double targetRecall){
+    int i, best = -1;
+
+    for(i = 0; i < (int)results.size(); i++){
+        if(results[i].recall < targetRecall)
+            continue;
+
+        if(best == -1 || results[i].qps > results[best].qps || (results[i].qps == results[best].qps && results[i].indexBytes < results[best].indexBytes))
+            best = i;
+    } // End for
+
+    return best;
+}
+
+/////////////
+/* Results */
+/////////////
+
+/* Unused parameters(-1) are empty */
+static string csvValue(double value){
+    stringstream stream;
+
+    if(value == -1)
+        return "";
+
+    stream << value;
+    return stream.str();
+}
+
+/* Unused parameters(-1) are null */
+static string jsonValue(double value){
+    stringstream stream;
+
+    if(value == -1)
+        return "null";
+
+    stream << value;
+    return stream.str();
+}
+
+void writeResultsCsv(ostream& out, vector<benchmarkResult>& results){
+    out << "model,metrice,k,l,w,coefficient,m,probes,ef_construction,ef_search,rerank,sketch,seed,n,dim,queries,fit_sec,qps,p50_us,p95_us,p99_us,recall_at_1,top_k,recall_at_k,index_bytes,heap_bytes,max_bucket,expected_candidates\n";
+
+    for(benchmarkResult& result : results){
+        out << result.config.name << "," << result.config.metrice << ",";
+        out << csvValue(result.config.k) << "," << csvValue(result.config.l) << "," << csvValue(result.config.w) << ",";
+        out << csvValue(result.config.coefficient) << "," << csvValue(result.config.m) << "," << csvValue(result.config.probes) << ",";
+        out << csvValue(result.config.efConstruction) << "," << csvValue(result.config.efSearch) << "," << csvValue(result.config.rerank) << "," << csvValue(result.config.sketch) << "," << result.config.seed << ",";
+        out << result.n << "," << result.dim << "," << result.queries << ",";
+        out << result.fitTime << "," << result.qps << "," << result.p50 << "," << result.p95 << "," << result.p99 << ",";
+        out << result.recall << "," << result.topK << "," << csvValue(result.recallK) << "," << result.indexBytes << "," << result.heapBytes << ",";
+        out << csvValue(result.maxBucket) << "," << csvValue(result.expectedCandidates) << "\n";
+    } // End for
+}
+
+void writeResultsJson(ostream& out, vector<benchmarkResult>& results){
+    int i;
+
+    out << "[\n";
+
+    for(i = 0; i < (int)results.size(); i++){
+        benchmarkResult& result = results[i];
+
+        out << "  {\"model\": \"" << result.config.name << "\", \"metrice\": \"" << result.config.metrice << "\", ";
+        out << "\"k\": " << jsonValue(result.config.k) << ", \"l\": " << jsonValue(result.config.l) << ", \"w\": " << jsonValue(result.config.w) << ", ";
+        out << "\"coefficient\": " << jsonValue(result.config.coefficient) << ", \"m\": " << jsonValue(result.config.m) << ", \"probes\": " << jsonValue(result.config.probes) << ", ";
+        out << "\"ef_construction\": " << jsonValue(result.config.efConstruction) << ", \"ef_search\": " << jsonValue(result.config.efSearch) << ", \"rerank\": " << jsonValue(result.config.rerank) << ", \"sketch\": " << jsonValue(result.config.sketch) << ", \"seed\": " << result.config.seed << ", ";
+        out << "\"n\": " << result.n << ", \"dim\": " << result.dim << ", \"queries\": " << result.queries << ", ";
+        out << "\"fit_sec\": " << result.fitTime << ", \"qps\": " << result.qps << ", ";
+        out << "\"p50_us\": " << result.p50 << ", \"p95_us\": " << result.p95 << ", \"p99_us\": " << result.p99 << ", ";
+        out << "\"recall_at_1\": " << result.recall << ", \"top_k\": " << result.topK << ", \"recall_at_k\": " << jsonValue(result.recallK) << ", \"index_bytes\": " << result.indexBytes << ", \"heap_bytes\": " << result.heapBytes << ", ";
+        out << "\"max_bucket\": " << jsonValue(result.maxBucket) << ", \"expected_candidates\": " << jsonValue(result.expectedCandidates) << "}";
+        out << (i + 1 < (int)results.size() ? ",\n" : "\n");
+    } // End for
+
+    out << "]\n";
+}
+
+// Petropoulakis Panagiotis
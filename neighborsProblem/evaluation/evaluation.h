@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <ostream>
+#include "../utils/utils.h"
+#include "../item/item.h"
+#include "../model/model.h"
+#include "../queryStats/queryStats.h"
+
+/* Functions for benchmarking models: fit time, throughput, latency and recall */
+
+/* Parameters of a model - Parameters of other models are ignored */
+typedef struct modelConfig{
+    std::string name; // lsh, cube, forest, hnsw, ivf, pq, exhaustive or mapped(saved index)
+    std::string metrice; // euclidean or cosine
+    int k; // Number of sub hash functions, lists(ivf) or sub quantizers(pq)
+    int l; // Total tables(lsh) or trees(forest)
+    int w; // Window size(euclidean)
+    float coefficient; // Table size == n * coefficient(lsh euclidean)
+    int m; // Max items to be searched(cube), checks(forest) or neighbors of nodes(hnsw)
+    int probes; // Max vertices probed(cube) or lists probed(ivf)
+    int efConstruction; // Beam of inserted points(hnsw)
+    int efSearch; // Beam of queries(hnsw)
+    int rerank; // Candidates checked with exact distances(lsh, cube, pq) - 0 checks every candidate(lsh, cube)
+    int sketch; // Candidates are ranked by sign sketches(lsh, cube cosine) or quantized distances(0, default)
+    uint64_t seed; // Seed of random choices of fit - Same seed and points give the same model
+}modelConfig;
+
+/* Measurements of a fitted model */
+typedef struct benchmarkResult{
+    modelConfig config;
+    int n; // Number of items
+    int dim; // Dimension
+    int queries; // Queries of a batch
+    double fitTime; // Seconds
+    double qps; // Queries per second
+    double p50; // Latency of a query in microseconds
+    double p95;
+    double p99;
+    double recall; // Queries with the exact nearest neighbor(recall@1)
+    int topK; // Neighbors of recall@k(neighbors of ground truth)
+    double recallK; // Exact topK neighbors found by kNeighbors(recall@k) - -1 without kNeighbors or if topK is 1
+    size_t indexBytes; // Size of model(memory report)
+    size_t heapBytes; // Heap allocated by fit(measured)
+    int maxBucket; // Largest bucket of all tables(-1 without buckets)
+    double expectedCandidates; // Candidates per query of index stats(-1 without buckets)
+    queryStatsHistograms stats; // Counters of timed queries(QUERY_STATS)
+}benchmarkResult;
+
+/* Split comma separated values */
+void parseIntList(std::string values, std::vector<int>& result, errorCode& status);
+void parseFloatList(std::string values, std::vector<float>& result, errorCode& status);
+
+/* Every combination of given values - Only parameters of given model are combined */
+void createGrid(std::string name, std::string metrice, std::vector<int>& k, std::vector<int>& l, std::vector<int>& w, std::vector<float>& coefficient, std::vector<int>& m, std::vector<int>& probes, std::vector<int>& efConstruction, std::vector<int>& efSearch, std::vector<int>& rerank, std::vector<int>& sketch, std::vector<modelConfig>& grid, errorCode& status);
+
+/* Create an unfitted model of given configuration */
+model* createModel(modelConfig& config, errorCode& status);
+
+/* Indexes(in data set) of the exact topK neighbors of every query - Parallel, blocked scan */
+void computeGroundTruth(std::list<Item>& points, std::list<Item>& queries, std::string metrice, int topK, std::vector<std::vector<int> >& groundTruth, errorCode& status);
+
+/* Ground truth cache: ivecs files keyed by hashes of data set and query set */
+/* Load topK neighbors of given sets - Computed and saved if missing        */
+void loadGroundTruth(std::string cacheDir, std::string inputFile, std::string queryFile, std::list<Item>& points, std::list<Item>& queries, std::string metrice, int topK, std::vector<std::vector<int> >& groundTruth, errorCode& status);
+
+/* Compute topK neighbors of given sets and save them - Returns name of saved file */
+void saveGroundTruth(std::string cacheDir, std::string inputFile, std::string queryFile, std::list<Item>& points, std::list<Item>& queries, std::string metrice, int topK, std::string& fileName, errorCode& status);
+
+/* Distance of every query and its exact nearest neighbor */
+void groundTruthDistances(std::list<Item>& points, std::list<Item>& queries, std::string metrice, std::vector<std::vector<int> >& groundTruth, std::vector<double>& distances, errorCode& status);
+
+/* Fit a model of given configuration, run warmup and repeated timed batches of queries - */
+/* Recall@k uses the exact neighbors of ground truth(indexes in data set)                */
+void benchmarkModel(modelConfig& config, std::list<Item>& points, std::list<Item>& queries, std::vector<double>& trueDistances, std::vector<std::vector<int> >& groundTruth, int warmup, int repeats, benchmarkResult& result, errorCode& status);
+
+/* Map a saved index(lsh or exhaustive) of given points and measure it like a fitted model */
+void benchmarkIndex(std::string indexFile, std::string metrice, std::list<Item>& points, std::list<Item>& queries, std::vector<double>& trueDistances, std::vector<std::vector<int> >& groundTruth, int warmup, int repeats, benchmarkResult& result, errorCode& status);
+
+/* Fit and save a model(lsh or exhaustive), map the saved index and count queries whose */
+/* nearest neighbors of the fitted model and the mapped index differ                     */
+void checkMappedIndex(modelConfig& config, std::list<Item>& points, std::list<Item>& queries, std::string indexFile, int& mismatches, errorCode& status);
+
+/* Results that are not dominated in recall and qps - Sorted by recall */
+void paretoFrontier(std::vector<benchmarkResult>& results, std::vector<int>& frontier);
+
+/* Fastest result with at least given recall(smaller index in ties) - Returns -1 if none */
+int cheapestConfig(std::vector<benchmarkResult>& results, double targetRecall);
+
+/* Write results - One row(object) per configuration */
+void writeResultsCsv(std::ostream& out, std::vector<benchmarkResult>& results);
+void writeResultsJson(std::ostream& out, std::vector<benchmarkResult>& results);
+
+// Petropoulakis Panagiotis
@@ -2,189 +2,449 @@
 #include <string>
 #include <unistd.h>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <list>
-#include <set>
+#include <unordered_set>
 #include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
 #include "../item/item.h"
 #include "../utils/utils.h"
 #include "fileHandler.h"
 
 using namespace std;
 
-/* Read given file, extract points and read possible metrices(euclidean, cosine, etc) */
-/* WithId == 0, points have id's                                                     */
-/* WithId == 1, points havn't id's                                                   */
-void readDataSet(string fileName, int withId, char delim, list<Item>& points, string& types, errorCode& status){
-    ifstream file; 
-    string line, word; // Line is splitted in words
-    int flag = 0; // Check only once for metrices
-    int i, j, wordsSize, specialChar;
+////////////////////
+/* Text data sets */
+////////////////////
+
+/* Files are read in blocks of this size */
+#define READ_BLOCK_SIZE (1 << 24)
+
+/* Files are split in chunks that are parsed in parallel */
+#define CHUNKS_PER_THREAD 4
+#define MIN_CHUNK_SIZE (1 << 20)
+
+/* Check for spaces that are not delimiters(tabs, \r etc) */
+static inline int isSpace(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/* Convert word that starts at first to double                          */
+/* Word ends at delimiter, space or last. Returns end of word or NULL    */
+/* Integers(most data sets) are converted directly - Exact up to 15 digits */
+static inline const char* parseDouble(const char* first, const char* last, char delim, double& value){
+    const char *curr = first, *digits, *wordLast;
+    long long integer = 0;
+    int negative = 0;
+
+    if(*curr == '-'){
+        negative = 1;
+        curr++;
+    }
+
+    digits = curr;
+    while(curr < last && *curr >= '0' && *curr <= '9' && curr - digits < 15){
+        integer = integer * 10 + (*curr - '0');
+        curr++;
+    }
+
+    if(curr != digits && (curr == last || *curr == delim || isSpace(*curr))){
+        value = negative ? -(double)integer : (double)integer;
+        return curr;
+    }
+
+    /* Find end of word and convert it */
+    wordLast = curr;
+    while(wordLast < last && *wordLast != delim && !isSpace(*wordLast))
+        wordLast++;
+
+    /* nan and inf are rejected - Distances of every model need finite components */
+    from_chars_result result = from_chars(first, wordLast, value);
+    if(result.ec != errc() || result.ptr != wordLast || !isfinite(value))
+        return NULL;
+
+    return wordLast;
+}
+
+/* Read length bytes of given file in blocks and call parseLine for every non empty line */
+/* Lines are given in place [first, last) without the new line                          */
+static void scanLines(ifstream& file, uint64_t length, function<void(const char*, const char*, errorCode&)> parseLine, errorCode& status){
+    vector<char> buffer(READ_BLOCK_SIZE);
+    uint64_t kept = 0; // Unfinished line of previous block
+    uint64_t readBytes, currBytes;
+    const char *first, *last, *end;
+    int finished = 0;
+
+    status = SUCCESS;
+
+    /* Small chunk */
+    if(length + 1 < buffer.size())
+        buffer.resize(length + 1);
+
+    while(finished == 0){
+
+        /* Line doesn't fit in buffer */
+        if(kept == buffer.size())
+            buffer.resize(buffer.size() * 2);
+
+        currBytes = buffer.size() - kept;
+        if(currBytes > length)
+            currBytes = length;
+
+        file.read(buffer.data() + kept, currBytes);
+        readBytes = file.gcount();
+        length -= readBytes;
+
+        /* End of file or chunk */
+        if(!file || length == 0)
+            finished = 1;
+
+        first = buffer.data();
+        end = buffer.data() + kept + readBytes;
+
+        /* Scan whole lines of block */
+        while(first < end){
+            last = (const char*)memchr(first, '\n', end - first);
+
+            /* Last line hasn't new line */
+            if(last == NULL){
+                if(finished == 0)
+                    break;
+
+                last = end;
+            }
+
+            /* Discard \r of windows files */
+            const char* lineEnd = last;
+            while(lineEnd > first && isSpace(*(lineEnd - 1)))
+                lineEnd--;
+
+            /* Discard empty lines */
+            if(lineEnd != first){
+                parseLine(first, lineEnd, status);
+                if(status != SUCCESS)
+                    return;
+            }
+
+            first = last + 1;
+        } // End while - Lines
+
+        /* Keep unfinished line */
+        kept = (first < end) ? end - first : 0;
+        if(kept != 0)
+            memmove(buffer.data(), first, kept);
+    } // End while - Blocks
+}
+
+/* Find first non empty line of given file                */
+/* Returns offset of line and offset after it(next line) */
+static uint64_t findFirstLine(ifstream& file, string& line, uint64_t& next){
+    uint64_t offset = 0;
+    char c;
+
+    line.clear();
+    next = 0;
+
+    file.clear();
+    file.seekg(0, ios::beg);
+
+    while(file.get(c)){
+        next += 1;
+
+        if(c == '\n'){
+            /* Non empty line */
+            if(line.find_first_not_of(" \t\r\v\f") != string::npos)
+                break;
+
+            line.clear();
+            offset = next;
+            continue;
+        }
+
+        line.push_back(c);
+    } // End while
+
+    file.clear();
+
+    return offset;
+}
+
+/* Find the start of the line after given offset */
+static uint64_t findNextLine(ifstream& file, uint64_t offset, uint64_t size){
+    char c;
+
+    file.clear();
+    file.seekg(offset, ios::beg);
+
+    while(offset < size && file.get(c)){
+        offset += 1;
+        if(c == '\n')
+            break;
+    }
+
+    file.clear();
+
+    return offset;
+}
+
+/* Split given line in words - Find id and components                       */
+/* Words are separated by delim or spaces. Components must be valid numbers */
+static void parseLine(const char* first, const char* last, int withId, char delim, unordered_set<string>& ids, string& id, vector<double>& components, errorCode& status){
+    const char* wordLast;
     double currComponent;
-    
-    /* Structures */
-    vector<string> metrices {"euclidean" , "cosine"}; // Available metrices
-    set<string> ids; // Keep all ids - Check if all ids are unique
-    set<string>::iterator iterSet; // Iterate through ids
-    string::iterator iterStr; // Iteratre through word
 
-    /* Note: words in file == points/id/metrices */
     status = SUCCESS;
 
-    /* Check parameters */
-    if(fileName.length() == 0 || (withId != 1 && withId != 0)){
-        status = INVALID_PARAMETERS;
+    components.clear();
+
+    /* Receive id's - First word in line */
+    if(withId == 1){
+        wordLast = (const char*)memchr(first, delim, last - first);
+        if(wordLast == NULL)
+            wordLast = last;
+
+        id.assign(first, wordLast);
+
+        /* Id exists - Invalid file */
+        if(!ids.insert(id).second){
+            status = INVALID_DATA_SET;
+            return;
+        }
+
+        first = wordLast;
+    } // End if - id
+
+    /* Read components */
+    while(first < last){
+
+        /* Discard delimiters and spaces */
+        if(*first == delim || isSpace(*first)){
+            first++;
+            continue;
+        }
+
+        first = parseDouble(first, last, delim, currComponent);
+        if(first == NULL){
+            status = INVALID_DATA_SET;
+            return;
+        }
+
+        /* Valid component - Save it */
+        components.push_back(currComponent);
+    } // End while
+}
+
+/* Split given line in words and create a new item */
+static void parseItem(const char* first, const char* last, int withId, char delim, unordered_set<string>& ids, vector<double>& components, list<Item>& points, errorCode& status){
+    string id;
+
+    parseLine(first, last, withId, delim, ids, id, components, status);
+    if(status != SUCCESS)
         return;
-    }
 
-    /* Clear points, types */
-    points.clear();
-    types.clear();
+    /* Create new item */
+    if(withId == 1)
+        points.emplace_back(id, components, status);
+    else
+        points.emplace_back(components, status);
+}
 
-    file.open(fileName);
-    
-    /* Check if file opened properly */
+/* Parse lines of file in [first, last) and append items in given list */
+static void parseChunk(string fileName, uint64_t first, uint64_t last, int withId, char delim, list<Item>& points, unordered_set<string>& ids, errorCode& status){
+    ifstream file;
+    vector<double> components; // Components of current line
+
+    status = SUCCESS;
+
+    file.open(fileName, ios::binary);
     if(!file){
         status = INVALID_DATA_SET;
         return;
     }
 
-    /* Read lines in file */
-    while(getline(file, line)){
-        /* Discard empty lines */
-        if(line.length() == 0)
-            continue;
+    file.seekg(first, ios::beg);
 
-        /* Check for metrices */
-        if(flag == 0){
-            for(i = 0; i < (int)metrices.size(); i++){
-                for(j = 0; j < (int)metrices[i].length(); j++){
-                    if(line[j] != metrices[i][j])
-                        break;
-                }
-
-                if(j == (int)metrices[i].length()){
-                    types = metrices[i];
-                    flag = 1;
-                    break;
-                }
-            } // End for
-            
-            if(flag == 1)
-                continue;
-
-            /* No metrices found - Reset words */
-            types = "euclidean"; // Default metrice
-            flag = 1;
-        }  // End if metrices
-
-        /* For current points in line */
-        vector<double> components;
-        string id; 
-
-        /* Split line */
-        std::istringstream wordStream(line);
-        vector<string> words; 
-
-        /* Get points */
-        while(getline(wordStream, word, delim))
-            words.push_back(word);
-       
-        /* Receive id's - First word in line */
-        if(withId == 1){
-            iterSet = ids.find(words[0]); 
+    scanLines(file, last - first, [&](const char* lineFirst, const char* lineLast, errorCode& status){
 
-            /* Id exists - Invalid file */
-            if(iterSet != ids.end()){
-                status = INVALID_DATA_SET;
-                return;
-            }
-            
-            /* Add id in set */
-            ids.insert(words[0]);
+        /* Number of points is too big */
+        if(points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
 
-            /* Keep currend id */
-            id = words[0];
-        } // End if - id       
-    
-        string currWord; // Change form of word
-        wordsSize = words.size();
-        
-        /* Read components */
-        for(i = withId; i < wordsSize; i++){
-            
-            /* Handle word */
-            currWord = words[i];
-            
-            specialChar = 0;
-
-            /* Discard special characters */
-            iterStr = currWord.begin();
-            while(iterStr != currWord.end()){
-                if(*iterStr < '0' || *iterStr > 'z'){
-                    specialChar = 1;
-                    break;
-                }
-                iterStr++;
-            }
+        parseItem(lineFirst, lineLast, withId, delim, ids, components, points, status);
+    }, status);
+}
+
+/* Split bytes [first, size) of given file in chunks that end at new lines */
+/* Chunks are parsed by a pool of threads and items are joined in order   */
+static void readItems(string fileName, ifstream& file, uint64_t first, uint64_t size, int withId, char delim, list<Item>& points, errorCode& status){
+    int i, threads, chunks, firstCount;
+    uint64_t chunkSize;
+    vector<uint64_t> bounds; // Start of each chunk
+    atomic<int> nextChunk(0);
+
+    status = SUCCESS;
+
+    /* Fix threads and chunks - Few chunks per thread for balance */
+    threads = thread::hardware_concurrency();
+    if(threads <= 0)
+        threads = 1;
+
+    chunks = threads * CHUNKS_PER_THREAD;
+    if((size - first) / chunks < MIN_CHUNK_SIZE)
+        chunks = (size - first) / MIN_CHUNK_SIZE;
+    if(chunks <= 0)
+        chunks = 1;
+    if(threads > chunks)
+        threads = chunks;
+
+    /* Chunks end at new lines */
+    chunkSize = (size - first) / chunks;
+    bounds.push_back(first);
+
+    for(i = 1; i < chunks; i++)
+        bounds.push_back(findNextLine(file, max(first + i * chunkSize, bounds.back()), size));
+
+    bounds.push_back(size);
+
+    /* Results of chunks */
+    vector<list<Item> > chunkPoints(chunks);
+    vector<unordered_set<string> > chunkIds(chunks);
+    vector<errorCode> chunkStatus(chunks, SUCCESS);
+
+    firstCount = Item::getCount();
+
+    /* Pick chunks until all are parsed */
+    auto worker = [&](){
+        int currChunk;
+
+        while((currChunk = nextChunk++) < chunks)
+            parseChunk(fileName, bounds[currChunk], bounds[currChunk + 1], withId, delim, chunkPoints[currChunk], chunkIds[currChunk], chunkStatus[currChunk]);
+    };
+
+    vector<thread> pool;
+    for(i = 1; i < threads; i++)
+        pool.push_back(thread(worker));
+
+    worker();
+
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
 
-            /* Special characters found */
-            if(specialChar == 1)
-                continue;
-            
-            /* Handle negative numbers */
-            if(currWord[0] == '-')
-                currWord.erase(0,1);
-          
-            /* Handle floating points */
-            currWord.erase(remove(currWord.begin(), currWord.end(), '.'), currWord.end());
-
-            /* Check if component is digit */
-            iterStr = currWord.begin();
-            while(iterStr != currWord.end() && isdigit(*iterStr))
-                iterStr++;
-           
-            /* Not digit */
-            if(currWord.size() == 0 || iterStr != currWord.end()){
+    /////////////////////////
+    /* Join items in order */
+    /////////////////////////
+
+    unordered_set<string> ids; // Keep all ids - Check if all ids are unique
+
+    for(i = 0; i < chunks; i++){
+        if(chunkStatus[i] != SUCCESS){
+            status = chunkStatus[i];
+            points.clear();
+            return;
+        }
+
+        /* Ids of chunk exist - Invalid file */
+        if(withId == 1){
+            ids.merge(chunkIds[i]);
+            if(chunkIds[i].size() != 0){
                 status = INVALID_DATA_SET;
+                points.clear();
                 return;
             }
+        }
 
-            /* Convert string to double */
-            try{
-                currComponent = stod(words[i]);
-            }
-            catch(...){
-                status = INVALID_POINTS;
-                return;
-            }
+        points.splice(points.end(), chunkPoints[i]);
 
-            /* Valid component - Save it */
-            components.push_back(currComponent);
-        } // End for
-        
         /* Number of points is too big */
-        if(points.size() == MAX_POINTS){
+        if(points.size() > MAX_POINTS){
             status = INVALID_POINTS;
+            points.clear();
             return;
         }
+    } // End for
 
-        /* Create new item */
-        if(withId == 1){      
-            points.push_back(Item(id,components,status));
-            if(status != SUCCESS){
-                return;
-            }
+    /* Chunks named items in any order - Name them by their position */
+    if(withId == 0 && chunks > 1){
+        list<Item>::iterator iterPoints; // Iterate through points
+
+        i = firstCount;
+        for(iterPoints = points.begin(); iterPoints != points.end(); iterPoints++){
+            iterPoints->setId("item_" + to_string(i));
+            i++;
         }
-        else{
-            points.push_back(Item(components,status));
-            if(status != SUCCESS){
-                return;
-            }
+    }
+}
+
+/* Find metrice in first line of data set(default euclidean) */
+/* Returns offset of first point                            */
+static uint64_t findDataSetStart(ifstream& file, string& types){
+    string line; // First line
+    uint64_t first, next;
+    int i;
+
+    /* Structures */
+    vector<string> metrices {"euclidean" , "cosine"}; // Available metrices
+
+    first = findFirstLine(file, line, next);
+    types = "euclidean"; // Default metrice
+
+    for(i = 0; i < (int)metrices.size(); i++){
+        if(line.compare(0, metrices[i].length(), metrices[i]) == 0){
+            types = metrices[i];
+            first = next;
+            break;
         }
-        
-    } // End while - Read line
+    } // End for
+
+    return first;
+}
+
+/* Read given file, extract points and read possible metrices(euclidean, cosine, etc) */
+/* WithId == 0, points havn't id's                                                   */
+/* WithId == 1, points have id's                                                     */
+void readDataSet(string fileName, int withId, char delim, list<Item>& points, string& types, errorCode& status){
+    ifstream file; 
+    uint64_t size, first;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(fileName.length() == 0 || (withId != 1 && withId != 0)){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    /* Clear points, types */
+    points.clear();
+    types.clear();
+
+    file.open(fileName, ios::binary);
+    
+    /* Check if file opened properly */
+    if(!file){
+        status = INVALID_DATA_SET;
+        return;
+    }
+
+    /* Find size of file */
+    file.seekg(0, ios::end);
+    size = file.tellg();
+
+    /* Check for metrices in first line */
+    first = findDataSetStart(file, types);
+
+    /* Read points */
+    readItems(fileName, file, first, size, withId, delim, points, status);
+    if(status != SUCCESS)
+        return;
 
     /* Small number of points */
     if(points.size() < MIN_POINTS){
@@ -196,21 +456,15 @@ void readDataSet(string fileName, int withId, char delim, list<Item>& points, st
 }
 
 /* Read given file, extract points and read possible radius */
-/* WithId == 0, points have id's                            */
-/* WithId == 1, points havn't id's                          */
+/* WithId == 0, points havn't id's                          */
+/* WithId == 1, points have id's                            */
 void readQuerySet(string fileName, int withId, char delim, list<Item>& points, double& radius, errorCode& status){
     ifstream file; 
-    string line, word; // Line is splitted in words
-    int flag = 0; // Check only once for metrices
-    int i, wordsSize, specialChar;
-    double currComponent;
-    
-    /* Structures */
-    set<string> ids; // Keep all ids - Check if all ids are unique
-    set<string>::iterator iterSet; // Iterate through ids
-    string::iterator iterStr; // Iteratre through word
+    string line; // First line
+    string header = "Radius:";
+    uint64_t size, first, next;
+    const char *wordFirst, *wordLast, *lineLast;
 
-    /* Note: words in file == points/id/metrices */
     status = SUCCESS;
 
     /* Check parameters */
@@ -222,7 +476,7 @@ void readQuerySet(string fileName, int withId, char delim, list<Item>& points, d
     /* Clear points */
     points.clear();
 
-    file.open(fileName);
+    file.open(fileName, ios::binary);
     
     /* Check if file opened properly */
     if(!file){
@@ -230,143 +484,476 @@ void readQuerySet(string fileName, int withId, char delim, list<Item>& points, d
         return;
     }
 
-    /* Read lines in file */
-    while(getline(file, line)){
-        /* Discard empty lines */
-        if(line.length() == 0)
-            continue;
+    /* Find size of file */
+    file.seekg(0, ios::end);
+    size = file.tellg();
 
-        /* Check for radius */
-        if(flag == 0){
-             
-            /* Split line */
-            std::istringstream wordStream(line);
-            vector<string> words; 
-            
-            /* Get points */
-            while(getline(wordStream, word, ' '))
-                words.push_back(word);
-            
-            if(words[0] == "Radius:"){
-                if(words.size() > 1){
-                    try{
-                        radius = stod(words[1]);
-                    }
-                    catch(...){
-                        status = INVALID_DATA_SET;
-                        return;
-                    }
-                    flag = 1;
-                    continue;
-                }
-            }
+    /* Check for radius in first line */
+    first = findFirstLine(file, line, next);
+    radius = 0; // Default radius - Find only nearest neighbor
 
-            /* No radius */
-            radius = 0; // Default radius - Find only nearest neighbor
-            flag = 1;
-        }  // End if metrices
+    lineLast = line.data() + line.length();
+    while(lineLast > line.data() && isSpace(*(lineLast - 1)))
+        lineLast--;
 
-        /* For current points in line */
-        vector<double> components;
-        string id; 
+    if(lineLast - line.data() > (int)header.length() && line.compare(0, header.length(), header) == 0 && isSpace(line[header.length()])){
 
-        /* Split line */
-        std::istringstream wordStream(line);
-        vector<string> words; 
+        /* Find value of radius */
+        wordFirst = line.data() + header.length();
+        while(wordFirst < lineLast && isSpace(*wordFirst))
+            wordFirst++;
 
-        /* Get points */
-        while(getline(wordStream, word, delim))
-            words.push_back(word);
-       
-        /* Receive id's - First word in line */
-        if(withId == 1){
-            iterSet = ids.find(words[0]); 
+        wordLast = wordFirst;
+        while(wordLast < lineLast && !isSpace(*wordLast))
+            wordLast++;
 
-            /* Id exists - Invalid file */
-            if(iterSet != ids.end()){
-                status = INVALID_DATA_SET;
-                return;
-            }
-            
-            /* Add id in set */
-            ids.insert(words[0]);
+        from_chars_result result = from_chars(wordFirst, wordLast, radius);
+        if(result.ec != errc() || result.ptr != wordLast){
+            status = INVALID_DATA_SET;
+            return;
+        }
+
+        first = next;
+    }
+
+    /* Read points */
+    readItems(fileName, file, first, size, withId, delim, points, status);
+    if(status != SUCCESS)
+        return;
+
+    file.close();
+}
+
+//////////////////
+/* Item streams */
+//////////////////
+
+listStream::listStream(list<Item>& points): points(points){}
+
+void listStream::forEach(function<void(Item&, errorCode&)> addItem, errorCode& status){
+    list<Item>::iterator iter;
+
+    status = SUCCESS;
+
+    for(iter = this->points.begin(); iter != this->points.end(); iter++){
+        addItem(*iter, status);
+        if(status != SUCCESS)
+            return;
+    }
+}
+
+/* Find metrice and start of points - Points are read by forEach */
+dataSetStream::dataSetStream(string fileName, int withId, char delim, errorCode& status){
+    ifstream file;
+
+    status = SUCCESS;
 
-            /* Keep currend id */
-            id = words[0];
-        } // End if - id       
+    this->fileName = fileName;
+    this->withId = withId;
+    this->delim = delim;
+    this->first = 0;
+    this->length = 0;
+
+    /* Check parameters */
+    if(fileName.length() == 0 || (withId != 1 && withId != 0)){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    file.open(fileName, ios::binary);
+
+    /* Check if file opened properly */
+    if(!file){
+        status = INVALID_DATA_SET;
+        return;
+    }
+
+    /* Find size of file */
+    file.seekg(0, ios::end);
+    this->length = file.tellg();
+
+    /* Check for metrices in first line */
+    this->first = findDataSetStart(file, this->types);
+    this->length -= this->first;
+}
+
+/* Parse file line by line - Every item is destroyed after addItem */
+void dataSetStream::forEach(function<void(Item&, errorCode&)> addItem, errorCode& status){
+    ifstream file;
+    unordered_set<string> ids; // Check for same ids
+    vector<double> components; // Components of current line
+    string id;
+    int count = 0;
+
+    status = SUCCESS;
+
+    file.open(this->fileName, ios::binary);
+    if(!file){
+        status = INVALID_DATA_SET;
+        return;
+    }
+
+    file.seekg(this->first, ios::beg);
+
+    scanLines(file, this->length, [&](const char* lineFirst, const char* lineLast, errorCode& status){
+
+        /* Number of points is too big */
+        if(count == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        parseLine(lineFirst, lineLast, this->withId, this->delim, ids, id, components, status);
+        if(status != SUCCESS)
+            return;
+
+        /* Create current item and pass it */
+        if(this->withId == 1){
+            Item point(id, components, status);
+            if(status == SUCCESS)
+                addItem(point, status);
+        }
+        else{
+            Item point(components, status);
+            if(status == SUCCESS)
+                addItem(point, status);
+        }
+
+        count += 1;
+    }, status);
+}
+
+string dataSetStream::getTypes(void){
+    return this->types;
+}
+
+///////////////////////
+/* Binary vecs files */
+///////////////////////
+
+/* Records are read and written in blocks of this size */
+#define VECS_BLOCK_SIZE (1 << 24)
+
+/* Read all records of a vecs file: dim(int32) + dim values of valueSize bytes */
+/* All records must have the same dimension. Blocks contain whole records     */
+/* addRecord is called with the values of every record                        */
+static void readVecs(string fileName, int valueSize, function<void(const char*, int, errorCode&)> addRecord, errorCode& status){
+    ifstream file;
+    int32_t dim, currDim;
+    uint64_t fileSize, recordSize, records, blockRecords, currRecords, i;
+    vector<char> block;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(fileName.length() == 0){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    file.open(fileName, ios::binary);
     
-        string currWord; // Change form of word
-        wordsSize = words.size();
-        
-        /* Read components */
-        for(i = withId; i < wordsSize; i++){
-            
-            /* Handle word */
-            currWord = words[i];
-            
-            specialChar = 0;
-
-            /* Discard special characters */
-            iterStr = currWord.begin();
-            while(iterStr != currWord.end()){
-                if(*iterStr < '0' || *iterStr > 'z'){
-                    specialChar = 1;
-                    break;
-                }
-                iterStr++;
-            }
+    /* Check if file opened properly */
+    if(!file){
+        status = INVALID_DATA_SET;
+        return;
+    }
+
+    /* Find size of file */
+    file.seekg(0, ios::end);
+    fileSize = file.tellg();
+    file.seekg(0, ios::beg);
 
-            /* Special characters found */
-            if(specialChar == 1)
-                continue;
-            
-            /* Handle negative numbers */
-            if(currWord[0] == '-')
-                currWord.erase(0,1);
-          
-            /* Handle floating points */
-            currWord.erase(remove(currWord.begin(), currWord.end(), '.'), currWord.end());
-
-            /* Check if component is digit */
-            iterStr = currWord.begin();
-            while(iterStr != currWord.end() && isdigit(*iterStr))
-                iterStr++;
-           
-            /* Not digit */
-            if(currWord.size() == 0 || iterStr != currWord.end()){
+    /* Empty file */
+    if(fileSize == 0)
+        return;
+
+    /* Dimension of first record */
+    file.read((char*)&dim, sizeof(int32_t));
+    if(!file || dim <= 0 || dim > MAX_DIM){
+        status = INVALID_DATA_SET;
+        return;
+    }
+
+    file.seekg(0, ios::beg);
+
+    recordSize = sizeof(int32_t) + (uint64_t)dim * valueSize;
+    if(fileSize % recordSize != 0){
+        status = INVALID_DATA_SET;
+        return;
+    }
+
+    records = fileSize / recordSize;
+    if(records > MAX_POINTS){
+        status = INVALID_POINTS;
+        return;
+    }
+
+    /* Fix block */
+    blockRecords = VECS_BLOCK_SIZE / recordSize;
+    if(blockRecords == 0)
+        blockRecords = 1;
+    if(blockRecords > records)
+        blockRecords = records;
+
+    block.resize(blockRecords * recordSize);
+
+    /* Read blocks */
+    while(records > 0){
+        currRecords = (records < blockRecords) ? records : blockRecords;
+
+        file.read(block.data(), currRecords * recordSize);
+        if(!file){
+            status = INVALID_DATA_SET;
+            return;
+        }
+
+        /* Scan records of block */
+        for(i = 0; i < currRecords; i++){
+            memcpy(&currDim, block.data() + i * recordSize, sizeof(int32_t));
+            if(currDim != dim){
                 status = INVALID_DATA_SET;
                 return;
             }
 
-            /* Convert string to double */
-            try{
-                currComponent = stod(words[i]);
-            }
-            catch(...){
-                status = INVALID_POINTS;
+            addRecord(block.data() + i * recordSize + sizeof(int32_t), dim, status);
+            if(status != SUCCESS)
                 return;
-            }
+        } // End for
 
-            /* Valid component - Save it */
-            components.push_back(currComponent);
+        records -= currRecords;
+    } // End while
+}
+
+/* Write given records in blocks: dim(int32) + dim values of valueSize bytes */
+/* getRecord copies the values of record-i in given buffer                  */
+static void writeVecs(string fileName, int valueSize, uint64_t records, int dim, function<void(uint64_t, char*, errorCode&)> getRecord, errorCode& status){
+    ofstream file;
+    int32_t currDim = dim;
+    uint64_t recordSize, blockRecords, currRecords, i, written = 0;
+    vector<char> block;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(fileName.length() == 0 || dim < 0 || dim > MAX_DIM){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    file.open(fileName, ios::binary | ios::trunc);
+    if(!file){
+        status = INVALID_DATA_SET;
+        return;
+    }
+
+    /* Fix block */
+    recordSize = sizeof(int32_t) + (uint64_t)dim * valueSize;
+    blockRecords = VECS_BLOCK_SIZE / recordSize;
+    if(blockRecords == 0)
+        blockRecords = 1;
+    if(blockRecords > records)
+        blockRecords = records;
+
+    block.resize(blockRecords * recordSize);
+
+    /* Write blocks */
+    while(written < records){
+        currRecords = (records - written < blockRecords) ? records - written : blockRecords;
+
+        for(i = 0; i < currRecords; i++){
+            memcpy(block.data() + i * recordSize, &currDim, sizeof(int32_t));
+
+            getRecord(written + i, block.data() + i * recordSize + sizeof(int32_t), status);
+            if(status != SUCCESS)
+                return;
         } // End for
-        
-        /* Create new item */
-        if(withId == 1){      
-            points.push_back(Item(id,components,status));
-            if(status != SUCCESS){
+
+        file.write(block.data(), currRecords * recordSize);
+        if(!file){
+            status = INVALID_DATA_SET;
+            return;
+        }
+
+        written += currRecords;
+    } // End while
+}
+
+/* Read float vectors - NaN and infinite values are invalid like in text sets */
+void readFvecs(string fileName, list<Item>& points, errorCode& status){
+    vector<double> components;
+    float currValue;
+    int i;
+
+    points.clear();
+
+    readVecs(fileName, sizeof(float), [&](const char* values, int dim, errorCode& status){
+        components.resize(dim);
+
+        for(i = 0; i < dim; i++){
+            memcpy(&currValue, values + i * sizeof(float), sizeof(float));
+            if(!isfinite(currValue)){
+                status = INVALID_DATA_SET;
                 return;
             }
+
+            components[i] = currValue;
         }
-        else{
-            points.push_back(Item(components,status));
-            if(status != SUCCESS){
+
+        points.push_back(Item("item_id" + to_string(points.size()), components, status));
+    }, status);
+
+    if(status != SUCCESS)
+        points.clear();
+}
+
+/* Read unsigned char vectors - Bytes are always finite */
+void readBvecs(string fileName, list<Item>& points, errorCode& status){
+    vector<double> components;
+    int i;
+
+    points.clear();
+
+    readVecs(fileName, sizeof(unsigned char), [&](const char* values, int dim, errorCode& status){
+        components.resize(dim);
+
+        for(i = 0; i < dim; i++)
+            components[i] = (unsigned char)values[i];
+
+        points.push_back(Item("item_id" + to_string(points.size()), components, status));
+    }, status);
+
+    if(status != SUCCESS)
+        points.clear();
+}
+
+/* Read int vectors - Positions of neighbors in ground truth files */
+void readIvecs(string fileName, vector<vector<int> >& vectors, errorCode& status){
+    vectors.clear();
+
+    readVecs(fileName, sizeof(int32_t), [&](const char* values, int dim, errorCode& status){
+        vectors.push_back(vector<int>(dim));
+        memcpy(vectors.back().data(), values, dim * sizeof(int32_t));
+    }, status);
+
+    if(status != SUCCESS)
+        vectors.clear();
+}
+
+/* Write float vectors - Components must be finite floats */
+void writeFvecs(string fileName, list<Item>& points, errorCode& status){
+    list<Item>::iterator iterPoints = points.begin(); // Iterate through points
+    int i, dim;
+    float currValue;
+
+    dim = (points.size() == 0) ? 0 : iterPoints->getDim();
+
+    writeVecs(fileName, sizeof(float), points.size(), dim, [&](uint64_t index, char* values, errorCode& status){
+        if(iterPoints->getDim() != dim){
+            status = INVALID_DIM;
+            return;
+        }
+
+        const vector<double>& components = iterPoints->getComponents();
+
+        for(i = 0; i < dim; i++){
+            /* Large doubles overflow to infinite floats */
+            currValue = components[i];
+            if(!isfinite(currValue)){
+                status = INVALID_DATA_SET;
                 return;
             }
+
+            memcpy(values + i * sizeof(float), &currValue, sizeof(float));
         }
-    } // End while - Read line
 
-    file.close();
+        iterPoints++;
+    }, status);
+}
+
+/* Write unsigned char vectors - Components must be integers in [0,255] */
+void writeBvecs(string fileName, list<Item>& points, errorCode& status){
+    list<Item>::iterator iterPoints = points.begin(); // Iterate through points
+    int i, dim;
+
+    dim = (points.size() == 0) ? 0 : iterPoints->getDim();
+
+    writeVecs(fileName, sizeof(unsigned char), points.size(), dim, [&](uint64_t index, char* values, errorCode& status){
+        if(iterPoints->getDim() != dim){
+            status = INVALID_DIM;
+            return;
+        }
+
+        const vector<double>& components = iterPoints->getComponents();
+
+        for(i = 0; i < dim; i++){
+            if(components[i] < 0 || components[i] > 255 || components[i] != (int)components[i]){
+                status = INVALID_DATA_SET;
+                return;
+            }
+
+            values[i] = (unsigned char)components[i];
+        }
+
+        iterPoints++;
+    }, status);
+}
+
+/* Write int vectors - All vectors must have the same size */
+void writeIvecs(string fileName, vector<vector<int> >& vectors, errorCode& status){
+    int dim;
+
+    dim = (vectors.size() == 0) ? 0 : vectors[0].size();
+
+    writeVecs(fileName, sizeof(int32_t), vectors.size(), dim, [&](uint64_t index, char* values, errorCode& status){
+        if((int)vectors[index].size() != dim){
+            status = INVALID_DIM;
+            return;
+        }
+
+        memcpy(values, vectors[index].data(), dim * sizeof(int32_t));
+    }, status);
+}
+
+/////////////////
+/* File hashes */
+/////////////////
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+/* Hash of file contents(FNV-1a) - Identifies data sets */
+uint64_t hashFile(string fileName, errorCode& status){
+    ifstream file;
+    uint64_t hash = FNV_OFFSET;
+    vector<char> block(READ_BLOCK_SIZE);
+    streamsize i, length;
+
+    status = SUCCESS;
+
+    file.open(fileName, ios::binary);
+    if(!file){
+        status = INVALID_DATA_SET;
+        return 0;
+    }
+
+    /* Read blocks */
+    while(file){
+        file.read(block.data(), block.size());
+        length = file.gcount();
+
+        for(i = 0; i < length; i++){
+            hash ^= (unsigned char)block[i];
+            hash *= FNV_PRIME;
+        }
+    } // End while
+
+    if(file.bad()){
+        status = INVALID_DATA_SET;
+        return 0;
+    }
+
+    return hash;
 }
 
 // Petropoulakis Panagiotis
@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
 #include <list>
+#include <stdint.h>
+#include <string>
+#include <functional>
 #include "../utils/utils.h"
 #include "../item/item.h"
 
@@ -11,4 +14,58 @@ void readDataSet(std::string fileName, int withId, char delim, std::list<Item>&
 
 /* Read given file, extract items and read possible radius */
 void readQuerySet(std::string fileName, int withId, char delim, std::list<Item>& points, double& radius, errorCode& status); 
+
+/* Stream of items - Models are fitted while items are parsed */
+/* No list with every item is created                         */
+class itemStream{
+    public:
+        virtual ~itemStream() {};
+
+        /* Call given function for every item in order - Stop at first error */
+        virtual void forEach(std::function<void(Item& point, errorCode& status)> addItem, errorCode& status) = 0;
+};
+
+/* Items of a list */
+class listStream: public itemStream{
+    private:
+        std::list<Item>& points;
+
+    public:
+        listStream(std::list<Item>& points);
+
+        void forEach(std::function<void(Item& point, errorCode& status)> addItem, errorCode& status);
+};
+
+/* Items of a data set file(same format as readDataSet) */
+/* Every call of forEach reads the file again           */
+class dataSetStream: public itemStream{
+    private:
+        std::string fileName;
+        std::string types; // Metrice of first line
+        uint64_t first; // Offset of first point
+        uint64_t length; // Bytes of points
+        int withId;
+        char delim;
+
+    public:
+        dataSetStream(std::string fileName, int withId, char delim, errorCode& status);
+
+        void forEach(std::function<void(Item& point, errorCode& status)> addItem, errorCode& status);
+
+        std::string getTypes(void);
+};
+
+/* Binary vecs files(SIFT, GIST etc): every vector is dim(int32) followed by dim values */
+/* fvecs: float values, bvecs: unsigned char values, ivecs: int values(ground truth)   */
+/* Items get ids item_id<position in file> - NaN or infinite floats are invalid         */
+void readFvecs(std::string fileName, std::list<Item>& points, errorCode& status);
+void readBvecs(std::string fileName, std::list<Item>& points, errorCode& status);
+void readIvecs(std::string fileName, std::vector<std::vector<int> >& vectors, errorCode& status);
+
+void writeFvecs(std::string fileName, std::list<Item>& points, errorCode& status);
+void writeBvecs(std::string fileName, std::list<Item>& points, errorCode& status);
+void writeIvecs(std::string fileName, std::vector<std::vector<int> >& vectors, errorCode& status);
+
+/* Hash of file contents(FNV-1a) - Identifies data sets */
+uint64_t hashFile(std::string fileName, errorCode& status);
 // Petropoulakis Panagiotis
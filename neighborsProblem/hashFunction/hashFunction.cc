@@ -1,8 +1,11 @@
 #include <iostream>
 #include <vector>
+#include <fstream>
+#include <stdint.h>
 #include <unordered_map>
 #include <cmath>
 #include <new>
+#include <atomic>
 #include "hashFunction.h"
 #include "../item/item.h"
 #include "../utils/utils.h"
@@ -20,9 +23,9 @@ h::~h(){}
 /* Implementation of sub euclidean hash function class */
 /////////////////////////////////////////////////////////
 
-int hEuclidean::count = 0;
+atomic<int> hEuclidean::count(0);
 
-hEuclidean::hEuclidean(int dim, int w):w(w){
+hEuclidean::hEuclidean(int dim, int w, uint64_t seed):w(w){
     /* Check parameters */
     if(dim <= 0 || dim > MAX_DIM || w < MIN_W || w > MAX_W){
         this->v = NULL;
@@ -32,17 +35,17 @@ hEuclidean::hEuclidean(int dim, int w):w(w){
         int i = 0;
         vector<double> components(dim);
         errorCode status;
+        randomGenerator generator(seed);
 
         /* Fix id */
-        this->id = "hEuclidean_" + to_string(this->count);
-        this->count += 1;
+        this->id = "hEuclidean_" + to_string(this->count++);
 
         /* Pick a random t - uniform distribution */
-        this->t = getRandom(0,this->w);
+        this->t = generator.uniform(0, this->w);
 
         /* Fix item - Pick random floats in standard distribution */
         for(i = 0; i < dim; i++)
-            components[i] = getRandom(1);
+            components[i] = generator.normal();
 
         /* Create item v */
         this->v = new Item(components, status);
@@ -56,6 +59,39 @@ hEuclidean::hEuclidean(int dim, int w):w(w){
     }
 }
 
+/* Read saved parameters: dim, w, t, v */
+hEuclidean::hEuclidean(ifstream& file){
+    int32_t dim, w;
+    errorCode status;
+
+    this->v = NULL;
+
+    file.read((char*)&dim, sizeof(int32_t));
+    file.read((char*)&w, sizeof(int32_t));
+    file.read((char*)&this->t, sizeof(float));
+
+    /* Check parameters */
+    if(!file || dim <= 0 || dim > MAX_DIM || w < MIN_W || w > MAX_W)
+        return;
+
+    vector<double> components(dim);
+
+    file.read((char*)components.data(), sizeof(double) * dim);
+    if(!file)
+        return;
+
+    this->w = w;
+
+    /* Fix id */
+    this->id = "hEuclidean_" + to_string(this->count++);
+
+    this->v = new Item(components, status);
+    if(status != SUCCESS){
+        delete this->v;
+        this->v = NULL;
+    }
+}
+
 /* Destructor */
 hEuclidean::~hEuclidean(){
     if(v != NULL)
@@ -117,11 +153,11 @@ int hEuclidean::compare(hCosine& x, errorCode& status){
 }
 
 /* Get size */
-unsigned hEuclidean::size(void){
-    unsigned result = 0;
+size_t hEuclidean::size(void){
+    size_t result = 0;
 
     if(this->v == NULL){
-        return -1;
+        return 0;
     }
 
     result += sizeof(this->id) + this->id.capacity() * sizeof(char);
@@ -133,6 +169,27 @@ unsigned hEuclidean::size(void){
     return result;
 }
 
+/* Write parameters: dim, w, t, v */
+void hEuclidean::save(ofstream& file, errorCode& status){
+    int32_t dim, w = this->w;
+
+    status = SUCCESS;
+    if(this->v == NULL){
+        status = INVALID_HASH_FUNCTION;
+        return;
+    }
+
+    dim = this->v->getDim();
+
+    file.write((const char*)&dim, sizeof(int32_t));
+    file.write((const char*)&w, sizeof(int32_t));
+    file.write((const char*)&this->t, sizeof(float));
+    file.write((const char*)this->v->getComponents().data(), sizeof(double) * dim);
+
+    if(!file)
+        status = INVALID_INDEX_FILE;
+}
+
 /* Get number of sub hash functions */
 int hEuclidean::getCount(void){
     return this->count;
@@ -155,9 +212,9 @@ void hEuclidean::print(void){
 /* Implementation of sub cosine hash function class */
 //////////////////////////////////////////////////////
 
-int hCosine::count = 0;
+atomic<int> hCosine::count(0);
 
-hCosine::hCosine(int dim){
+hCosine::hCosine(int dim, uint64_t seed){
     /* Check parameters */
     if(dim <= 0 || dim > MAX_DIM){
         this->r = NULL;
@@ -167,14 +224,14 @@ hCosine::hCosine(int dim){
         vector<double> components(dim);
         int i = 0;
         errorCode status;
+        randomGenerator generator(seed);
 
         /* Fix id */
-        this->id = "hCosine_" + to_string(this->count); 
-        this->count += 1;
+        this->id = "hCosine_" + to_string(this->count++);
 
         /* Fix item - Pick random float in standard distribution */
         for(i = 0; i < dim; i++)
-            components[i] = getRandom(1);
+            components[i] = generator.normal();
 
         this->r = new Item(components, status);
         if(status != 0){
@@ -187,6 +244,35 @@ hCosine::hCosine(int dim){
     }
 }
 
+/* Read saved parameters: dim, r */
+hCosine::hCosine(ifstream& file){
+    int32_t dim;
+    errorCode status;
+
+    this->r = NULL;
+
+    file.read((char*)&dim, sizeof(int32_t));
+
+    /* Check parameters */
+    if(!file || dim <= 0 || dim > MAX_DIM)
+        return;
+
+    vector<double> components(dim);
+
+    file.read((char*)components.data(), sizeof(double) * dim);
+    if(!file)
+        return;
+
+    /* Fix id */
+    this->id = "hCosine_" + to_string(this->count++);
+
+    this->r = new Item(components, status);
+    if(status != SUCCESS){
+        delete this->r;
+        this->r = NULL;
+    }
+}
+
 /* Destructor */
 hCosine::~hCosine(){
     if(r != NULL)
@@ -245,11 +331,11 @@ int hCosine::compare(hEuclidean& x, errorCode& status){
 }
 
 /* Get size */
-unsigned hCosine::size(void){
-    unsigned result = 0;
+size_t hCosine::size(void){
+    size_t result = 0;
 
     if(this->r == NULL){
-        return -1;
+        return 0;
     }
 
     result += sizeof(this->id) + this->id.capacity() * sizeof(char);
@@ -259,6 +345,25 @@ unsigned hCosine::size(void){
     return result;
 }
 
+/* Write parameters: dim, r */
+void hCosine::save(ofstream& file, errorCode& status){
+    int32_t dim;
+
+    status = SUCCESS;
+    if(this->r == NULL){
+        status = INVALID_HASH_FUNCTION;
+        return;
+    }
+
+    dim = this->r->getDim();
+
+    file.write((const char*)&dim, sizeof(int32_t));
+    file.write((const char*)this->r->getComponents().data(), sizeof(double) * dim);
+
+    if(!file)
+        status = INVALID_INDEX_FILE;
+}
+
 /* Get number of sub hash functions */
 int hCosine::getCount(void){
     return this->count;
@@ -287,22 +392,20 @@ hashFunction::~hashFunction(){}
 /* Implementation of euclidean hash function class */
 /////////////////////////////////////////////////////
 
-int hashFunctionEuclidean::count = 0;
+atomic<int> hashFunctionEuclidean::count(0);
 
-hashFunctionEuclidean::hashFunctionEuclidean(int dim, int k, int w, int tableSize):k(k),w(w),tableSize(tableSize){
+hashFunctionEuclidean::hashFunctionEuclidean(int dim, int k, int w, int tableSize, uint64_t seed):k(k),w(w),tableSize(tableSize){
     /* Check parameters */
     if(dim <= 0 || dim > MAX_DIM || k < MIN_K || k > MAX_K || tableSize <= 0 || w < MIN_W || w > MAX_W){
         this->k = -1;
     }
     else{ 
-        int i,j;
-        errorCode status;
+        int i;
         hEuclidean* newFunc;
-        
-        status = SUCCESS;
+        randomGenerator generator(seed);
+        vector<uint64_t> seeds;
 
-        this->id = "EuclideanHash_" + to_string(this->count); 
-        this->count += 1;
+        this->id = "EuclideanHash_" + to_string(this->count++);
 
         /* Set size of R */
         this->R.reserve(k);
@@ -310,51 +413,86 @@ hashFunctionEuclidean::hashFunctionEuclidean(int dim, int k, int w, int tableSiz
         /* Set size of H */
         this->H.reserve(k);
 
+        /* Sub hash functions of different seeds are different */
+        generator.uniqueSeeds(this->k, seeds);
+
         /* Pick k hash(h) functions */
         for(i = 0; i < this->k; i++){
-            newFunc = new hEuclidean(dim,w);
+            newFunc = new hEuclidean(dim, w, seeds[i]);
             if(newFunc == NULL){
-                status = ALLOCATION_FAILED;
                 this->k = -1;
                 break;
             }
 
-            /* Truncate same sub hash functions */
-            for(j = 0; j < i; j++){
-                if(this->H[j]->compare(*newFunc, status) == 0){
-                    delete newFunc;
-                    break;
-                }
-
-                if(status != SUCCESS){
-                    delete newFunc;
-                    this->k = -1;
-                    break;
-                }
-            } // End for
-            
-            if(status != SUCCESS)
-                break;
-
-            /* Add function */
-            if(j == i)
-                this->H[i] = newFunc;
-            else
-                i -= 1;
+            this->H.push_back(newFunc);
         } // End for
 
         /* Delete remaining h functions */
-        if(status != SUCCESS){
-            for(j = 0; j < i; j++)
-                delete this->H[j];
+        if(this->k == -1){
+            for(i = 0; i < (int)this->H.size(); i++)
+                delete this->H[i];
             
             return;
         }
 
         /* Pick random R values */
         for(i = 0; i < this->k; i++)
-            this->R[i] = (int)getRandom(2);
+            this->R.push_back(generator.uniformInt(MY_MIN_RANDOM, MY_MAX_RANDOM));
+    }
+}
+
+/* Read saved parameters: k, w, table size, ri values, h functions */
+hashFunctionEuclidean::hashFunctionEuclidean(ifstream& file){
+    int32_t k, w, tableSize, currR;
+    int i;
+    hEuclidean* newFunc;
+
+    this->k = -1;
+
+    file.read((char*)&k, sizeof(int32_t));
+    file.read((char*)&w, sizeof(int32_t));
+    file.read((char*)&tableSize, sizeof(int32_t));
+
+    /* Check parameters */
+    if(!file || k < MIN_K || k > MAX_K || tableSize <= 0 || w < MIN_W || w > MAX_W)
+        return;
+
+    this->w = w;
+    this->tableSize = tableSize;
+
+    this->id = "EuclideanHash_" + to_string(this->count++);
+
+    this->R.reserve(k);
+    this->H.reserve(k);
+
+    for(i = 0; i < k; i++){
+        file.read((char*)&currR, sizeof(int32_t));
+        this->R.push_back(currR);
+    }
+
+    if(!file)
+        return;
+
+    /* Read h functions */
+    for(i = 0; i < k; i++){
+        newFunc = new hEuclidean(file);
+        if(newFunc->size() == 0){
+            delete newFunc;
+            break;
+        }
+
+        this->H.push_back(newFunc);
+    } // End for
+
+    /* Delete read h functions */
+    if(i != k){
+        for(i = 0; i < (int)this->H.size(); i++)
+            delete this->H[i];
+        
+        return;
     }
+
+    this->k = k;
 }
 
 /* Destructor */
@@ -474,11 +612,11 @@ int hashFunctionEuclidean::compare(hashFunctionEuclideanHypercube& x, errorCode&
 }
 
 /* Get size */
-unsigned hashFunctionEuclidean::size(void){
-    unsigned result = 0;
+size_t hashFunctionEuclidean::size(void){
+    size_t result = 0;
 
     if(this->k == -1){
-        return -1;
+        return 0;
     }
 
     int i;
@@ -500,6 +638,33 @@ unsigned hashFunctionEuclidean::size(void){
     return result;
 }
 
+/* Write parameters: k, w, table size, ri values, h functions */
+void hashFunctionEuclidean::save(ofstream& file, errorCode& status){
+    int32_t k = this->k, w = this->w, tableSize = this->tableSize, currR;
+    int i;
+
+    status = SUCCESS;
+    if(this->k == -1){
+        status = INVALID_HASH_FUNCTION;
+        return;
+    }
+
+    file.write((const char*)&k, sizeof(int32_t));
+    file.write((const char*)&w, sizeof(int32_t));
+    file.write((const char*)&tableSize, sizeof(int32_t));
+
+    for(i = 0; i < this->k; i++){
+        currR = this->R[i];
+        file.write((const char*)&currR, sizeof(int32_t));
+    }
+
+    for(i = 0; i < this->k; i++){
+        this->H[i]->save(file, status);
+        if(status != SUCCESS)
+            return;
+    }
+}
+
 /* Get number of euclidean has functions */
 int hashFunctionEuclidean::getCount(void){
     return this->count;
@@ -533,66 +698,86 @@ void hashFunctionEuclidean::print(void){
 /* Implementation of cosine hash function class */
 //////////////////////////////////////////////////
 
-int hashFunctionCosine::count = 0;
+atomic<int> hashFunctionCosine::count(0);
 
-hashFunctionCosine::hashFunctionCosine(int dim, int k):k(k){
+hashFunctionCosine::hashFunctionCosine(int dim, int k, uint64_t seed):k(k){
     /* Check parameters */
     if(dim <= 0 || dim > MAX_DIM || k <= 0 || k > MAX_K){
         this->k = -1;
     }
     else{ 
-        int i, j;
-        errorCode status;
+        int i;
         hCosine* newFunc = NULL;
-        
-        status = SUCCESS;
+        randomGenerator generator(seed);
+        vector<uint64_t> seeds;
 
         /* Set name */
-        this->id = "cosineHash_" + to_string(this->count);
-        this->count += 1;
+        this->id = "cosineHash_" + to_string(this->count++);
 
         /* Set size of H */
         this->H.reserve(k);
 
+        /* Sub hash functions of different seeds are different */
+        generator.uniqueSeeds(this->k, seeds);
+
         for(i = 0; i < this->k; i++){
-            newFunc = new hCosine(dim);
+            newFunc = new hCosine(dim, seeds[i]);
             if(newFunc == NULL){
-                status = ALLOCATION_FAILED;
                 this->k = -1;
                 break;  
             }
 
-            /* Truncate same sub hash functions */
-            for(j = 0; j < i; j++){
-                if(this->H[j]->compare(*newFunc, status) == 0){
-                    delete newFunc;
-                    break;
-                }
-            
-                if(status != SUCCESS){
-                    delete newFunc;
-                    this->k = -1;
-                    break;
-                } 
-            } // End for
-
-            if(status != SUCCESS)
-                break;
-
-            /* Add function */
-            if(j == i)
-                this->H[i] = newFunc;
-            else 
-                i -= 1;
+            this->H.push_back(newFunc);
         } // End for
 
         /* Delete remaining h sub has functions */
-        if(status != SUCCESS)
-            for(j = 0; j < i; j++)
-                delete this->H[j];
+        if(this->k == -1)
+            for(i = 0; i < (int)this->H.size(); i++)
+                delete this->H[i];
     }
 }
 
+/* Read saved parameters: k, h functions */
+hashFunctionCosine::hashFunctionCosine(ifstream& file){
+    int32_t k;
+    int i;
+    hCosine* newFunc;
+
+    this->k = -1;
+
+    file.read((char*)&k, sizeof(int32_t));
+
+    /* Check parameters */
+    if(!file || k <= 0 || k > MAX_K)
+        return;
+
+    /* Set name */
+    this->id = "cosineHash_" + to_string(this->count++);
+
+    this->H.reserve(k);
+
+    /* Read h functions */
+    for(i = 0; i < k; i++){
+        newFunc = new hCosine(file);
+        if(newFunc->size() == 0){
+            delete newFunc;
+            break;
+        }
+
+        this->H.push_back(newFunc);
+    } // End for
+
+    /* Delete read h functions */
+    if(i != k){
+        for(i = 0; i < (int)this->H.size(); i++)
+            delete this->H[i];
+        
+        return;
+    }
+
+    this->k = k;
+}
+
 /* Destructor */
 hashFunctionCosine::~hashFunctionCosine(){
     if(this->k != -1){
@@ -676,11 +861,11 @@ int hashFunctionCosine::compare(hashFunctionEuclideanHypercube& x, errorCode& st
 }
 
 /* Get size */
-unsigned hashFunctionCosine::size(void){
-    unsigned result = 0;
+size_t hashFunctionCosine::size(void){
+    size_t result = 0;
 
     if(this->k == -1){
-        return -1;
+        return 0;
     }
 
     int i;
@@ -698,6 +883,26 @@ unsigned hashFunctionCosine::size(void){
     return result;
 }
 
+/* Write parameters: k, h functions */
+void hashFunctionCosine::save(ofstream& file, errorCode& status){
+    int32_t k = this->k;
+    int i;
+
+    status = SUCCESS;
+    if(this->k == -1){
+        status = INVALID_HASH_FUNCTION;
+        return;
+    }
+
+    file.write((const char*)&k, sizeof(int32_t));
+
+    for(i = 0; i < this->k; i++){
+        this->H[i]->save(file, status);
+        if(status != SUCCESS)
+            return;
+    }
+}
+
 /* Get total cosine functions */
 int hashFunctionCosine::getCount(void){
     return this->count;
@@ -724,72 +929,48 @@ void hashFunctionCosine::print(void){
 /* Implementation of euclidean hypercube hash function class */
 ///////////////////////////////////////////////////////////////
 
-int hashFunctionEuclideanHypercube::count = 0;
+atomic<int> hashFunctionEuclideanHypercube::count(0);
 
-hashFunctionEuclideanHypercube::hashFunctionEuclideanHypercube(int dim, int k, int w):k(k),w(w){
+hashFunctionEuclideanHypercube::hashFunctionEuclideanHypercube(int dim, int k, int w, uint64_t seed):k(k),w(w),generator(seed){
     /* Check parameters */
     if(dim <= 0 || dim > MAX_DIM || k < MIN_K || k > MAX_K || w < MIN_W || w > MAX_W){
         this->k = -1;
     }
     else{ 
-        int i,j;
-        errorCode status;
+        int i;
         hEuclidean* newFunc;
-        
-        status = SUCCESS;
+        vector<uint64_t> seeds;
 
-        this->id = "EuclideanHypercubeHash_" + to_string(this->count); 
-        this->count += 1;
+        this->id = "EuclideanHypercubeHash_" + to_string(this->count++);
 
         /* Set size of H */
         this->H.reserve(k);
 
+        /* Sub hash functions of different seeds are different */
+        this->generator.uniqueSeeds(this->k, seeds);
+
         /* Pick k hash(h) functions */
         for(i = 0; i < this->k; i++){
-            newFunc = new hEuclidean(dim, w);
+            newFunc = new hEuclidean(dim, w, seeds[i]);
             if(newFunc == NULL){
-                status = ALLOCATION_FAILED;
                 this->k = -1;
                 break;
             }
 
-            /* Truncate same sub hash functions */
-            for(j = 0; j < i; j++){
-                if(this->H[j]->compare(*newFunc, status) == 0){
-                    delete newFunc;
-                    break;
-                }
-
-                if(status != SUCCESS){
-                    delete newFunc;
-                    this->k = -1;
-                    break;
-                }
-            } // End for
-            
-            if(status != SUCCESS)
-                break;
-
-            /* Add function */
-            if(j == i)
-                this->H[i] = newFunc;
-            else
-                i -= 1;
+            this->H.push_back(newFunc);
         } // End for
 
         /* Delete remaining h functions */
-        if(status != SUCCESS){
-            for(j = 0; j < i; j++)
-                delete this->H[j];
+        if(this->k == -1){
+            for(i = 0; i < (int)this->H.size(); i++)
+                delete this->H[i];
             
             return;
         }
 
-        /* Fix maps -dist */
-        for(i = 0; i < this->k; i++){
-            this->dist.push_back(uniform_int_distribution<int>(0,1));
+        /* Fix maps */
+        for(i = 0; i < this->k; i++)
             this->hMaps.push_back(unordered_map<int, int>());
-        }
     }
 }
 
@@ -836,7 +1017,7 @@ int hashFunctionEuclideanHypercube::hash(Item& p, errorCode& status){
 
         /* Map current H[i] and add value in map */
         else{
-            currValF = this->dist[i](this->generator);
+            currValF = this->generator.uniformInt(0, 1);
             this->hMaps[i].insert(pair<int, int>(currValH, currValF));
         }
       
@@ -873,11 +1054,11 @@ int hashFunctionEuclideanHypercube::compare(hashFunctionEuclideanHypercube& x, e
 }
 
 /* Get size */
-unsigned hashFunctionEuclideanHypercube::size(void){
-    unsigned result = 0;
+size_t hashFunctionEuclideanHypercube::size(void){
+    size_t result = 0;
 
     if(this->k == -1){
-        return -1;
+        return 0;
     }
 
     int i;
@@ -894,7 +1075,6 @@ unsigned hashFunctionEuclideanHypercube::size(void){
     
     result += this->hMaps.capacity() * sizeof(unordered_map<int, int>);
 
-    result += this->dist.capacity() * sizeof(uniform_int_distribution<int>(0,1)) + sizeof(dist);
     result += sizeof(this->generator);
     result += sizeof(hMaps);
 
@@ -905,6 +1085,11 @@ unsigned hashFunctionEuclideanHypercube::size(void){
     return result;
 }
 
+/* Values of fi are picked while hashing - Can't be saved */
+void hashFunctionEuclideanHypercube::save(ofstream& file, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
+}
+
 /* Get number of euclidean has functions */
 int hashFunctionEuclideanHypercube::getCount(void){
     return this->count;
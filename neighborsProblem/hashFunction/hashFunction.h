@@ -1,7 +1,9 @@
 #pragma once
 #include <vector>
+#include <fstream>
 #include <unordered_map>
-#include <random>
+#include <atomic>
+#include <cstdint>
 #include "../item/item.h"
 #include "../utils/utils.h"
 
@@ -25,7 +27,10 @@ class h{
         virtual int compare(hCosine& x, errorCode& status) = 0;
 
         /* Get size of hash functions */
-        virtual unsigned size(void) = 0;
+        virtual size_t size(void) = 0;
+
+        /* Write parameters in a binary file */
+        virtual void save(std::ofstream& file, errorCode& status) = 0;
 
         /* Get total sub hash function */
         virtual int getCount(void) = 0;
@@ -36,16 +41,18 @@ class h{
 
 /* Sub euclidean hash function class */
 /* h(p) = floor((p . v + t) / W)     */
+/* v and t are picked from the seed  */
 class hEuclidean: public h{
     private:
         std::string id;
         Item* v; // Random item - Standard distribution
         float t; // Random float [0,w) - Uniform distribution
         int w; // Window size
-        static int count;
+        static std::atomic<int> count; // Functions can be created by many threads
 
     public:
-        hEuclidean(int dim, int w);
+        hEuclidean(int dim, int w, uint64_t seed);
+        hEuclidean(std::ifstream& file); // Read saved parameters
         ~hEuclidean();
 
         /* Overide functions */
@@ -54,7 +61,8 @@ class hEuclidean: public h{
         int compare(hEuclidean& x, errorCode& status);
         int compare(hCosine& x, errorCode& status);
         
-        unsigned size(void);
+        size_t size(void);
+        void save(std::ofstream& file, errorCode& status);
         int getCount(void);
         void print(void);
 };
@@ -66,10 +74,11 @@ class hCosine: public h{
     private:
         std::string id;
         Item* r; // Random item - Standard distribution
-        static int count;
+        static std::atomic<int> count; // Functions can be created by many threads
 
     public:
-        hCosine(int);
+        hCosine(int dim, uint64_t seed);
+        hCosine(std::ifstream& file); // Read saved parameters
         ~hCosine();
 
         /* Overide functions */
@@ -78,7 +87,8 @@ class hCosine: public h{
         int compare(hEuclidean& x, errorCode& status);
         int compare(hCosine& x, errorCode& status);
         
-        unsigned size(void);
+        size_t size(void);
+        void save(std::ofstream& file, errorCode& status);
         int getCount(void);
         void print(void);
 };
@@ -99,7 +109,10 @@ class hashFunction{
         virtual int compare(hashFunctionEuclideanHypercube& x, errorCode& status) = 0;
        
         /* Get size */
-        virtual unsigned size(void) = 0;
+        virtual size_t size(void) = 0;
+
+        /* Write parameters in a binary file */
+        virtual void save(std::ofstream& file, errorCode& status) = 0;
         
         /* Get total sub hash function */
         virtual int getCount(void) = 0;
@@ -119,10 +132,12 @@ class hashFunctionEuclidean: public hashFunction{
         int k; // Number of sub hash functions
         int w; // Window size
         int tableSize;
-        static int count;
+        static std::atomic<int> count; // Functions can be created by many threads
 
     public:
-        hashFunctionEuclidean(int dim, int k, int w, int tableSize);
+        /* Seeds of sub hash functions and ri values are picked from the seed */
+        hashFunctionEuclidean(int dim, int k, int w, int tableSize, uint64_t seed);
+        hashFunctionEuclidean(std::ifstream& file); // Read saved parameters
         ~hashFunctionEuclidean();
 
         /* Overide functions */
@@ -133,7 +148,8 @@ class hashFunctionEuclidean: public hashFunction{
         int compare(hashFunctionCosine& x, errorCode& status);       
         int compare(hashFunctionEuclideanHypercube& x, errorCode& status);
         
-        unsigned size(void);
+        size_t size(void);
+        void save(std::ofstream& file, errorCode& status);
         int getCount(void);
         void print(void);
 };
@@ -145,10 +161,11 @@ class hashFunctionCosine: public hashFunction{
         std::string id;
         std::vector<hCosine*> H; // H contains sub hash functions        
         int k; // Number of sub hash functions
-        static int count;
+        static std::atomic<int> count; // Functions can be created by many threads
 
     public:
-        hashFunctionCosine(int dim, int k);
+        hashFunctionCosine(int dim, int k, uint64_t seed);
+        hashFunctionCosine(std::ifstream& file); // Read saved parameters
         ~hashFunctionCosine();
 
         /* Overide functions */
@@ -159,7 +176,8 @@ class hashFunctionCosine: public hashFunction{
         int compare(hashFunctionCosine& x, errorCode& status);
         int compare(hashFunctionEuclideanHypercube& x, errorCode& status);
         
-        unsigned size(void);
+        size_t size(void);
+        void save(std::ofstream& file, errorCode& status);
         int getCount(void);
         void print(void);
 };
@@ -173,12 +191,11 @@ class hashFunctionEuclideanHypercube: public hashFunction{
         std::vector<std::unordered_map<int, int>  > hMaps; // Keep in map f unique values
         int k; // Number of sub hash functions
         int w; // Window size
-        std::vector<std::uniform_int_distribution<int> > dist; // DIstributions for fi 
-        std::default_random_engine generator; 
-        static int count;
+        randomGenerator generator; // Seeds of sub hash functions and values of fi
+        static std::atomic<int> count; // Functions can be created by many threads
 
     public:
-        hashFunctionEuclideanHypercube(int dim, int k, int w);
+        hashFunctionEuclideanHypercube(int dim, int k, int w, uint64_t seed);
         ~hashFunctionEuclideanHypercube();
 
         /* Overide functions */
@@ -189,7 +206,8 @@ class hashFunctionEuclideanHypercube: public hashFunction{
         int compare(hashFunctionCosine& x, errorCode& status);
         int compare(hashFunctionEuclideanHypercube& x, errorCode& status);
         
-        unsigned size(void);
+        size_t size(void);
+        void save(std::ofstream& file, errorCode& status);
         int getCount(void);
         void print(void);
 };
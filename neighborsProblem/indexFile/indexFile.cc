@@ -0,0 +1,170 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "indexFile.h"
+#include "../item/item.h"
+#include "../utils/utils.h"
+
+using namespace std;
+
+/* Reset header and set magic, version */
+void initIndexHeader(indexHeader& header){
+    memset(&header, 0, sizeof(indexHeader));
+    strncpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+}
+
+/* Write header at the start of given file - Keep current position */
+void writeIndexHeader(ofstream& file, indexHeader& header, errorCode& status){
+    streampos currPos;
+
+    status = SUCCESS;
+
+    currPos = file.tellp();
+    file.seekp(0, ios::beg);
+    file.write((const char*)&header, sizeof(indexHeader));
+
+    /* First write - Continue after header */
+    if(currPos > 0)
+        file.seekp(currPos);
+
+    if(!file)
+        status = INVALID_INDEX_FILE;
+}
+
+/* Read header of given file and check magic, version */
+void readIndexHeader(ifstream& file, indexHeader& header, errorCode& status){
+    status = SUCCESS;
+
+    file.read((char*)&header, sizeof(indexHeader));
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    if(strncmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 || header.version != INDEX_VERSION){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    /* Check members */
+    if(header.n < MIN_POINTS || header.n > MAX_POINTS || header.dim <= 0 || header.dim > MAX_DIM)
+        status = INVALID_INDEX_FILE;
+}
+
+/* Pad file up to alignment and return offset of next array */
+uint64_t beginIndexSection(ofstream& file, errorCode& status){
+    uint64_t offset, padding;
+    char zeros[INDEX_ALIGNMENT] = {0};
+
+    status = SUCCESS;
+
+    offset = (uint64_t)file.tellp();
+    padding = (INDEX_ALIGNMENT - offset % INDEX_ALIGNMENT) % INDEX_ALIGNMENT;
+
+    file.write(zeros, padding);
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return 0;
+    }
+
+    return offset + padding;
+}
+
+/* Write points matrix and ids of given points - Set offsets of header */
+/* Points are written row by row - No extra copy of the data set       */
+void writeIndexPoints(ofstream& file, vector<Item>& points, indexHeader& header, errorCode& status){
+    int i;
+    uint64_t currOffset = 0;
+    string currId;
+
+    status = SUCCESS;
+
+    /* Points matrix */
+    header.pointsOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
+
+    for(i = 0; i < header.n; i++){
+        if(points[i].getDim() != header.dim){
+            status = INVALID_DIM;
+            return;
+        }
+
+        file.write((const char*)points[i].getComponents().data(), sizeof(double) * header.dim);
+    } // End for
+
+    /* Offsets of ids */
+    header.idOffsetsOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
+
+    file.write((const char*)&currOffset, sizeof(uint64_t));
+    for(i = 0; i < header.n; i++){
+        currOffset += points[i].getId().length();
+        file.write((const char*)&currOffset, sizeof(uint64_t));
+    } // End for
+
+    /* Ids */
+    header.idsOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
+
+    for(i = 0; i < header.n; i++){
+        currId = points[i].getId();
+        file.write(currId.data(), currId.length());
+    } // End for
+
+    if(!file)
+        status = INVALID_INDEX_FILE;
+}
+
+/* Map given file read only                                    */
+/* Pages are shared with every process that maps the same file */
+const char* mapIndexFile(string fileName, uint64_t& length, errorCode& status){
+    int fd;
+    struct stat fileStat;
+    void* data;
+
+    status = SUCCESS;
+
+    fd = open(fileName.c_str(), O_RDONLY);
+    if(fd < 0){
+        status = INVALID_INDEX_FILE;
+        return NULL;
+    }
+
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(indexHeader)){
+        close(fd);
+        status = INVALID_INDEX_FILE;
+        return NULL;
+    }
+
+    length = fileStat.st_size;
+
+    data = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+
+    /* Mapping stays valid after close */
+    close(fd);
+
+    if(data == MAP_FAILED){
+        status = ALLOCATION_FAILED;
+        return NULL;
+    }
+
+    return (const char*)data;
+}
+
+void unmapIndexFile(const char* data, uint64_t length){
+    if(data != NULL)
+        munmap((void*)data, length);
+}
+
+// Petropoulakis Panagiotis
@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+#include "../utils/utils.h"
+#include "../item/item.h"
+
+/* Functions for saving fitted models in binary index files and mapping them back */
+
+/* Layout: header | hash functions | points | id offsets | ids | buckets */
+/* Arrays start at INDEX_ALIGNMENT so they can be used in place          */
+#define INDEX_MAGIC "NNINDEX"
+#define INDEX_VERSION 1
+#define INDEX_ALIGNMENT 64
+
+/* Type of saved model */
+typedef enum indexType{
+    INDEX_EXHAUSTIVE,
+    INDEX_LSH_EUCLIDEAN,
+    INDEX_LSH_COSINE
+}indexType;
+
+/* Saved metrice */
+typedef enum indexMetrice{
+    INDEX_EUCLIDEAN,
+    INDEX_COSINE
+}indexMetrice;
+
+/* Header of index file - Offsets are in bytes from the start of the file */
+typedef struct indexHeader{
+    char magic[8];
+    int32_t version;
+    int32_t type;
+    int32_t metrice;
+    int32_t n; // Number of items
+    int32_t dim; // Dimension
+    int32_t l; // Total tables
+    int32_t k; // Number of sub hash functions
+    int32_t tableSize;
+    uint64_t pointsOffset; // n x dim doubles
+    uint64_t idOffsetsOffset; // n + 1 offsets in ids
+    uint64_t idsOffset; // Concatenated ids
+    uint64_t bucketOffsetsOffset; // l x (tableSize + 1) ints - First entry of each bucket
+    uint64_t bucketEntriesOffset; // l x n ints - Points of each table sorted by bucket
+    uint64_t valuesGOffset; // l x n x k ints - Values g of entries(lsh euclidean)
+    uint64_t fileSize;
+}indexHeader;
+
+/* Reset header and set magic, version */
+void initIndexHeader(indexHeader& header);
+
+/* Write(or rewrite) header at the start of given file */
+void writeIndexHeader(std::ofstream& file, indexHeader& header, errorCode& status);
+
+/* Read header of given file and check magic, version */
+void readIndexHeader(std::ifstream& file, indexHeader& header, errorCode& status);
+
+/* Pad file up to alignment and return offset of next array */
+uint64_t beginIndexSection(std::ofstream& file, errorCode& status);
+
+/* Write points matrix and ids of given points - Set offsets of header */
+void writeIndexPoints(std::ofstream& file, std::vector<Item>& points, indexHeader& header, errorCode& status);
+
+/* Map given file read only. Pages are shared between processes */
+const char* mapIndexFile(std::string fileName, uint64_t& length, errorCode& status);
+void unmapIndexFile(const char* data, uint64_t length);
+
+// Petropoulakis Panagiotis
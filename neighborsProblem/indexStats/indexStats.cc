@@ -0,0 +1,139 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <malloc.h>
+#include "indexStats.h"
+#include "../item/item.h"
+
+using namespace std;
+
+/* Statistics of given bucket sizes - Sizes are sorted */
+void computeBucketStats(vector<int>& sizes, bucketStats& stats){
+    int i, rank;
+    long items = 0;
+    double squares = 0, weighted = 0; // sum(size^2), sum(i * size)
+
+    stats.buckets = sizes.size();
+    stats.emptyBuckets = 0;
+    stats.emptyFraction = 0;
+    stats.meanSize = 0;
+    stats.maxSize = 0;
+    stats.p99Size = 0;
+    stats.gini = 0;
+    stats.expectedCandidates = 0;
+
+    if(sizes.size() == 0)
+        return;
+
+    sort(sizes.begin(), sizes.end());
+
+    for(i = 0; i < stats.buckets; i++){
+        if(sizes[i] == 0)
+            stats.emptyBuckets += 1;
+
+        items += sizes[i];
+        squares += (double)sizes[i] * sizes[i];
+        weighted += (double)(i + 1) * sizes[i];
+    } // End for
+
+    stats.emptyFraction = (double)stats.emptyBuckets / stats.buckets;
+    stats.maxSize = sizes.back();
+
+    /* Nearest rank */
+    rank = (int)ceil(0.99 * stats.buckets);
+    if(rank < 1)
+        rank = 1;
+    stats.p99Size = sizes[rank - 1];
+
+    if(items == 0)
+        return;
+
+    stats.meanSize = (double)items / (stats.buckets - stats.emptyBuckets);
+
+    /* Gini of sorted sizes: 2 * sum(i * size) / (buckets * items) - (buckets + 1) / buckets */
+    stats.gini = 2 * weighted / ((double)stats.buckets * items) - (double)(stats.buckets + 1) / stats.buckets;
+
+    /* A query falls in a bucket with probability size / items */
+    stats.expectedCandidates = squares / items;
+}
+
+/* Print statistics of an index */
+void printIndexStats(indexStats& stats, string tableName, ostream& out){
+    int i;
+
+    for(i = 0; i < (int)stats.tables.size(); i++){
+        bucketStats& curr = stats.tables[i];
+
+        out << tableName;
+        if(stats.tables.size() > 1)
+            out << " " << i;
+
+        out << ": " << curr.buckets << " buckets, empty " << curr.emptyFraction * 100 << "%, mean " << curr.meanSize;
+        out << ", p99 " << curr.p99Size << ", max " << curr.maxSize << ", gini " << curr.gini << "\n";
+    } // End for
+
+    out << "Expected candidates per query: " << stats.expectedCandidates << "\n";
+}
+
+/////////////////////
+/* Memory of model */
+/////////////////////
+
+/* Chunks of glibc malloc: 8 bytes header, 16 bytes alignment, 32 bytes min */
+#define CHUNK_HEADER 8
+#define CHUNK_ALIGNMENT 16
+#define CHUNK_MIN 32
+
+void resetMemoryReport(memoryReport& report){
+    report.points = 0;
+    report.ids = 0;
+    report.buckets = 0;
+    report.hashFunctions = 0;
+    report.overhead = 0;
+    report.total = 0;
+}
+
+/* Count count allocations of given bytes */
+void addAllocation(size_t bytes, size_t& component, memoryReport& report, size_t count){
+    size_t chunk;
+
+    /* Nothing is allocated */
+    if(bytes == 0 || count == 0)
+        return;
+
+    chunk = (bytes + CHUNK_HEADER + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT;
+    if(chunk < CHUNK_MIN)
+        chunk = CHUNK_MIN;
+
+    component += bytes * count;
+    report.overhead += (chunk - bytes) * count;
+}
+
+/* Count the heap memory of an item */
+void addItem(Item& point, memoryReport& report){
+    addAllocation(point.componentsBytes(), report.points, report);
+    addAllocation(point.idBytes(), report.ids, report);
+}
+
+/* Sum components in total */
+void sumMemoryReport(memoryReport& report){
+    report.total = report.points + report.ids + report.buckets + report.hashFunctions + report.overhead;
+}
+
+/* Print bytes of every component */
+void printMemoryReport(memoryReport& report, ostream& out){
+    out << "Memory: " << report.total << " bytes(points " << report.points << ", ids " << report.ids;
+    out << ", buckets " << report.buckets << ", hash functions " << report.hashFunctions << ", overhead " << report.overhead << ")\n";
+}
+
+/* Bytes allocated from the heap by the process */
+size_t heapBytesInUse(void){
+    struct mallinfo2 info = mallinfo2();
+
+    /* Small chunks and mapped chunks of big allocations */
+    return info.uordblks + info.hblkhd;
+}
+
+// Petropoulakis Panagiotis
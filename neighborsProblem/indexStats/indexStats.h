@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <iostream>
+#include "../item/item.h"
+
+/* Statistics of fitted indexes: occupancy of buckets(giant buckets cause slow queries) */
+/* and memory of every component                                                      */
+
+/* Distribution of bucket sizes of a hash table(lsh) or of the vertices of a cube */
+typedef struct bucketStats{
+    int buckets; // Total buckets
+    int emptyBuckets;
+    double emptyFraction;
+    double meanSize; // Mean size of non empty buckets
+    int maxSize;
+    int p99Size; // 99% of buckets have up to p99Size items
+    double gini; // 0: equal buckets, 1: every item in one bucket
+    double expectedCandidates; // Items in the bucket of a query drawn from the data: sum(size^2) / n
+}bucketStats;
+
+/* Statistics of a fitted index */
+typedef struct indexStats{
+    std::vector<bucketStats> tables; // One per hash table(lsh) or one for the cube
+    double expectedCandidates; // Candidates scanned per query(all tables, capped by M for cubes)
+}indexStats;
+
+/* Statistics of given bucket sizes - Sizes are sorted */
+void computeBucketStats(std::vector<int>& sizes, bucketStats& stats);
+
+/* Print statistics of an index */
+void printIndexStats(indexStats& stats, std::string tableName = "Table", std::ostream& out = std::cout);
+
+/* Bytes of a node of std::list: two pointers and the value */
+#define LIST_NODE_BYTES(type) (2 * sizeof(void*) + sizeof(type))
+
+/* Bytes of a fitted model per component */
+typedef struct memoryReport{
+    size_t points; // Items and their components
+    size_t ids; // Ids longer than the buffer of std::string
+    size_t buckets; // Hash tables, entries, values g
+    size_t hashFunctions; // Parameters of hash functions
+    size_t overhead; // Model object, headers and padding of the allocator
+    size_t total;
+}memoryReport;
+
+void resetMemoryReport(memoryReport& report);
+
+/* Count count allocations of given bytes: bytes are added to given component, */
+/* headers and padding of the allocator(glibc malloc) to overhead              */
+void addAllocation(size_t bytes, size_t& component, memoryReport& report, size_t count = 1);
+
+/* Count the heap memory of an item: components and long id */
+void addItem(Item& point, memoryReport& report);
+
+/* Sum components in total */
+void sumMemoryReport(memoryReport& report);
+
+/* Print bytes of every component */
+void printMemoryReport(memoryReport& report, std::ostream& out = std::cout);
+
+/* Bytes allocated from the heap by the process(glibc) - A difference measures a model */
+size_t heapBytesInUse(void);
+
+// Petropoulakis Panagiotis
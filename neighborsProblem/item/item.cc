@@ -8,15 +8,14 @@
 using namespace std;
 
 /* Initialize static field */
-int Item::count = 0;
+atomic<int> Item::count(0);
 
 ////////////////////////////////
 /* Constructors - destructors */
 ////////////////////////////////
 
 Item::Item(){
-    this->id = "item_" + to_string(count);
-    this->count += 1;
+    this->id = "item_" + to_string(this->count++);
 
     this->dim = 0;
 }
@@ -43,9 +42,8 @@ Item::Item(int dim, errorCode& status){
     if(dim <= 0 || dim > MAX_DIM)
         status = INVALID_DIM;
     else{ 
-        this->id = "item_" + to_string(count);
+        this->id = "item_" + to_string(this->count++);
 
-        this->count += 1;
         this->components.reserve(dim);
         this->dim = dim;
     }
@@ -74,11 +72,9 @@ Item::Item(vector<double>& components, errorCode& status){
         status = INVALID_DIM;
     else{
        
-        this->id = "item_" + to_string(count);
+        this->id = "item_" + to_string(this->count++);
         this->components = components;
         this->dim = components.size();
-        
-        this->count += 1;
     }
 }
 
@@ -90,6 +86,38 @@ Item::Item(const Item& x){
     this->dim = x.dim;
 }
 
+Item::Item(Item&& x) noexcept{
+
+    /* Move members */
+    this->id = std::move(x.id);
+    this->components = std::move(x.components);   
+    this->dim = x.dim;
+
+    x.dim = 0;
+}
+
+Item& Item::operator=(const Item& x){
+
+    /* Set members */
+    this->id = x.id;
+    this->components = x.components;   
+    this->dim = x.dim;
+
+    return *this;
+}
+
+Item& Item::operator=(Item&& x) noexcept{
+
+    /* Move members */
+    this->id = std::move(x.id);
+    this->components = std::move(x.components);   
+    this->dim = x.dim;
+
+    x.dim = 0;
+
+    return *this;
+}
+
 /* No need to decrease count */
 Item::~Item(){}
 
@@ -175,23 +203,35 @@ double Item::getComponent(int index, errorCode& status){
         return this->components[index];
 }
 
+/* Get all components */
+const vector<double>& Item::getComponents(void){
+    return this->components;
+}
+
 int Item::getDim(void){
     return this->dim;
 }
 
 /* Get total items */
 int Item::getCount(void){
-    return this->count;
+    return count;
 }
 
-unsigned Item::size(void){
-    unsigned result = 0; 
+/* Item and its heap memory */
+size_t Item::size(void){
+    return sizeof(Item) + this->componentsBytes() + this->idBytes();
+}
 
-    result += sizeof(this->id) + this->id.capacity() * sizeof(char);
-    result += sizeof(double) * this->components.capacity();  
-    result += sizeof(this->components);
+size_t Item::componentsBytes(void){
+    return sizeof(double) * this->components.capacity();
+}
 
-    return result;
+/* Ids up to the capacity of an empty string are kept in the item */
+size_t Item::idBytes(void){
+    if(this->id.capacity() <= string().capacity())
+        return 0;
+
+    return (this->id.capacity() + 1) * sizeof(char);
 }
 
 /* Print Item */
@@ -241,25 +281,30 @@ int Item::compare(Item& x, errorCode& status){
 
 /* Calculate inner product of two items */
 double Item::innerProduct(Item& x, errorCode& status){
+    return this->innerProduct(x.components.data(), x.dim, status);
+}
+
+/* Calculate inner product with given components(dim values) */
+double Item::innerProduct(const double* x, int dim, errorCode& status){
     double product = 0, tempMult;
     int i;
 
     status = SUCCESS;
 
     /* Check dimensions */
-    if(this->dim == 0 || x.dim == 0){
+    if(this->dim == 0 || dim == 0){
         status = INVALID_DIM;
         return -1;
     }
 
-    if(this->dim != x.dim){
+    if(this->dim != dim){
         status = INVALID_DIM;
         return -1;
     }
 
     /* Calculate product */
     for(i = 0; i < this->dim; i++){
-        tempMult= myMultDouble(this->components[i], x.components[i],status);
+        tempMult= myMultDouble(this->components[i], x[i],status);
         if(status != SUCCESS)
             return -1;
 
@@ -305,25 +350,30 @@ double Item::norm(errorCode& status){
 //////////////
 
 double Item::euclideanDist(Item& x, errorCode& status){
+    return this->euclideanDist(x.components.data(), x.dim, status);
+}
+
+/* Distance from given components(dim values) */
+double Item::euclideanDist(const double* x, int dim, errorCode& status){
     double dist = 0, newComponent, tempMult;
     int i;
 
     status = SUCCESS;
 
     /* Check dimensions */
-    if(this->dim == 0 || x.dim == 0){
+    if(this->dim == 0 || dim == 0){
         status = INVALID_DIM;
         return -1;
     }
 
-    if(this->dim != x.dim){
+    if(this->dim != dim){
         status = INVALID_DIM;
         return -1;
     }
 
     /* Calculate distance */
     for(i = 0; i < this->dim; i++){
-        newComponent = mySubDouble(this->components[i], x.components[i], status);
+        newComponent = mySubDouble(this->components[i], x[i], status);
         if(status != SUCCESS)
             return -1;
 
@@ -341,25 +391,82 @@ double Item::euclideanDist(Item& x, errorCode& status){
     return dist;
 }
 
+double Item::euclideanDist(Item& x, double bound, errorCode& status){
+    return this->euclideanDist(x.components.data(), x.dim, bound, status);
+}
+
+/* Early abandon: the partial sum is compared with bound^2 once per EARLY_ABANDON_BLOCK  */
+/* dimensions. The limit is rounded up, so an abandoned point is never closer than bound */
+double Item::euclideanDist(const double* x, int dim, double bound, errorCode& status){
+    double dist = 0, newComponent, tempMult, limit;
+    int i, j, last;
+
+    status = SUCCESS;
+
+    /* Check dimensions */
+    if(this->dim == 0 || dim == 0){
+        status = INVALID_DIM;
+        return -1;
+    }
+
+    if(this->dim != dim){
+        status = INVALID_DIM;
+        return -1;
+    }
+
+    limit = nextafter(bound * bound, HUGE_VAL);
+
+    /* Calculate distance */
+    for(i = 0; i < this->dim; i += EARLY_ABANDON_BLOCK){
+        last = (i + EARLY_ABANDON_BLOCK < this->dim) ? i + EARLY_ABANDON_BLOCK : this->dim;
+
+        for(j = i; j < last; j++){
+            newComponent = mySubDouble(this->components[j], x[j], status);
+            if(status != SUCCESS)
+                return -1;
+
+            tempMult= myMultDouble(newComponent, newComponent, status);
+            if(status != SUCCESS)
+                return -1;
+
+            dist = mySumDouble(dist, tempMult, status);
+            if(status != SUCCESS)
+                return -1;
+        } // End for - Block
+
+        /* Far point */
+        if(dist >= limit)
+            return (sqrt(dist) > bound) ? sqrt(dist) : bound;
+    } // End for - Blocks
+
+    return sqrt(dist);
+}
+
 /* dist(x,y) = 1 - cos(x,y) = 1 - (x.y / norm(x) * norm(y)) */
 double Item::cosineDist(Item& x, errorCode& status){
-    double dist = 0, mult;
-    double normX, normY;
+    return this->cosineDist(x.components.data(), x.dim, status);
+}
+
+/* Cosine distance from given components(dim values) */
+double Item::cosineDist(const double* x, int dim, errorCode& status){
+    double dist = 0, mult, tempMult;
+    double normX, normY = 0;
+    int i;
 
     status = SUCCESS;
 
     /* Check dimensions */
-    if(this->dim == 0 || x.dim == 0){
+    if(this->dim == 0 || dim == 0){
         status = INVALID_DIM;
         return -1;
     }
 
-    if(this->dim != x.dim){
+    if(this->dim != dim){
         status = INVALID_DIM;
         return -1;
     }
 
-    dist = this->innerProduct(x, status);
+    dist = this->innerProduct(x, dim, status);
     if(status != SUCCESS)
         return -1;
 
@@ -367,9 +474,18 @@ double Item::cosineDist(Item& x, errorCode& status){
     if(status != SUCCESS)
         return -1;
 
-    normY = x.norm(status);
-    if(status != SUCCESS)
-        return -1;
+    /* Norm of given components */
+    for(i = 0; i < dim; i++){
+        tempMult = myMultDouble(x[i], x[i], status);
+        if(status != SUCCESS)
+            return -1;
+
+        normY = mySumDouble(tempMult, normY, status);
+        if(status != SUCCESS)
+            return -1;
+    } // End for
+
+    normY = sqrt(normY);
 
     mult = myMultDouble(normX, normY, status);
     if(status != SUCCESS)
@@ -383,4 +499,3 @@ double Item::cosineDist(Item& x, errorCode& status){
 
     return dist;
 }
-// PetropoulakisPanagiotis
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <atomic>
 #include "../utils/utils.h"
 
 /* Item class represents a point in data sets */
@@ -10,7 +11,7 @@ class Item{
         std::string id;
         std::vector<double> components;
         int dim; // Dimension
-        static int count;
+        static std::atomic<int> count; // Items can be created by many threads
 
     public:
         Item();
@@ -19,6 +20,10 @@ class Item{
         Item(std::vector<double>& components, errorCode& status);
         Item(std::string id, std::vector<double>& components, errorCode& status);
         Item(const Item& x);
+        Item(Item&& x) noexcept; // Vectors of items grow without copying components
+
+        Item& operator=(const Item& x);
+        Item& operator=(Item&& x) noexcept;
 
         ~Item();
 
@@ -32,18 +37,27 @@ class Item{
         /* Accessors */
         std::string getId(void);
         double getComponent(int index,errorCode&);
+        const std::vector<double>& getComponents(void);
         int getDim(void);
-        int getCount(void);
-        unsigned size(void);
+        static int getCount(void);
+        size_t size(void);
+        size_t componentsBytes(void); // Heap bytes of components
+        size_t idBytes(void); // Heap bytes of id - Short ids are kept in the item
         void print(void);
 
         /* Usefull functions */
         int compare(Item& x, errorCode& status);
         double innerProduct(Item& x, errorCode& status); 
+        double innerProduct(const double* x, int dim, errorCode& status); 
         double norm(errorCode& status);
 
         /* Metrices */
         double euclideanDist(Item& x, errorCode& status);
+        double euclideanDist(const double* x, int dim, errorCode& status);
+        /* Stop when the distance reaches bound - A value >= bound is returned */
+        double euclideanDist(Item& x, double bound, errorCode& status);
+        double euclideanDist(const double* x, int dim, double bound, errorCode& status);
         double cosineDist(Item& x,errorCode& status);
+        double cosineDist(const double* x, int dim, errorCode& status);
 };
 // PetropoulakisPanagiotis
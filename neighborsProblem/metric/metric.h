@@ -0,0 +1,184 @@
+#pragma once
+#include <cmath>
+#include "../utils/utils.h"
+
+/* Metrices as policy types - Search loops are instantiated per metrice, so */
+/* the kernels are inlined and the loops have no branches on the metrice    */
+
+/* Metrices of exhaustive search */
+typedef enum metricType{
+    METRIC_EUCLIDEAN,
+    METRIC_COSINE,
+    METRIC_INNER_PRODUCT
+}metricType;
+
+static inline double squaredDist(const double* x, const double* y, int dim){
+    double dist = 0, diff;
+    int i;
+
+    for(i = 0; i < dim; i++){
+        diff = x[i] - y[i];
+        dist += diff * diff;
+    }
+
+    return dist;
+}
+
+/* Squared distance that stops once the partial sum reaches bound(early abandon) */
+/* Sums are added in the order of squaredDist, so complete sums are equal        */
+static inline double squaredDistBounded(const double* x, const double* y, int dim, double bound){
+    double dist = 0, diff;
+    int i = 0, j;
+
+    for(; i + EARLY_ABANDON_BLOCK <= dim; i += EARLY_ABANDON_BLOCK){
+        for(j = i; j < i + EARLY_ABANDON_BLOCK; j++){
+            diff = x[j] - y[j];
+            dist += diff * diff;
+        }
+
+        if(dist >= bound)
+            return dist;
+    } // End for - Blocks
+
+    for(; i < dim; i++){
+        diff = x[i] - y[i];
+        dist += diff * diff;
+    }
+
+    return dist;
+}
+
+static inline double dotProduct(const double* x, const double* y, int dim){
+    double product = 0;
+    int i;
+
+    for(i = 0; i < dim; i++)
+        product += x[i] * y[i];
+
+    return product;
+}
+
+/* Every policy has:                                                              */
+/* norm(x):                      kept per point and query                         */
+/* distance(x, y, norms):        exact distance                                   */
+/* rank(x.y, norms):             order of distance from a dot product(batches)    */
+/* rankBounded(x, y, norms, b):  exact rank - Stops early at a rank >= b          */
+/* earlyAbandon:                 rankBounded stops early(ranks >= b are partial)  */
+/* distanceOfRank(rank):         distance of an exact rank                        */
+/* rankRadius(r):                rank of a distance equal to r                    */
+/* rankMargin(norms):            rounding of rank against the exact distance      */
+
+/* Norm: squared norm */
+struct euclideanMetric{
+    static const bool earlyAbandon = true;
+
+    static inline double norm(const double* x, int dim){
+        return dotProduct(x, x, dim);
+    }
+
+    static inline double distance(const double* x, const double* y, int dim, double xNorm, double yNorm){
+        return sqrt(squaredDist(x, y, dim));
+    }
+
+    /* Squared distance: |x|^2 + |y|^2 - 2 x.y */
+    static inline double rank(double product, double xNorm, double yNorm){
+        double dist = xNorm + yNorm - 2 * product;
+
+        /* Rounding of close points */
+        return (dist < 0) ? 0 : dist;
+    }
+
+    /* Squared distance - Partial sums only grow */
+    static inline double rankBounded(const double* x, const double* y, int dim, double xNorm, double yNorm, double bound){
+        return squaredDistBounded(x, y, dim, bound);
+    }
+
+    static inline double distanceOfRank(double rank){
+        return sqrt(rank);
+    }
+
+    static inline double rankRadius(double radius){
+        return radius * radius;
+    }
+
+    static inline double rankMargin(double xNorm, double yNorm){
+        return 1e-9 * (xNorm + yNorm);
+    }
+};
+
+/* Norm: norm - Distance of a zero vector is 1 */
+struct cosineMetric{
+    static const bool earlyAbandon = false;
+
+    static inline double norm(const double* x, int dim){
+        return sqrt(dotProduct(x, x, dim));
+    }
+
+    static inline double distance(const double* x, const double* y, int dim, double xNorm, double yNorm){
+        return rank(dotProduct(x, y, dim), xNorm, yNorm);
+    }
+
+    /* 1 - x.y / (|x| |y|) */
+    static inline double rank(double product, double xNorm, double yNorm){
+        double normProduct = xNorm * yNorm;
+
+        if(normProduct == 0)
+            return 1;
+
+        return 1 - product / normProduct;
+    }
+
+    /* Partial products have no bound */
+    static inline double rankBounded(const double* x, const double* y, int dim, double xNorm, double yNorm, double bound){
+        return distance(x, y, dim, xNorm, yNorm);
+    }
+
+    static inline double distanceOfRank(double rank){
+        return rank;
+    }
+
+    static inline double rankRadius(double radius){
+        return radius;
+    }
+
+    static inline double rankMargin(double xNorm, double yNorm){
+        return 1e-9;
+    }
+};
+
+/* Norm: squared norm(margin of rounding) - Distance: -x.y(maximum inner product) */
+struct innerProductMetric{
+    static const bool earlyAbandon = false;
+
+    static inline double norm(const double* x, int dim){
+        return dotProduct(x, x, dim);
+    }
+
+    static inline double distance(const double* x, const double* y, int dim, double xNorm, double yNorm){
+        return -dotProduct(x, y, dim);
+    }
+
+    static inline double rank(double product, double xNorm, double yNorm){
+        return -product;
+    }
+
+    /* Partial products have no bound */
+    static inline double rankBounded(const double* x, const double* y, int dim, double xNorm, double yNorm, double bound){
+        return distance(x, y, dim, xNorm, yNorm);
+    }
+
+    static inline double distanceOfRank(double rank){
+        return rank;
+    }
+
+    static inline double rankRadius(double radius){
+        return radius;
+    }
+
+    /* |x.y| <= (|x|^2 + |y|^2) / 2 */
+    static inline double rankMargin(double xNorm, double yNorm){
+        return 1e-9 * (xNorm + yNorm);
+    }
+};
+
+// Petropoulakis Panagiotis
@@ -2,10 +2,18 @@
 #include <vector>
 #include <list>
 #include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "exhaustiveSearch.h"
+#include "../../indexFile/indexFile.h"
 #include "../../hashFunction/hashFunction.h"
 #include "../../item/item.h"
 #include "../../utils/utils.h"
+#include "../../trace/trace.h"
+#include "../../metric/metric.h"
 
 using namespace std;
 
@@ -13,18 +21,41 @@ using namespace std;
 /* Implementation of exhaustive search */
 /////////////////////////////////////////
 
+/* Single queries are split in ranges of points scanned by workers - Small */
+/* tables are scanned by one thread, as waking the workers costs more      */
+#define MIN_POINTS_PER_THREAD 32768
+
 /* Default constructor */
-exhaustiveSearch::exhaustiveSearch(string metrice):tableSize(0),n(0),dim(0),fitted(0),metrice(metrice){}
+exhaustiveSearch::exhaustiveSearch(string metrice):tableSize(0),n(0),dim(0),fitted(0),ranges(1),metrice(metrice),metric(METRIC_EUCLIDEAN),jobNumber(0),jobPending(0),stopping(0){}
+
+/* Stop workers */
+exhaustiveSearch::~exhaustiveSearch(){
+    int i;
+
+    {
+        lock_guard<mutex> lock(this->jobLock);
+        this->stopping = 1;
+    }
+    this->jobReady.notify_all();
 
-exhaustiveSearch::~exhaustiveSearch(){}
+    for(i = 0; i < (int)this->workers.size(); i++)
+        this->workers[i].join();
+}
 
 /* Save given points */
 void exhaustiveSearch::fit(list<Item>& points, errorCode& status){
-    
-    /* Iteratiors */
-    list<Item>::iterator iterPoints = points.begin(); // Iterate through points
-   
+    listStream stream(points);
+
+    this->points.reserve(points.size());
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are appended in place - No intermediate list */
+void exhaustiveSearch::fit(itemStream& points, errorCode& status){
+
     status = SUCCESS;
+    TRACE_SCOPE("exhaustive search fit");
 
     /* Already fitted */
     if(this->fitted == 1){
@@ -32,43 +63,153 @@ void exhaustiveSearch::fit(list<Item>& points, errorCode& status){
         return;
     }
 
-    /* Check metrice */
-    if(this->metrice != "euclidean" && this->metrice != "cosine"){
+    /* Resolve metrice - Search loops never compare strings */
+    if(this->metrice == "euclidean")
+        this->metric = METRIC_EUCLIDEAN;
+    else if(this->metrice == "cosine")
+        this->metric = METRIC_COSINE;
+    else if(this->metrice == "inner")
+        this->metric = METRIC_INNER_PRODUCT;
+    else{
         status = INVALID_METRICE;
         return;
     }
 
-    /* Check parameters */
-    this->points.reserve(points.size());
+    /* Copy points */
+    points.forEach([&](Item& point, errorCode& status){
+
+        /* Dimension of first point */
+        if(this->points.size() == 0)
+            this->dim = point.getDim();
+
+        if(this->dim != point.getDim() || (int)this->points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        this->points.push_back(point);
+    }, status);
 
     /* Set members */
-    this->n = points.size();
-    if(this->n < MIN_POINTS || this->n > MAX_POINTS){
+    this->n = this->points.size();
+    if(status == SUCCESS && (this->n < MIN_POINTS || this->n > MAX_POINTS))
         status = INVALID_POINTS;
+
+    if(status != SUCCESS){
+        this->points.clear();
+        this->points.shrink_to_fit();
         return;
     }
 
-    this->dim = iterPoints->getDim();
- 
+    /* Release spare capacity of growth - Items are moved */
+    this->points.shrink_to_fit();
+
     this->tableSize = this->n;
-    /* Copy points */
-    for(iterPoints = points.begin(); iterPoints != points.end(); iterPoints++){
 
-        if(this->dim != iterPoints->getDim()){
-            status = INVALID_POINTS;
-            return;
-        }
+    /* Ranges of points of single queries - One per thread */
+    this->ranges = thread::hardware_concurrency();
+    if(this->ranges > this->n / MIN_POINTS_PER_THREAD)
+        this->ranges = this->n / MIN_POINTS_PER_THREAD;
+    if(this->ranges <= 0)
+        this->ranges = 1;
 
-        this->points.push_back(*iterPoints);
-    } // End for
+    /* Workers are reused by every query - Range 0 is scanned by the caller */
+    this->workers.reserve(this->ranges - 1);
+    for(int i = 1; i < this->ranges; i++)
+        this->workers.push_back(thread(&exhaustiveSearch::worker, this, i));
+
+    /* Norms of metrice */
+    this->norms.resize(this->n);
+    for(int i = 0; i < this->n; i++)
+        this->norms[i] = this->norm(this->points[i].getComponents().data());
 
     this->fitted = 1;
 }
 
+/* Call given function with the policy of the metrice - Loops are instantiated per metrice */
+template <typename function>
+void exhaustiveSearch::withMetric(function call){
+    switch(this->metric){
+        case METRIC_EUCLIDEAN:
+            call(euclideanMetric());
+            break;
+        case METRIC_COSINE:
+            call(cosineMetric());
+            break;
+        case METRIC_INNER_PRODUCT:
+            call(innerProductMetric());
+            break;
+    } // End switch
+}
+
+/* Wait for jobs and scan range of worker - Every job is run once */
+void exhaustiveSearch::worker(int range){
+    uint64_t lastJob = 0;
+    int first = (int)((long)range * this->tableSize / this->ranges);
+    int last = (int)((long)(range + 1) * this->tableSize / this->ranges);
+    unique_lock<mutex> lock(this->jobLock);
+
+    while(1){
+        this->jobReady.wait(lock, [&](){ return this->stopping || this->jobNumber != lastJob; });
+        if(this->stopping)
+            return;
+
+        lastJob = this->jobNumber;
+
+        lock.unlock();
+        this->job(range, first, last);
+        lock.lock();
+
+        /* Last worker wakes the caller */
+        this->jobPending -= 1;
+        if(this->jobPending == 0)
+            this->jobDone.notify_one();
+    } // End while
+}
+
+/* Call work(range, first, last) for every range of points - Ranges are scanned */
+/* in parallel by the workers and range 0 is scanned by the calling thread      */
+template <typename function>
+void exhaustiveSearch::forRanges(function work){
+
+    /* Single range - No workers */
+    if(this->ranges == 1){
+        work(0, 0, this->tableSize);
+        return;
+    }
+
+    lock_guard<mutex> scan(this->scanLock);
+
+    {
+        lock_guard<mutex> lock(this->jobLock);
+        this->job = work;
+        this->jobPending = this->ranges - 1;
+        this->jobNumber += 1;
+    }
+    this->jobReady.notify_all();
+
+    work(0, 0, (int)((long)this->tableSize / this->ranges));
+
+    /* Wait for workers */
+    unique_lock<mutex> lock(this->jobLock);
+    this->jobDone.wait(lock, [&](){ return this->jobPending == 0; });
+}
+
+/* Norm of given components - Depends on metrice */
+double exhaustiveSearch::norm(const double* x){
+    double result = 0;
+
+    this->withMetric([&](auto policy){
+        result = decltype(policy)::norm(x, this->dim);
+    });
+
+    return result;
+}
+
 /* Find the radius neighbors of a given point */
 void exhaustiveSearch::radiusNeighbors(Item& query, int radius, list<Item>& neighbors, list<double>* neighborsDistances, errorCode& status){
-    int i;
-    double currDist; // Distance of a point in list
+    const double* queryData;
+    double queryNorm;
 
     status = SUCCESS;
 
@@ -84,37 +225,82 @@ void exhaustiveSearch::radiusNeighbors(Item& query, int radius, list<Item>& neig
         return;
     }
 
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
     /* Clear given lists */
     neighbors.clear();
     if(neighborsDistances != NULL)
         neighborsDistances->clear();
 
-    /* Scann all points */
-    for(i = 0; i < this->tableSize; i++){
-        /* Find current distance */
-
-        if(this->metrice == "euclidean")
-            currDist = this->points[i].euclideanDist(query, status);
-        else 
-            currDist = this->points[i].cosineDist(query, status);
-
-        if(status != SUCCESS)
-            return;
-
-        /* Keep neighbor */
-        if(currDist < radius){
-            neighbors.push_back(this->points[i]);
+    TRACE_SCOPE("exhaustive search radiusNeighbors");
+    STATS_RESET(this->lastStats);
+    STATS_START(scanTimer);
+    TRACE_BEGIN(scanRegion, "exhaustive search scan");
+
+    queryData = query.getComponents().data();
+    queryNorm = this->norm(queryData);
+
+    /* Scann all points - Every range keeps its neighbors in order and its counters */
+    vector<vector<int> > rangeNeighbors(this->ranges);
+    vector<vector<double> > rangeDistances(this->ranges);
+    vector<queryStats> rangeStats(this->ranges);
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        double rankRadius = metricPolicy::rankRadius(radius);
+
+        this->forRanges([&](int range, int first, int last){
+            double currRank, currDist; // Rank and distance of a point in list
+            int i;
+
+            for(i = first; i < last; i++){
+                /* Far points are abandoned early */
+                currRank = metricPolicy::rankBounded(this->points[i].getComponents().data(), queryData, this->dim, this->norms[i], queryNorm, rankRadius);
+                currDist = metricPolicy::distanceOfRank(currRank);
+
+                /* Keep neighbor */
+                if(currDist < radius){
+                    rangeNeighbors[range].push_back(i);
+                    rangeDistances[range].push_back(currDist);
+                }
+                else if(metricPolicy::earlyAbandon && currRank >= rankRadius)
+                    STATS_ADD(rangeStats[range], distancesAbandoned, 1);
+            } // End for
+        });
+    });
+
+    /* Join ranges in order of points */
+    for(int range = 0; range < this->ranges; range++){
+        for(int i = 0; i < (int)rangeNeighbors[range].size(); i++){
+            neighbors.push_back(this->points[rangeNeighbors[range][i]]);
             if(neighborsDistances != NULL)
-                neighborsDistances->push_back(currDist);
-        }
+                neighborsDistances->push_back(rangeDistances[range][i]);
+        } // End for
     } // End for
+
+    /* Single table - Every point is a candidate and a distance is started for every */
+    /* point. Ranges count distances that were abandoned at the bound                */
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    TRACE_END(scanRegion);
+    STATS_ADD(this->lastStats, tablesProbed, 1);
+    STATS_ADD(this->lastStats, bucketsVisited, 1);
+    STATS_ADD(this->lastStats, candidatesScanned, this->tableSize);
+    STATS_ADD(this->lastStats, distanceComputations, this->tableSize);
+    for(int range = 0; range < this->ranges; range++)
+        STATS_ADD(this->lastStats, distancesAbandoned, rangeStats[range].distancesAbandoned);
+    STATS_RECORD(this->stats, this->lastStats);
 }
 
 /* Find the nearest neighbor of a given point */
 void exhaustiveSearch::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status){
-    int i, posMin = 0;
+    int posMin = 0;
     double minDist = -1; // Current minimum distance 
-    double currDist; // Distance of a point in list
+    const double* queryData;
+    double queryNorm;
 
     status = SUCCESS;
 
@@ -124,27 +310,71 @@ void exhaustiveSearch::nNeighbor(Item& query, Item& nNeighbor, double* neighborD
         return;
     }
 
-    /* Scann all points */
-    for(i = 0; i < this->tableSize; i++){
-        
-        /* Get current distance from query */
-        if(this->metrice == "euclidean")
-            currDist = this->points[i].euclideanDist(query, status);
-        else 
-            currDist = this->points[i].cosineDist(query, status);
-        if(status != SUCCESS)
-            return;
-    
-        if(i == 0){
-            posMin = i;
-            minDist = currDist;
-        }
-        else if(minDist > currDist){
-            posMin = i;
-            minDist = currDist;
-            
-        }
-    } // End for
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    TRACE_SCOPE("exhaustive search nNeighbor");
+    STATS_RESET(this->lastStats);
+    STATS_START(scanTimer);
+    TRACE_BEGIN(scanRegion, "exhaustive search scan");
+
+    queryData = query.getComponents().data();
+    queryNorm = this->norm(queryData);
+
+    /* Scann all points - Every range keeps its nearest point and its counters */
+    vector<int> rangeMin(this->ranges);
+    vector<double> rangeRank(this->ranges);
+    vector<queryStats> rangeStats(this->ranges);
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        this->forRanges([&](int range, int first, int last){
+            double currRank; // Rank of a point in list
+            int i;
+
+            rangeMin[range] = first;
+            rangeRank[range] = metricPolicy::rankBounded(this->points[first].getComponents().data(), queryData, this->dim, this->norms[first], queryNorm, HUGE_VAL);
+
+            /* Points farther than the nearest are abandoned early */
+            for(i = first + 1; i < last; i++){
+                currRank = metricPolicy::rankBounded(this->points[i].getComponents().data(), queryData, this->dim, this->norms[i], queryNorm, rangeRank[range]);
+
+                if(rangeRank[range] > currRank){
+                    rangeMin[range] = i;
+                    rangeRank[range] = currRank;
+                }
+                else if(metricPolicy::earlyAbandon)
+                    STATS_ADD(rangeStats[range], distancesAbandoned, 1);
+            } // End for
+        });
+
+        /* First minimum in order of points */
+        posMin = rangeMin[0];
+        minDist = rangeRank[0];
+        for(int range = 1; range < this->ranges; range++){
+            if(minDist > rangeRank[range]){
+                posMin = rangeMin[range];
+                minDist = rangeRank[range];
+            }
+        } // End for
+
+        minDist = metricPolicy::distanceOfRank(minDist);
+    });
+
+    /* Single table - Every point is a candidate and a distance is started for every */
+    /* point. Ranges count distances that were abandoned at the bound                */
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    TRACE_END(scanRegion);
+    STATS_ADD(this->lastStats, tablesProbed, 1);
+    STATS_ADD(this->lastStats, bucketsVisited, 1);
+    STATS_ADD(this->lastStats, candidatesScanned, this->tableSize);
+    STATS_ADD(this->lastStats, distanceComputations, this->tableSize);
+    for(int range = 0; range < this->ranges; range++)
+        STATS_ADD(this->lastStats, distancesAbandoned, rangeStats[range].distancesAbandoned);
+    STATS_RECORD(this->stats, this->lastStats);
 
     /* Set nearest neighbor */
     nNeighbor = this->points[posMin];
@@ -152,6 +382,202 @@ void exhaustiveSearch::nNeighbor(Item& query, Item& nNeighbor, double* neighborD
         *neighborDistance = minDist;
 }
 
+////////////////////////
+/* Batches of queries */
+////////////////////////
+
+/* Queries of a block share the points of a block while they are in cache(L2) */
+#define QUERY_BLOCK 64
+#define POINT_BLOCK_BYTES (1 << 17)
+
+/* Components and norms of a batch of queries */
+void exhaustiveSearch::prepareQueries(list<Item>& queries, vector<const double*>& queriesData, vector<double>& queriesNorm, errorCode& status){
+
+    status = SUCCESS;
+
+    queriesData.clear();
+    queriesNorm.clear();
+    queriesData.reserve(queries.size());
+    queriesNorm.reserve(queries.size());
+
+    for(list<Item>::iterator iter = queries.begin(); iter != queries.end(); iter++){
+        if(iter->getDim() != this->dim){
+            status = INVALID_DIM;
+            return;
+        }
+
+        queriesData.push_back(iter->getComponents().data());
+        queriesNorm.push_back(this->norm(queriesData.back()));
+    } // End for
+}
+
+/* Visit every pair of query and point with the rank of the metrice(dot product identity) */
+/* Tiles of DOT_TILE queries load a point once                                           */
+template <typename metricPolicy, typename visitor>
+void exhaustiveSearch::scanBlocks(vector<const double*>& queriesData, vector<double>& queriesNorm, visitor visit){
+    int queryBlock, pointBlock, tile, p, t, tileSize;
+    int blockPoints = POINT_BLOCK_BYTES / (this->dim * (int)sizeof(double));
+    int numQueries = queriesData.size();
+    const double* tileData[DOT_TILE];
+    double products[DOT_TILE];
+
+    if(blockPoints < 1)
+        blockPoints = 1;
+
+    for(queryBlock = 0; queryBlock < numQueries; queryBlock += QUERY_BLOCK){
+        int queryEnd = min(queryBlock + QUERY_BLOCK, numQueries);
+
+        for(pointBlock = 0; pointBlock < this->tableSize; pointBlock += blockPoints){
+            int pointEnd = min(pointBlock + blockPoints, this->tableSize);
+
+            for(tile = queryBlock; tile < queryEnd; tile += DOT_TILE){
+                tileSize = min(DOT_TILE, queryEnd - tile);
+
+                /* Last tile repeats its last query */
+                for(t = 0; t < DOT_TILE; t++)
+                    tileData[t] = queriesData[tile + min(t, tileSize - 1)];
+
+                for(p = pointBlock; p < pointEnd; p++){
+                    dotProducts(this->points[p].getComponents().data(), tileData, this->dim, products);
+
+                    for(t = 0; t < tileSize; t++)
+                        visit(tile + t, p, metricPolicy::rank(products[t], this->norms[p], queriesNorm[tile + t]));
+                } // End for - Points
+            } // End for - Tiles
+        } // End for - Blocks of points
+    } // End for - Blocks of queries
+}
+
+/* Radius neighbors of every query - Candidates of the dot product identity are checked with the exact distance */
+void exhaustiveSearch::radiusNeighbors(list<Item>& queries, int radius, vector<list<Item> >& neighbors, vector<list<double> >* neighborsDistances, errorCode& status){
+    vector<const double*> queriesData;
+    vector<double> queriesNorm;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(radius < MIN_RADIUS || radius > MAX_RADIUS){
+        status = INVALID_RADIUS;
+        return; 
+    }
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    prepareQueries(queries, queriesData, queriesNorm, status);
+    if(status != SUCCESS)
+        return;
+
+    TRACE_SCOPE("exhaustive search radiusNeighbors batch");
+
+    neighbors.assign(queries.size(), list<Item>());
+    if(neighborsDistances != NULL)
+        neighborsDistances->assign(queries.size(), list<double>());
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+        vector<vector<int> > candidates(queries.size()); // Points of every query in order
+        double rankRadius = metricPolicy::rankRadius(radius), currDist;
+        int q;
+
+        /* Keep neighbors with a margin for rounding of the identity */
+        this->scanBlocks<metricPolicy>(queriesData, queriesNorm, [&](int q, int p, double rank){
+            if(rank <= rankRadius + metricPolicy::rankMargin(this->norms[p], queriesNorm[q]))
+                candidates[q].push_back(p);
+        });
+
+        /* Exact distance of candidates */
+        for(q = 0; q < (int)queriesData.size(); q++){
+            for(int p : candidates[q]){
+                currDist = metricPolicy::distance(this->points[p].getComponents().data(), queriesData[q], this->dim, this->norms[p], queriesNorm[q]);
+
+                if(currDist < radius){
+                    neighbors[q].push_back(this->points[p]);
+                    if(neighborsDistances != NULL)
+                        (*neighborsDistances)[q].push_back(currDist);
+                }
+            } // End for - Candidates
+        } // End for - Queries
+    });
+}
+
+/* Nearest neighbor of every query - Ranks of the dot product identity are rounded, so every */
+/* point that may be nearer than the best upper bound(rank + margin) is checked exactly     */
+void exhaustiveSearch::nNeighbors(list<Item>& queries, vector<Item>& neighbors, vector<double>* neighborsDistances, errorCode& status){
+    vector<const double*> queriesData;
+    vector<double> queriesNorm;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    prepareQueries(queries, queriesData, queriesNorm, status);
+    if(status != SUCCESS)
+        return;
+
+    TRACE_SCOPE("exhaustive search nNeighbors batch");
+
+    neighbors.resize(queries.size());
+    if(neighborsDistances != NULL)
+        neighborsDistances->resize(queries.size());
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+        vector<vector<pair<double, int> > > candidates(queries.size()); // Lower bound of rank and point in order of points
+        vector<int> pruned(queries.size(), 0); // Candidates after the last prune
+        vector<double> minUpper(queries.size(), HUGE_VAL); // Best upper bound of a rank
+        double currRank, minRank;
+        int q, posMin;
+
+        this->scanBlocks<metricPolicy>(queriesData, queriesNorm, [&](int q, int p, double rank){
+            double margin = metricPolicy::rankMargin(this->norms[p], queriesNorm[q]);
+            vector<pair<double, int> >& curr = candidates[q];
+
+            if(rank - margin > minUpper[q])
+                return;
+
+            curr.push_back(make_pair(rank - margin, p));
+            if(rank + margin < minUpper[q])
+                minUpper[q] = rank + margin;
+
+            /* Drop candidates of older bounds - Lists stay linear in the survivors */
+            if((int)curr.size() >= 2 * pruned[q] + 64){
+                curr.erase(remove_if(curr.begin(), curr.end(), [&](const pair<double, int>& candidate){
+                    return candidate.first > minUpper[q];
+                }), curr.end());
+                pruned[q] = curr.size();
+            }
+        });
+
+        /* First exact minimum in order of points as single queries */
+        for(q = 0; q < (int)queriesData.size(); q++){
+            posMin = -1;
+            minRank = 0;
+
+            for(auto& candidate : candidates[q]){
+                if(candidate.first > minUpper[q])
+                    continue;
+
+                currRank = metricPolicy::rankBounded(this->points[candidate.second].getComponents().data(), queriesData[q], this->dim, this->norms[candidate.second], queriesNorm[q], HUGE_VAL);
+                if(posMin == -1 || minRank > currRank){
+                    posMin = candidate.second;
+                    minRank = currRank;
+                }
+            } // End for - Candidates
+
+            neighbors[q] = this->points[posMin];
+            if(neighborsDistances != NULL)
+                (*neighborsDistances)[q] = metricPolicy::distanceOfRank(minRank);
+        } // End for
+    });
+}
 
 ///////////////
 /* Accessors */
@@ -179,26 +605,78 @@ int exhaustiveSearch::getDim(errorCode& status){
         return this->dim;
 }
 
-unsigned exhaustiveSearch::size(void){
-    unsigned result = 0;
-
-    if(this->fitted == 0)
-        return -1;
-    
-    result += sizeof(this->tableSize);
-    result += sizeof(this->n);
-    result += sizeof(this->dim);
-    result += sizeof(this->fitted);
-    result += sizeof(this->metrice);
-    
+/* Bytes of points - Every allocation is counted */
+void exhaustiveSearch::getMemoryReport(memoryReport& report, errorCode& status){
     int i;
 
+    status = SUCCESS;
+
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
+
+    addAllocation(this->points.capacity() * sizeof(Item), report.points, report);
     for(i = 0; i < this->tableSize; i++)
-        result += this->points[i].size();
+        addItem(this->points[i], report);
 
-    result += this->points.capacity() * sizeof(Item);
-        
-    return result;
+    addAllocation(this->norms.capacity() * sizeof(double), report.points, report);
+
+    sumMemoryReport(report);
+}
+
+/* Save points in a binary index file */
+void exhaustiveSearch::save(string fileName, errorCode& status){
+    ofstream file;
+    indexHeader header;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    /* Index files keep euclidean and cosine points */
+    if(this->metric == METRIC_INNER_PRODUCT){
+        status = METHOD_NOT_IMPLEMENTED;
+        return;
+    }
+
+    file.open(fileName, ios::binary | ios::trunc);
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    /* Set header */
+    initIndexHeader(header);
+    header.type = INDEX_EXHAUSTIVE;
+    header.metrice = (this->metric == METRIC_EUCLIDEAN) ? INDEX_EUCLIDEAN : INDEX_COSINE;
+    header.n = this->n;
+    header.dim = this->dim;
+
+    writeIndexHeader(file, header, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Write points */
+    writeIndexPoints(file, this->points, header, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Fix offsets */
+    header.fileSize = file.tellp();
+    writeIndexHeader(file, header, status);
+}
+
+/* Exhaustive search hasn't buckets */
+void exhaustiveSearch::getIndexStats(indexStats& stats, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
 }
 
 /* Print statistics */
@@ -1,32 +1,80 @@
 #pragma once
 #include <vector>
 #include <list>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <stdint.h>
 #include "../model.h"
 #include "../../item/item.h"
 #include "../../utils/utils.h"
+#include "../../metric/metric.h"
 
-/* Neighbors problem using exhaustice search */
+/* Neighbors problem using exhaustice search - Metrices: euclidean, cosine, inner */
 class exhaustiveSearch: public model{
     private:
         std::vector<Item> points; // All points are been kept in a single table
+        std::vector<double> norms; // Norms of points(metric.h) - Squared norms for euclidean
         int tableSize; // == n
         int n; // Number of items 
         int dim; // Dimension
         int fitted; // Method is fitted with data
-        std::string metrice; 
+        int ranges; // Ranges of points scanned in parallel by single queries
+        std::string metrice; // euclidean, cosine or inner(inner product)
+        metricType metric; // Resolved at fit
+
+        /* Workers of ranges 1..ranges-1 - Started by fit, stopped by destructor */
+        std::vector<std::thread> workers;
+        std::mutex scanLock; // One query uses the workers at a time - Concurrent queries wait
+        std::mutex jobLock; // Members of current job
+        std::condition_variable jobReady, jobDone;
+        std::function<void(int, int, int)> job; // work(range, first, last) of current query
+        uint64_t jobNumber; // Changed by every job
+        int jobPending; // Workers that haven't finished current job
+        int stopping; // Destructor stops the workers
+
+        /* Wait for jobs and scan given range of them */
+        void worker(int range);
+
+        /* Call given function with the policy type of the metrice(euclideanMetric, etc) */
+        template <typename function>
+        void withMetric(function call);
+
+        /* Call given function for every range of points in parallel(workers) */
+        template <typename function>
+        void forRanges(function work);
+
+        /* Norm of given components(dim values) for the metrice */
+        double norm(const double* x);
+
+        /* Components and norms of a batch of queries */
+        void prepareQueries(std::list<Item>& queries, std::vector<const double*>& queriesData, std::vector<double>& queriesNorm, errorCode& status);
+
+        /* Visit every pair of query and point with the rank of the metrice - Blocks of points are reused by blocks of queries */
+        template <typename metricPolicy, typename visitor>
+        void scanBlocks(std::vector<const double*>& queriesData, std::vector<double>& queriesNorm, visitor visit);
     public:
 
         exhaustiveSearch(std::string="euclidean");
         ~exhaustiveSearch();
 
         void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
 
         void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
         void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+
+        /* Batches of queries - Neighbors of query-i are kept in position i */
+        void radiusNeighbors(std::list<Item>& queries, int radius, std::vector<std::list<Item> >& neighbors, std::vector<std::list<double> >* neighborsDistances, errorCode& status);
+        void nNeighbors(std::list<Item>& queries, std::vector<Item>& neighbors, std::vector<double>* neighborsDistances, errorCode& status);
         
         int getNumberOfPoints(errorCode& status);
         int getDim(errorCode& status);
-        unsigned size(void);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
 
         void print(void);
         void printHashFunctions(void);
@@ -0,0 +1,908 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <climits>
+#include <cmath>
+#include "hnsw.h"
+#include "../../indexStats/indexStats.h"
+#include "../../trace/trace.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+#include "../../metric/metric.h"
+
+using namespace std;
+
+//////////////////////////////////
+/* Implementation of hnsw class */
+//////////////////////////////////
+
+/* Points are inserted by a pool of threads - Small tables are inserted by one thread */
+#define MIN_POINTS_PER_THREAD 1000
+
+/* Batches of inserted points double with the graph up to this fraction of the points */
+#define MAX_BATCH_FRACTION 0.02
+
+/* Work of a batch is split among threads in chunks of this many nodes at least */
+#define MIN_NODES_PER_THREAD 64
+
+/* Default constructor */
+hnsw::hnsw(string metrice):entryPoint(-1),maxLevel(-1),degree(16),maxDegree0(32),efConstruction(200),efSearch(64),n(0),dim(0),fitted(0),metrice(metrice),metric(METRIC_EUCLIDEAN){}
+
+hnsw::hnsw(int degree, int efConstruction, int efSearch, string metrice, errorCode& status):entryPoint(-1),maxLevel(-1),degree(degree),maxDegree0(2 * degree),efConstruction(efConstruction),efSearch(efSearch),n(0),dim(0),fitted(0),metrice(metrice),metric(METRIC_EUCLIDEAN){
+
+    /* Check parameters */
+    if(degree < MIN_DEGREE || degree > MAX_DEGREE || efConstruction < MIN_EF || efConstruction > MAX_EF || efSearch < MIN_EF || efSearch > MAX_EF){
+        status = INVALID_PARAMETERS;
+        this->degree = -1;
+    }
+}
+
+hnsw::~hnsw(){
+    int i;
+
+    /* Delete marks of queries */
+    for(i = 0; i < (int)this->freeMarks.size(); i++)
+        delete this->freeMarks[i];
+}
+
+/* Call work(index, thread) for indexes 0..count-1 with given threads at most - */
+/* Results must not depend on the thread of an index                            */
+static void forNodes(int count, int threads, function<void(int, int)> work){
+    int i;
+    atomic<int> next(0);
+    vector<thread> pool;
+
+    if(threads > (count + MIN_NODES_PER_THREAD - 1) / MIN_NODES_PER_THREAD)
+        threads = (count + MIN_NODES_PER_THREAD - 1) / MIN_NODES_PER_THREAD;
+
+    auto run = [&](int thread){
+        int index;
+
+        while((index = next++) < count)
+            work(index, thread);
+    };
+
+    for(i = 1; i < threads; i++)
+        pool.push_back(thread(run, i));
+
+    run(0);
+
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+}
+
+/* Save given points and build the graph */
+void hnsw::fit(list<Item>& points, errorCode& status){
+    listStream stream(points);
+
+    this->points.reserve(points.size());
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are appended in place - Graph is built after the last point */
+void hnsw::fit(itemStream& points, errorCode& status){
+    int i, threads, maxBatch;
+    double levelMult;
+
+    status = SUCCESS;
+    TRACE_SCOPE("hnsw fit");
+
+    /* Check method */
+    if(this->degree == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Already fitted */
+    if(this->fitted == 1){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    /* Resolve metrice - Search loops never compare strings */
+    if(this->metrice == "euclidean")
+        this->metric = METRIC_EUCLIDEAN;
+    else if(this->metrice == "cosine")
+        this->metric = METRIC_COSINE;
+    else{
+        status = INVALID_METRICE;
+        return;
+    }
+
+    /* Copy points */
+    points.forEach([&](Item& point, errorCode& status){
+
+        /* Dimension of first point */
+        if(this->points.size() == 0)
+            this->dim = point.getDim();
+
+        if(this->dim != point.getDim() || (int)this->points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        this->points.push_back(point);
+    }, status);
+
+    /* Set members */
+    this->n = this->points.size();
+    if(status == SUCCESS && (this->n < MIN_POINTS || this->n > MAX_POINTS))
+        status = INVALID_POINTS;
+
+    if(status != SUCCESS){
+        this->points.clear();
+        this->points.shrink_to_fit();
+        return;
+    }
+
+    /* Release spare capacity of growth - Items are moved */
+    this->points.shrink_to_fit();
+
+    /* Norms of metrice */
+    this->norms.resize(this->n);
+    this->withMetric([&](auto policy){
+        for(i = 0; i < this->n; i++)
+            this->norms[i] = decltype(policy)::norm(this->points[i].getComponents().data(), this->dim);
+    });
+
+    ////////////////
+    /* Set layers */
+    ////////////////
+
+    /* Top layer of a node: floor(-ln(u) / ln(M)), u uniform in (0, 1] */
+    levelMult = 1 / log((double)this->degree);
+    this->levels.resize(this->n);
+    this->upperLinks.resize(this->n);
+
+    for(i = 0; i < this->n; i++){
+        this->levels[i] = (int)(-log(1 - this->generator.uniform()) * levelMult);
+        this->upperLinks[i].assign(this->levels[i] * (this->degree + 1), 0);
+    } // End for
+
+    this->links.assign((size_t)this->n * (this->maxDegree0 + 1), 0);
+
+    ///////////////////
+    /* Insert points */
+    ///////////////////
+
+    TRACE_BEGIN(insertRegion, "hnsw insert");
+
+    /* First point is the entry point */
+    this->entryPoint = 0;
+    this->maxLevel = this->levels[0];
+
+    threads = thread::hardware_concurrency();
+    if(threads > this->n / MIN_POINTS_PER_THREAD)
+        threads = this->n / MIN_POINTS_PER_THREAD;
+    if(threads <= 0)
+        threads = 1;
+
+    /* Marks of every thread */
+    vector<visitedMarks> marks(threads);
+    for(visitedMarks& threadMarks : marks){
+        threadMarks.marks.assign(this->n, 0);
+        threadMarks.curr = 0;
+    }
+
+    maxBatch = max(1, (int)(this->n * MAX_BATCH_FRACTION));
+
+    /* Points are inserted in batches: nodes of a batch search the graph of previous */
+    /* batches in parallel, then every node of the graph is linked back with its new */
+    /* neighbors in order of rank. Threads only read the graph or change their own   */
+    /* nodes, so the graph depends on the seed and points, not on the threads        */
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        int first, last, group;
+        vector<vector<vector<rankedNode> > > found; // Neighbors of every layer of batch nodes
+        vector<pair<pair<int, int>, rankedNode> > backLinks; // Layer and node of the graph, rank and node of batch
+        vector<int> groups; // First back link of every node of the graph
+
+        for(first = 1; first < this->n; first = last){
+            last = first + min(first, maxBatch);
+            if(last > this->n)
+                last = this->n;
+
+            found.assign(last - first, vector<vector<rankedNode> >());
+
+            forNodes(last - first, threads, [&](int node, int thread){
+                this->insert<metricPolicy>(first + node, marks[thread], found[node]);
+            });
+
+            /* Back links grouped by node of the graph */
+            backLinks.clear();
+            for(i = 0; i < last - first; i++)
+                for(int layer = 0; layer < (int)found[i].size(); layer++)
+                    for(rankedNode& neighbor : found[i][layer])
+                        backLinks.push_back(make_pair(make_pair(layer, neighbor.second), rankedNode(neighbor.first, first + i)));
+
+            sort(backLinks.begin(), backLinks.end());
+
+            groups.clear();
+            for(i = 0; i < (int)backLinks.size(); i++)
+                if(i == 0 || backLinks[i].first != backLinks[i - 1].first)
+                    groups.push_back(i);
+            group = groups.size();
+            groups.push_back(backLinks.size());
+
+            forNodes(group, threads, [&](int index, int thread){
+                vector<rankedNode> added;
+
+                for(int j = groups[index]; j < groups[index + 1]; j++)
+                    added.push_back(backLinks[j].second);
+
+                this->linkBack<metricPolicy>(backLinks[groups[index]].first.second, backLinks[groups[index]].first.first, added);
+            });
+
+            /* New top layer - First node of the highest level */
+            for(i = first; i < last; i++){
+                if(this->levels[i] > this->maxLevel){
+                    this->entryPoint = i;
+                    this->maxLevel = this->levels[i];
+                }
+            } // End for
+        } // End for - Batches
+    });
+
+    TRACE_END(insertRegion);
+
+    /* Method fitted */
+    this->fitted = 1;
+}
+
+/* Call given function with the policy of the metrice - Loops are instantiated per metrice */
+template <typename function>
+void hnsw::withMetric(function call){
+    switch(this->metric){
+        case METRIC_EUCLIDEAN:
+            call(euclideanMetric());
+            break;
+        case METRIC_COSINE:
+            call(cosineMetric());
+            break;
+        default:
+            break;
+    } // End switch
+}
+
+/* Neighbors of a node in a layer - First value is their count */
+int* hnsw::neighborsOf(int node, int layer){
+    if(layer == 0)
+        return &this->links[(size_t)node * (this->maxDegree0 + 1)];
+    else
+        return &this->upperLinks[node][(layer - 1) * (this->degree + 1)];
+}
+
+/* Clear given marks for a new search - Marks are cleared after overflow */
+void hnsw::nextSearch(visitedMarks& visited){
+    if(visited.curr == INT_MAX){
+        fill(visited.marks.begin(), visited.marks.end(), 0);
+        visited.curr = 0;
+    }
+
+    visited.curr += 1;
+}
+
+/* Marks of a query - New marks are allocated if every one is used by a running query */
+hnsw::visitedMarks* hnsw::takeMarks(void){
+    visitedMarks* visited;
+
+    {
+        lock_guard<mutex> guard(this->marksLock);
+
+        if(this->freeMarks.size() != 0){
+            visited = this->freeMarks.back();
+            this->freeMarks.pop_back();
+            return visited;
+        }
+    }
+
+    visited = new visitedMarks;
+    visited->marks.assign(this->n, 0);
+    visited->curr = 0;
+
+    return visited;
+}
+
+void hnsw::returnMarks(visitedMarks* visited){
+    lock_guard<mutex> guard(this->marksLock);
+
+    this->freeMarks.push_back(visited);
+}
+
+/* Insert a node: descend greedily to its top layer, then link it with the */
+/* closest diverse nodes of every layer. Nodes of the graph aren't linked   */
+/* back yet, so no search of the batch reaches the node                     */
+template <typename metricPolicy>
+void hnsw::insert(int node, visitedMarks& visited, vector<vector<rankedNode> >& layers){
+    int level = this->levels[node], top, layer, i;
+    int* neighbors;
+    const double* query = this->points[node].getComponents().data();
+    double queryNorm = this->norms[node];
+    rankedNode curr;
+    vector<rankedNode> entries, candidates;
+
+    top = min(level, this->maxLevel);
+    curr.second = this->entryPoint;
+    curr.first = metricPolicy::rankBounded(query, this->points[curr.second].getComponents().data(), this->dim, queryNorm, this->norms[curr.second], HUGE_VAL);
+
+    /* Layers above the node */
+    for(layer = this->maxLevel; layer > level; layer--)
+        this->greedySearch<metricPolicy>(query, queryNorm, layer, curr, 1);
+
+    entries.push_back(curr);
+    layers.resize(top + 1);
+
+    /* Layers of the node */
+    for(layer = top; layer >= 0; layer--){
+        this->searchLayer<metricPolicy>(query, queryNorm, entries, this->efConstruction, layer, visited, candidates, 1);
+        entries = candidates;
+
+        this->selectNeighbors<metricPolicy>(candidates, this->degree);
+
+        /* Neighbors of node */
+        neighbors = this->neighborsOf(node, layer);
+        neighbors[0] = candidates.size();
+        for(i = 0; i < (int)candidates.size(); i++)
+            neighbors[i + 1] = candidates[i].second;
+
+        layers[layer] = candidates;
+    } // End for - Layers
+}
+
+/* Link a node with new nodes(sorted by rank) - Full neighbors are pruned */
+template <typename metricPolicy>
+void hnsw::linkBack(int node, int layer, vector<rankedNode>& added){
+    int maxNeighbors = (layer == 0) ? this->maxDegree0 : this->degree, i;
+    int* neighbors = this->neighborsOf(node, layer);
+    vector<rankedNode> pruned;
+
+    /* Room for every new node */
+    if(neighbors[0] + (int)added.size() <= maxNeighbors){
+        for(i = 0; i < (int)added.size(); i++)
+            neighbors[neighbors[0] + i + 1] = added[i].second;
+
+        neighbors[0] += added.size();
+        return;
+    }
+
+    pruned = added;
+    for(i = 1; i <= neighbors[0]; i++)
+        pruned.push_back(rankedNode(metricPolicy::rankBounded(this->points[node].getComponents().data(), this->points[neighbors[i]].getComponents().data(), this->dim, this->norms[node], this->norms[neighbors[i]], HUGE_VAL), neighbors[i]));
+
+    sort(pruned.begin(), pruned.end());
+    this->selectNeighbors<metricPolicy>(pruned, maxNeighbors);
+
+    neighbors[0] = pruned.size();
+    for(i = 0; i < (int)pruned.size(); i++)
+        neighbors[i + 1] = pruned[i].second;
+}
+
+/* Move to the closest neighbor while it is closer to the query */
+template <typename metricPolicy>
+void hnsw::greedySearch(const double* query, double queryNorm, int layer, rankedNode& curr, int fitting){
+    int changed = 1, i;
+    int* neighbors;
+    double currRank;
+
+    while(changed == 1){
+        changed = 0;
+        neighbors = this->neighborsOf(curr.second, layer);
+
+        for(i = 1; i <= neighbors[0]; i++){
+            currRank = metricPolicy::rankBounded(query, this->points[neighbors[i]].getComponents().data(), this->dim, queryNorm, this->norms[neighbors[i]], curr.first);
+            if(fitting == 0)
+                STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            if(currRank < curr.first){
+                curr = rankedNode(currRank, neighbors[i]);
+                changed = 1;
+            }
+        } // End for
+    } // End while
+}
+
+/* Expand the closest unexpanded node until it is farther than the ef closest */
+/* nodes found - Points farther than the ef-th node are abandoned early       */
+template <typename metricPolicy>
+void hnsw::searchLayer(const double* query, double queryNorm, vector<rankedNode>& entries, int ef, int layer, visitedMarks& visited, vector<rankedNode>& result, int fitting){
+    int i, next;
+    int* neighbors;
+    double currRank, bound;
+    vector<rankedNode> candidates; // Min heap - Nodes to be expanded
+
+    this->nextSearch(visited);
+    result.clear();
+
+    /* Result is a max heap - Farthest node first */
+    for(i = 0; i < (int)entries.size(); i++){
+        visited.marks[entries[i].second] = visited.curr;
+
+        candidates.push_back(entries[i]);
+        push_heap(candidates.begin(), candidates.end(), greater<rankedNode>());
+
+        result.push_back(entries[i]);
+        push_heap(result.begin(), result.end());
+    } // End for
+
+    while((int)result.size() > ef){
+        pop_heap(result.begin(), result.end());
+        result.pop_back();
+    }
+
+    while(candidates.size() != 0){
+        pop_heap(candidates.begin(), candidates.end(), greater<rankedNode>());
+        rankedNode curr = candidates.back();
+        candidates.pop_back();
+
+        /* Closest candidate is farther than every node of result */
+        if((int)result.size() == ef && curr.first > result.front().first)
+            break;
+
+        neighbors = this->neighborsOf(curr.second, layer);
+
+        if(fitting == 0)
+            STATS_ADD(this->lastStats, bucketsVisited, 1);
+
+        for(i = 1; i <= neighbors[0]; i++){
+            next = neighbors[i];
+
+            if(visited.marks[next] == visited.curr)
+                continue;
+
+            visited.marks[next] = visited.curr;
+
+            bound = ((int)result.size() == ef) ? result.front().first : HUGE_VAL;
+            currRank = metricPolicy::rankBounded(query, this->points[next].getComponents().data(), this->dim, queryNorm, this->norms[next], bound);
+            if(fitting == 0)
+                STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            if(currRank >= bound)
+                continue;
+
+            candidates.push_back(rankedNode(currRank, next));
+            push_heap(candidates.begin(), candidates.end(), greater<rankedNode>());
+
+            result.push_back(rankedNode(currRank, next));
+            push_heap(result.begin(), result.end());
+
+            if((int)result.size() > ef){
+                pop_heap(result.begin(), result.end());
+                result.pop_back();
+            }
+        } // End for - Neighbors
+    } // End while
+
+    /* Closest first */
+    sort_heap(result.begin(), result.end());
+}
+
+/* Keep up to maxNeighbors candidates in order of rank: a candidate closer to */
+/* a kept neighbor than to the node is skipped, so links go in every direction */
+template <typename metricPolicy>
+void hnsw::selectNeighbors(vector<rankedNode>& candidates, int maxNeighbors){
+    int i, j, keep;
+    vector<rankedNode> selected;
+
+    if((int)candidates.size() <= maxNeighbors)
+        return;
+
+    for(i = 0; i < (int)candidates.size() && (int)selected.size() < maxNeighbors; i++){
+        const double* candidate = this->points[candidates[i].second].getComponents().data();
+        keep = 1;
+
+        for(j = 0; j < (int)selected.size(); j++){
+            if(metricPolicy::rankBounded(candidate, this->points[selected[j].second].getComponents().data(), this->dim, this->norms[candidates[i].second], this->norms[selected[j].second], candidates[i].first) < candidates[i].first){
+                keep = 0;
+                break;
+            }
+        } // End for - Selected
+
+        if(keep == 1)
+            selected.push_back(candidates[i]);
+    } // End for - Candidates
+
+    candidates.swap(selected);
+}
+
+/* Closest ef nodes of layer 0 of a query - Sorted by rank */
+void hnsw::searchGraph(Item& query, int ef, visitedMarks& visited, vector<rankedNode>& result){
+    const double* queryData = query.getComponents().data();
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        double queryNorm = metricPolicy::norm(queryData, this->dim);
+        vector<rankedNode> entries;
+        rankedNode curr;
+        int layer;
+
+        curr.second = this->entryPoint;
+        curr.first = metricPolicy::rankBounded(queryData, this->points[curr.second].getComponents().data(), this->dim, queryNorm, this->norms[curr.second], HUGE_VAL);
+        STATS_ADD(this->lastStats, distanceComputations, 1);
+
+        for(layer = this->maxLevel; layer > 0; layer--){
+            STATS_ADD(this->lastStats, tablesProbed, 1);
+            this->greedySearch<metricPolicy>(queryData, queryNorm, layer, curr, 0);
+        } // End for - Layers
+
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+
+        entries.push_back(curr);
+        this->searchLayer<metricPolicy>(queryData, queryNorm, entries, ef, 0, visited, result, 0);
+    });
+}
+
+/* Find the radius neighbors of a given point: closest efSearch nodes, then */
+/* neighbors of nodes within radius are followed while they are in radius  */
+void hnsw::radiusNeighbors(Item& query, int radius, list<Item>& neighbors, list<double>* neighborsDistances, errorCode& status){
+    int i;
+    double currDist; // Distance of a point in list
+    vector<rankedNode> result;
+    vector<int> inRadius; // Nodes within radius(rank)
+    visitedMarks* visited; // Marks of this query
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(radius < MIN_RADIUS || radius > MAX_RADIUS){
+        status = INVALID_RADIUS;
+        return;
+    }
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->degree == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    /* Clear given lists */
+    neighbors.clear();
+    if(neighborsDistances != NULL)
+        neighborsDistances->clear();
+
+    TRACE_SCOPE("hnsw radiusNeighbors");
+    STATS_RESET(this->lastStats);
+    STATS_START(scanTimer);
+
+    visited = this->takeMarks();
+    this->searchGraph(query, this->efSearch, *visited, result);
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        const double* queryData = query.getComponents().data();
+        double queryNorm = metricPolicy::norm(queryData, this->dim), rankRadius, currRank;
+        int* links;
+        int j, next;
+
+        this->nextSearch(*visited);
+
+        /* Nodes of result within radius - Rounding of ranks is kept */
+        for(i = 0; i < (int)result.size(); i++){
+            rankRadius = metricPolicy::rankRadius(radius) + metricPolicy::rankMargin(queryNorm, this->norms[result[i].second]);
+
+            if(result[i].first < rankRadius){
+                visited->marks[result[i].second] = visited->curr;
+                inRadius.push_back(result[i].second);
+            }
+        } // End for
+
+        /* Follow neighbors within radius */
+        for(i = 0; i < (int)inRadius.size(); i++){
+            links = this->neighborsOf(inRadius[i], 0);
+            STATS_ADD(this->lastStats, bucketsVisited, 1);
+
+            for(j = 1; j <= links[0]; j++){
+                next = links[j];
+
+                if(visited->marks[next] == visited->curr)
+                    continue;
+
+                visited->marks[next] = visited->curr;
+
+                rankRadius = metricPolicy::rankRadius(radius) + metricPolicy::rankMargin(queryNorm, this->norms[next]);
+                currRank = metricPolicy::rankBounded(queryData, this->points[next].getComponents().data(), this->dim, queryNorm, this->norms[next], rankRadius);
+                STATS_ADD(this->lastStats, distanceComputations, 1);
+
+                if(currRank < rankRadius)
+                    inRadius.push_back(next);
+            } // End for - Neighbors
+        } // End for - Nodes within radius
+    });
+
+    this->returnMarks(visited);
+
+    /* Exact distances of candidates */
+    for(i = 0; i < (int)inRadius.size(); i++){
+        STATS_ADD(this->lastStats, candidatesScanned, 1);
+
+        if(this->metric == METRIC_EUCLIDEAN)
+            currDist = this->points[inRadius[i]].euclideanDist(query, radius, status);
+        else
+            currDist = this->points[inRadius[i]].cosineDist(query, status);
+
+        if(status != SUCCESS)
+            break;
+
+        /* Keep neighbor */
+        if(currDist < radius){
+            neighbors.push_back(this->points[inRadius[i]]);
+            if(neighborsDistances != NULL)
+                neighborsDistances->push_back(currDist);
+        }
+    } // End for
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+}
+
+/* Find the nearest neighbor of a given point - Closest of efSearch nodes */
+void hnsw::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status){
+    list<Item> neighbors;
+    list<double> neighborsDistances;
+
+    this->kNeighbors(query, 1, neighbors, &neighborsDistances, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Set nearest neighbor */
+    nNeighbor = neighbors.front();
+    if(neighborDistance != NULL)
+        *neighborDistance = neighborsDistances.front();
+}
+
+/* Find the k nearest neighbors of a given point - Closest k of max(efSearch, k) nodes */
+void hnsw::kNeighbors(Item& query, int k, list<Item>& neighbors, list<double>* neighborsDistances, errorCode& status){
+    int i;
+    double currDist; // Distance of a point in list
+    vector<rankedNode> result;
+    visitedMarks* visited; // Marks of this query
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->degree == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Check parameters */
+    if(k < 1 || k > this->n || k > MAX_EF){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    /* Clear given lists */
+    neighbors.clear();
+    if(neighborsDistances != NULL)
+        neighborsDistances->clear();
+
+    TRACE_SCOPE("hnsw kNeighbors");
+    STATS_RESET(this->lastStats);
+    STATS_START(scanTimer);
+
+    visited = this->takeMarks();
+    this->searchGraph(query, max(this->efSearch, k), *visited, result);
+    this->returnMarks(visited);
+
+    /* Exact distances of closest nodes */
+    for(i = 0; i < (int)result.size() && i < k; i++){
+        STATS_ADD(this->lastStats, candidatesScanned, 1);
+
+        if(this->metric == METRIC_EUCLIDEAN)
+            currDist = this->points[result[i].second].euclideanDist(query, status);
+        else
+            currDist = this->points[result[i].second].cosineDist(query, status);
+
+        if(status != SUCCESS)
+            break;
+
+        neighbors.push_back(this->points[result[i].second]);
+        if(neighborsDistances != NULL)
+            neighborsDistances->push_back(currDist);
+    } // End for
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+}
+
+/* Beam of queries - Recall is traded for speed without a new fit */
+void hnsw::setEfSearch(int efSearch, errorCode& status){
+    status = SUCCESS;
+
+    if(efSearch < MIN_EF || efSearch > MAX_EF){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    this->efSearch = efSearch;
+}
+
+///////////////
+/* Accessors */
+///////////////
+
+int hnsw::getNumberOfPoints(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->degree == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->n;
+}
+
+int hnsw::getDim(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->degree == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->dim;
+}
+
+/* Bytes of points, norms and links of every layer - Every allocation is counted */
+void hnsw::getMemoryReport(memoryReport& report, errorCode& status){
+    int i;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->degree == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
+
+    addAllocation(this->points.capacity() * sizeof(Item), report.points, report);
+    for(i = 0; i < this->n; i++)
+        addItem(this->points[i], report);
+
+    addAllocation(this->norms.capacity() * sizeof(double), report.points, report);
+
+    /* Links */
+    addAllocation(this->links.capacity() * sizeof(int), report.buckets, report);
+    addAllocation(this->upperLinks.capacity() * sizeof(vector<int>), report.buckets, report);
+    for(i = 0; i < this->n; i++)
+        if(this->upperLinks[i].capacity() != 0)
+            addAllocation(this->upperLinks[i].capacity() * sizeof(int), report.buckets, report);
+
+    addAllocation(this->levels.capacity() * sizeof(int), report.buckets, report);
+
+    /* Marks of queries */
+    {
+        lock_guard<mutex> guard(this->marksLock);
+
+        addAllocation(this->freeMarks.capacity() * sizeof(visitedMarks*), report.overhead, report);
+        for(i = 0; i < (int)this->freeMarks.size(); i++){
+            addAllocation(sizeof(visitedMarks), report.overhead, report);
+            addAllocation(this->freeMarks[i]->marks.capacity() * sizeof(int), report.overhead, report);
+        }
+    }
+
+    sumMemoryReport(report);
+}
+
+/* Layers are drawn at random - Not saved */
+void hnsw::save(string fileName, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
+}
+
+/* Neighbors of nodes of every layer - Sizes of "buckets" are degrees */
+void hnsw::getIndexStats(indexStats& stats, errorCode& status){
+    int i, layer;
+    double meanDegree = 0;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->degree == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    stats.tables.resize(this->maxLevel + 1);
+    for(layer = 0; layer <= this->maxLevel; layer++){
+        vector<int> sizes;
+
+        for(i = 0; i < this->n; i++)
+            if(this->levels[i] >= layer)
+                sizes.push_back(this->neighborsOf(i, layer)[0]);
+
+        if(layer == 0)
+            for(i = 0; i < (int)sizes.size(); i++)
+                meanDegree += sizes[i] / (double)sizes.size();
+
+        computeBucketStats(sizes, stats.tables[layer]);
+    } // End for - Layers
+
+    /* Neighbors of about efSearch expanded nodes of layer 0 */
+    stats.expectedCandidates = this->efSearch * meanDegree;
+    if(stats.expectedCandidates > this->n)
+        stats.expectedCandidates = this->n;
+}
+
+/* Print statistics */
+void hnsw::print(void){
+
+    if(this->degree == -1)
+        cout << "Invalid method\n";
+    else{
+
+        cout << "Hnsw statistics\n";
+        cout << "M: " << this->degree << "\n";
+        cout << "efConstruction: " << this->efConstruction << "\n";
+        cout << "efSearch: " << this->efSearch << "\n";
+
+        /* Degrees of layers */
+        if(this->fitted == 1){
+            indexStats stats;
+            errorCode status;
+
+            cout << "Dimension: " << this->dim << "\n";
+            cout << "Total points: " << this->n << "\n";
+            cout << "Layers: " << this->maxLevel + 1 << "\n";
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Layer");
+        }
+    }
+}
+
+void hnsw::printHashFunctions(void){
+    cout << "Hnsw hasn't hash functions\n\n";
+}
+
+// Petropoulakis Panagiotis
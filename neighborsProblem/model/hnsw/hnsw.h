@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <mutex>
+#include <utility>
+#include "../model.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+#include "../../metric/metric.h"
+
+/* Neighbors problem using a hierarchical navigable small world graph(hnsw) - Metrices: euclidean, cosine */
+/* Every point is a node of layer 0 and of a random number of upper layers. Queries descend greedily       */
+/* from the entry point to layer 0 and search it with a beam of efSearch nodes                             */
+class hnsw: public model{
+    private:
+
+        /* Nodes visited by a search - A node is visited if its mark is curr */
+        typedef struct visitedMarks{
+            std::vector<int> marks;
+            int curr;
+        }visitedMarks;
+
+        /* Pairs of rank and node - Ranks of metric.h */
+        typedef std::pair<double, int> rankedNode;
+
+        std::vector<Item> points; // All points are kept in a single table
+        std::vector<double> norms; // Norms of points(metric.h)
+        std::vector<int> levels; // Top layer of every node
+        std::vector<int> links; // Layer 0: count and maxDegree0 neighbors per node
+        std::vector<std::vector<int> > upperLinks; // Layers 1..level: count and degree neighbors per layer
+        std::vector<visitedMarks*> freeMarks; // Marks of finished queries - A running query has its own
+        std::mutex marksLock; // Free marks - Concurrent queries
+        int entryPoint;
+        int maxLevel; // Top layer of graph
+        int degree; // Max neighbors of a node in upper layers(M)
+        int maxDegree0; // Max neighbors of a node in layer 0(2 * M)
+        int efConstruction; // Beam of inserted points
+        int efSearch; // Beam of queries
+        int n; // Number of items
+        int dim; // Dimension
+        int fitted; // Method is fitted with data
+        std::string metrice;
+        metricType metric; // Resolved at fit
+
+        /* Call given function with the policy type of the metrice(euclideanMetric, cosineMetric) */
+        template <typename function>
+        void withMetric(function call);
+
+        /* Neighbors of a node in a layer - First value is their count */
+        int* neighborsOf(int node, int layer);
+
+        /* Clear given marks for a new search */
+        void nextSearch(visitedMarks& visited);
+
+        /* Marks of a query - Free marks are reused, so concurrent queries never share marks */
+        visitedMarks* takeMarks(void);
+        void returnMarks(visitedMarks* visited);
+
+        /* Link a node of a batch with the closest diverse nodes of every layer of the graph of previous batches */
+        /* The graph is only read - Selected neighbors of every layer are returned for their back links           */
+        template <typename metricPolicy>
+        void insert(int node, visitedMarks& visited, std::vector<std::vector<rankedNode> >& layers);
+
+        /* Link a node of the graph with nodes of a batch(sorted by rank) - Full neighbors are pruned */
+        template <typename metricPolicy>
+        void linkBack(int node, int layer, std::vector<rankedNode>& added);
+
+        /* Closest node of a layer by greedy moves from given node - Statistics are not counted while fitting */
+        template <typename metricPolicy>
+        void greedySearch(const double* query, double queryNorm, int layer, rankedNode& curr, int fitting);
+
+        /* Beam search of a layer from given nodes - Keeps the ef closest nodes(sorted) */
+        template <typename metricPolicy>
+        void searchLayer(const double* query, double queryNorm, std::vector<rankedNode>& entries, int ef, int layer, visitedMarks& visited, std::vector<rankedNode>& result, int fitting);
+
+        /* Keep up to maxNeighbors diverse candidates(sorted): a candidate closer to a kept */
+        /* neighbor than to the node is skipped                                             */
+        template <typename metricPolicy>
+        void selectNeighbors(std::vector<rankedNode>& candidates, int maxNeighbors);
+
+        /* Closest ef nodes of layer 0 of a query */
+        void searchGraph(Item& query, int ef, visitedMarks& visited, std::vector<rankedNode>& result);
+
+    public:
+
+        hnsw(std::string metrice="euclidean");
+        hnsw(int degree, int efConstruction, int efSearch, std::string metrice, errorCode& status);
+
+        ~hnsw();
+
+        void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
+
+        void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
+        void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+
+        /* Find the k nearest neighbors of an item - Sorted by distance */
+        void kNeighbors(Item& query, int k, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
+
+        /* Beam of queries - Can be changed after fit */
+        void setEfSearch(int efSearch, errorCode& status);
+
+        int getNumberOfPoints(errorCode& status);
+        int getDim(errorCode& status);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
+
+        void print(void);
+        void printHashFunctions(void);
+};
+
+// Petropoulakis Panagiotis
@@ -5,6 +5,7 @@
 #include "../../item/item.h"
 #include "../../utils/utils.h"
 #include "../../hashFunction/hashFunction.h"
+#include "../../candidateFilter/candidateFilter.h"
 
 /* Neighbors problem using hypercube euclidean */
 class hypercubeEuclidean: public model{
@@ -25,7 +26,7 @@ class hypercubeEuclidean: public model{
         /* Create a compare class based in hamming distance*/
         struct verticesCompare{
             bool operator()(const neighborVertice& x, const neighborVertice& y) const{
-                return x.hammingDist < y.hammingDist;
+                return x.hammingDist > y.hammingDist; // Closest vertice on top
             }
         };
 
@@ -39,6 +40,12 @@ class hypercubeEuclidean: public model{
         int m; // Max items to be searched
         int probes; // Max vertices probed
         int fitted; // Method is fitted with data
+        rerankStage rerankCandidates; // Nearest neighbor ranks candidates of vertices by quantized distances
+        std::vector<int> vertexOffsets; // Candidates of vertice-i have indexes [vertexOffsets[i], vertexOffsets[i + 1])
+        std::vector<Item*> candidatePoints; // Items of the cube in order of vertices
+
+        /* Points of the rerank stage in order of vertices */
+        void fitCandidates(errorCode& status);
     public:
 
         hypercubeEuclidean();
@@ -48,13 +55,17 @@ class hypercubeEuclidean: public model{
         ~hypercubeEuclidean();
 
         void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
 
         void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
         void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+        void setRerank(int rerank, int sketch, errorCode& status);
         
         int getNumberOfPoints(errorCode& status);
         int getDim(errorCode& status);
-        unsigned size();
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
 
         void print(void);
         void printHashFunctions(void);
@@ -79,7 +90,7 @@ class hypercubeCosine: public model{
         /* Create a compare fucntion based in hamming distance*/
         struct verticesCompare{
             bool operator()(const neighborVertice& x, const neighborVertice& y) const{
-                return x.hammingDist < y.hammingDist;
+                return x.hammingDist > y.hammingDist; // Closest vertice on top
             }
         };
 
@@ -92,6 +103,12 @@ class hypercubeCosine: public model{
         int m; // Max items to be searched
         int probes; // Max vertices probed
         int fitted; // Method is fitted with data
+        rerankStage rerankCandidates; // Nearest neighbor ranks candidates of vertices by quantized distances or sign sketches
+        std::vector<int> vertexOffsets; // Candidates of vertice-i have indexes [vertexOffsets[i], vertexOffsets[i + 1])
+        std::vector<Item*> candidatePoints; // Items of the cube in order of vertices
+
+        /* Points of the rerank stage in order of vertices */
+        void fitCandidates(errorCode& status);
     public:
 
         hypercubeCosine();
@@ -100,13 +117,17 @@ class hypercubeCosine: public model{
         ~hypercubeCosine();
 
         void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
 
         void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
         void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+        void setRerank(int rerank, int sketch, errorCode& status);
         
         int getNumberOfPoints(errorCode& status);
         int getDim(errorCode& status);
-        unsigned size(void);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
         
         void print(void);
         void printHashFunctions(void);
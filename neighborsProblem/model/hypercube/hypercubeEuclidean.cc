@@ -6,6 +6,8 @@
 #include <cmath>
 #include "hypercube.h"
 #include "../../hashFunction/hashFunction.h"
+#include "../../indexStats/indexStats.h"
+#include "../../trace/trace.h"
 #include "../../item/item.h"
 #include "../../utils/utils.h"
 
@@ -61,13 +63,20 @@ hypercubeEuclidean::~hypercubeEuclidean(){
 
 /* Fix hash function, members of hypercube euclidean and add given points in the cube */
 void hypercubeEuclidean::fit(list<Item>& points, errorCode& status){
+    listStream stream(points);
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are hashed in the cube while they are read */
+void hypercubeEuclidean::fit(itemStream& points, errorCode& status){
     int i;
     int pos; // Pos in cube
 
-    /* Iteratiors */
-    list<Item>::iterator iterPoints = points.begin(); // Iterate through points
+    hashFunctionEuclideanHypercube* newFunc = NULL; // Set at first point
    
     status = SUCCESS;
+    TRACE_SCOPE("hypercube euclidean fit");
 
     /* Check method */
     if(this->k == -1){
@@ -81,69 +90,71 @@ void hypercubeEuclidean::fit(list<Item>& points, errorCode& status){
         return;
     }
 
-    /* Set members */
-    this->n = points.size();
-    if(this->n < MIN_POINTS || this->n > MAX_POINTS){
-        status = INVALID_POINTS;
-        return;
-    }
-    
     /* Set table size */
     this->tableSize = pow(2, this->k);
     this->cube.reserve(this->tableSize);
-
+    
     /* Fix table */
     for(i = 0; i < this->tableSize; i++)
         this->cube.push_back(list<Item>());
 
-    /* Set dimension */
-    this->dim = iterPoints->getDim();
-    if(this->dim <= 0){
-        status = INVALID_DIM;
-        return;
-    }
-    
-    ///////////////////////
-    /* Set hash function */
-    ///////////////////////
-
-    hashFunctionEuclideanHypercube* newFunc = NULL;  
-
-    newFunc = new hashFunctionEuclideanHypercube(this->dim, this->k, this->w); 
-    if(newFunc == NULL){
-        status = ALLOCATION_FAILED;
-        this->k = -1;
-    }
-    
-    this->hashFunctions = newFunc; // Add hash function
+    this->n = 0;
 
     //////////////
     /* Set cube */
     //////////////
     
     /* Scan given points */
-    for(iterPoints = points.begin(); iterPoints != points.end(); iterPoints++){
+    points.forEach([&](Item& point, errorCode& status){
+
+        /* First point - Set dimension and hash function */
+        if(newFunc == NULL){
+            this->dim = point.getDim();
+            if(this->dim <= 0){
+                status = INVALID_DIM;
+                return;
+            }
+
+            newFunc = new hashFunctionEuclideanHypercube(this->dim, this->k, this->w, this->generator.next()); 
+            this->hashFunctions = newFunc; // Add hash function
+        }
+
         /* Check consistency of dim */
-        if(this->dim != iterPoints->getDim()){
+        if(this->dim != point.getDim()){
             status = INVALID_DIM;
-            break;
+            return;
+        }
+
+        /* Number of points is too big */
+        if(this->n == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
         }
         
         /* Find position in cube */
-        pos = this->hashFunctions->hash(*iterPoints, status);
+        pos = this->hashFunctions->hash(point, status);
         if(pos < 0 || pos >= tableSize){
             status = INVALID_HASH_FUNCTION;
-            break;
+            return;
         }
 
         if(status != SUCCESS){
             this->k = -1;
-            break;
+            return;
         }
 
         /* Add point */
-        this->cube[pos].push_back(*iterPoints);
-    } // End for - Points
+        this->cube[pos].push_back(point);
+        this->n += 1;
+    }, status);
+
+    /* Small number of points */
+    if(status == SUCCESS && this->n < MIN_POINTS)
+        status = INVALID_POINTS;
+
+    /* Compressed points of the rerank stage */
+    if(status == SUCCESS)
+        this->fitCandidates(status);
 
     /* Error occured - Clear structures */
     if(status != SUCCESS){
@@ -153,7 +164,7 @@ void hypercubeEuclidean::fit(list<Item>& points, errorCode& status){
             this->cube[i].clear();
  
         /* Clear hash function */
-        delete this->hashFunctions;      
+        delete newFunc;      
     }
     else
         /* Method fitted */
@@ -192,11 +203,22 @@ void hypercubeEuclidean::radiusNeighbors(Item& query, int radius, list<Item>& ne
     if(neighborsDistances != NULL)
         neighborsDistances->clear();
 
+    TRACE_SCOPE("hypercube euclidean radiusNeighbors");
+    STATS_RESET(this->lastStats);
+    STATS_ADD(this->lastStats, tablesProbed, 1);
+    STATS_START(hashTimer);
+    TRACE_BEGIN(hashRegion, "hypercube euclidean hash");
+
     /* Find initial vertice */
     initialPos = this->hashFunctions->hash(query, status);
     if(status != SUCCESS)
             return;
 
+    STATS_STOP(this->lastStats, hashTime, hashTimer);
+    TRACE_END(hashRegion);
+    STATS_START(scanTimer);
+    TRACE_BEGIN(scanRegion, "hypercube euclidean scan");
+
     /* Find all neighbors of current vertice */
     for(i = 0; i < this->tableSize; i++){
 
@@ -216,23 +238,34 @@ void hypercubeEuclidean::radiusNeighbors(Item& query, int radius, list<Item>& ne
         /* Check initial pos */
         if(i == 0)
             pos = initialPos;
-        /* Extract min pos */
-        else
+        /* Extract min pos - Every vertice is probed once */
+        else{
+            if(neighborVertices.size() == 0)
+                break;
+
             pos = neighborVertices.front().pos;
+            pop_heap(neighborVertices.begin(), neighborVertices.end(), verticesCompare());
+            neighborVertices.pop_back();
+        }
 
         /* Empty vertice */
         if(this->cube[pos].size() == 0)
             continue;
 
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+
         /* Scan current vertice */
         for(iter = this->cube[pos].begin(); iter != this->cube[pos].end(); iter++){  
 
             numNeighbors += 1;
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
             
-            /* Find current distance */
-            currDist = iter->euclideanDist(query, status);
+            /* Find current distance - Points out of radius are abandoned early */
+            currDist = iter->euclideanDist(query, radius, status);
             if(status != SUCCESS)
                 return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
             
             /* Keep neighbor */
             if(currDist < radius){
@@ -250,6 +283,10 @@ void hypercubeEuclidean::radiusNeighbors(Item& query, int radius, list<Item>& ne
         if(numNeighbors == m)
             break;
     } // End for - Probes
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    TRACE_END(scanRegion);
+    STATS_RECORD(this->stats, this->lastStats);
 }
 
 /* Find the nearest neighbor of a given point */
@@ -258,7 +295,10 @@ void hypercubeEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighbo
     double currDist; // Distance of a point in list
     double minDist = -1;
     list<Item>::iterator iter;
-    list<Item>::iterator iterNearestNeighbor;
+    Item* nearestPtr;
+    int rerank = this->rerankCandidates.enabled(); // Two stage search
+    rerankQuery scratch; // Candidates of the rerank stage - One per call
+    int index = 0; // Index of current point in the rerank stage
     vector<neighborVertice> neighborVertices; // Keep all neighbors  
     int numNeighbors = 0; // Number of neighbors
 
@@ -275,11 +315,28 @@ void hypercubeEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighbo
         return;
     }
 
+    TRACE_SCOPE("hypercube euclidean nNeighbor");
+    STATS_RESET(this->lastStats);
+
+    if(rerank == 1){
+        this->rerankCandidates.begin(query, scratch, status);
+        if(status != SUCCESS)
+            return;
+    }
+    STATS_ADD(this->lastStats, tablesProbed, 1);
+    STATS_START(hashTimer);
+    TRACE_BEGIN(hashRegion, "hypercube euclidean hash");
+
     /* Find initial vertice */
     initialPos = this->hashFunctions->hash(query, status);
     if(status != SUCCESS)
             return;
 
+    STATS_STOP(this->lastStats, hashTime, hashTimer);
+    TRACE_END(hashRegion);
+    STATS_START(scanTimer);
+    TRACE_BEGIN(scanRegion, "hypercube euclidean scan");
+
     /* Find all neighbors of current vertice */
     for(i = 0; i < this->tableSize; i++){
 
@@ -299,28 +356,59 @@ void hypercubeEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighbo
         /* Check initial pos */
         if(i == 0)
             pos = initialPos;
-        /* Extract min pos */
-        else
+        /* Extract min pos - Every vertice is probed once */
+        else{
+            if(neighborVertices.size() == 0)
+                break;
+
             pos = neighborVertices.front().pos;
+            pop_heap(neighborVertices.begin(), neighborVertices.end(), verticesCompare());
+            neighborVertices.pop_back();
+        }
 
         /* Empty vertice */
         if(this->cube[pos].size() == 0)
             continue;
 
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+
+        if(rerank == 1)
+            index = this->vertexOffsets[pos];
+
         /* Scan current vertice */
         for(iter = this->cube[pos].begin(); iter != this->cube[pos].end(); iter++){  
 
             numNeighbors += 1;
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
             
-            /* Find current distance */
-            currDist = iter->euclideanDist(query, status);
+            /* Rank candidate by quantized distance - Exact distances are found after the scan */
+            if(rerank == 1){
+
+                /* Duplicates are not counted in m */
+                if(this->rerankCandidates.add(scratch, index) == 0){
+                    numNeighbors -= 1;
+                    STATS_ADD(this->lastStats, duplicatesSkipped, 1);
+                }
+                index += 1;
+
+                /* Found m neighbors */
+                if(numNeighbors == m)
+                    break;
+
+                continue;
+            }
+
+            /* Find current distance - Farther points than the nearest are abandoned early */
+            currDist = iter->euclideanDist(query, (flag == 0) ? HUGE_VAL : minDist, status);
             if(status != SUCCESS)
                 return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
             
             /* First neighbor */
             if(flag == 0){
                 minDist = currDist;
-                iterNearestNeighbor = iter;
+                nearestPtr = &(*iter);
     
                 found = 1;
                 flag = 1;
@@ -328,7 +416,7 @@ void hypercubeEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighbo
 
             /* Keep neighbor */
             else if(minDist > currDist){
-                iterNearestNeighbor = iter;
+                nearestPtr = &(*iter);
                 minDist = currDist;
             }
 
@@ -342,9 +430,32 @@ void hypercubeEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighbo
             break;
     } // End for - Probes
 
+    /* Exact distances of the best candidates */
+    if(rerank == 1){
+        vector<pair<double, int> >& candidates = this->rerankCandidates.candidates(scratch);
+
+        for(i = 0; i < (int)candidates.size(); i++){
+            currDist = this->candidatePoints[candidates[i].second]->euclideanDist(query, (found == 0) ? HUGE_VAL : minDist, status);
+            if(status != SUCCESS)
+                return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            if(found == 0 || minDist > currDist){
+                minDist = currDist;
+                nearestPtr = this->candidatePoints[candidates[i].second];
+                found = 1;
+            }
+        } // End for - Candidates
+    }
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    TRACE_END(scanRegion);
+    STATS_RECORD(this->stats, this->lastStats);
+
     /* Nearest neighbor found */
     if(found == 1){
-        nNeighbor = *iterNearestNeighbor;
+        nNeighbor = *nearestPtr;
         if(neighborDistance != NULL)
             *neighborDistance = minDist;
     }
@@ -355,6 +466,61 @@ void hypercubeEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighbo
     }
 }
 
+/* Candidates checked with exact distances by nearest neighbor - Radius neighbors stay exact */
+void hypercubeEuclidean::setRerank(int rerank, int sketch, errorCode& status){
+    status = SUCCESS;
+
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Compressed points are built at fit */
+    if(this->fitted == 1){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    /* Sign sketches estimate angles only */
+    if(sketch != 0){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    this->rerankCandidates.setRerank(rerank, FILTER_QUANTIZED_EUCLIDEAN, status);
+}
+
+/* Items are indexed in order of vertices, so a candidate is found by */
+/* the first index of its vertice and its position in the list        */
+void hypercubeEuclidean::fitCandidates(errorCode& status){
+    int i;
+    list<Item>::iterator iter;
+
+    status = SUCCESS;
+
+    /* Stage is disabled */
+    if(this->rerankCandidates.getRerank() == 0)
+        return;
+
+    this->candidatePoints.reserve(this->n);
+    this->vertexOffsets.resize(this->tableSize + 1);
+
+    for(i = 0; i < this->tableSize; i++){
+        this->vertexOffsets[i] = this->candidatePoints.size();
+
+        for(iter = this->cube[i].begin(); iter != this->cube[i].end(); iter++)
+            this->candidatePoints.push_back(&(*iter));
+    } // End for - Vertices
+
+    this->vertexOffsets[this->tableSize] = this->candidatePoints.size();
+
+    this->rerankCandidates.fit(this->candidatePoints, this->generator.next(), status);
+    if(status != SUCCESS){
+        this->candidatePoints.clear();
+        this->vertexOffsets.clear();
+    }
+}
+
 ///////////////
 /* Accessors */
 ///////////////
@@ -389,48 +555,80 @@ int hypercubeEuclidean::getDim(errorCode& status){
         return this->dim;
 }
 
-unsigned hypercubeEuclidean::size(void){
-    unsigned result = 0;
+/* Bytes of vertices, points and hash function - Every allocation is counted */
+void hypercubeEuclidean::getMemoryReport(memoryReport& report, errorCode& status){
+    int i;
+    list<Item>::iterator iter;
 
-    if(fitted == 0){
-        return -1;
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
     }
-    
+
     if(this->k == -1){
-        return -1;
+        status = INVALID_METHOD;
+        return;
     }
-    
-    result += sizeof(this->tableSize);
-    result += sizeof(this->n);
-    result += sizeof(this->k);
-    result += sizeof(this->dim);
-    result += sizeof(this->w);
-    result += sizeof(this->m);
-    result += sizeof(this->m);
-    result += sizeof(this->probes);
-    result += sizeof(this->fitted);
-    
-    int i;
-
-    result += this->hashFunctions->size();
 
-    result += sizeof(this->hashFunctions);
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
 
-    list<Item>::iterator iter;
+    /* Hash function */
+    report.hashFunctions += this->hashFunctions->size();
 
+    /* Vertices - Nodes keep the items, so links are counted with points */
+    addAllocation(this->cube.capacity() * sizeof(list<Item>), report.buckets, report);
     for(i = 0; i < this->tableSize; i++){
-        for(iter = this->cube[i].begin(); iter!= this->cube[i].end(); iter++){
-            result += iter->size();
+        addAllocation(LIST_NODE_BYTES(Item), report.points, report, this->cube[i].size());
 
-            result += sizeof(Item);
-        } // End for - iter
-    } // End for - table size
+        for(iter = this->cube[i].begin(); iter != this->cube[i].end(); iter++)
+            addItem(*iter, report);
+    } // End for - Vertices
 
-    result += this->cube.capacity() * sizeof(list<Item>);
+    /* Quantized points and their order */
+    addAllocation(this->candidatePoints.capacity() * sizeof(Item*), report.buckets, report);
+    addAllocation(this->vertexOffsets.capacity() * sizeof(int), report.buckets, report);
+    this->rerankCandidates.getMemoryReport(report);
 
-    result += sizeof(this->cube);
+    sumMemoryReport(report);
+}
 
-    return result;
+/* Hash function keeps state while hashing - Can't be saved */
+void hypercubeEuclidean::save(string fileName, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
+}
+
+/* Occupancy of vertices of cube */
+void hypercubeEuclidean::getIndexStats(indexStats& stats, errorCode& status){
+    int i;
+    vector<int> sizes(this->tableSize);
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    for(i = 0; i < this->tableSize; i++)
+        sizes[i] = this->cube[i].size();
+
+    stats.tables.resize(1);
+    computeBucketStats(sizes, stats.tables[0]);
+
+    /* Initial vertice, then probes - 1 vertices of mean size - Up to m items */
+    stats.expectedCandidates = stats.tables[0].expectedCandidates + (min(this->probes, this->tableSize) - 1) * ((double)this->n / this->tableSize);
+    if(stats.expectedCandidates > this->m)
+        stats.expectedCandidates = this->m;
 }
 
 /* Print statistics */
@@ -446,6 +644,17 @@ void hypercubeEuclidean::print(void){
         cout << "Number of sub hash functions(k): " << this->k << "\n";
         cout << "M: " << this->m << "\n";
         cout << "Probes: " << this->probes << "\n";
+        cout << "Candidates reranked: " << this->rerankCandidates.getRerank() << "\n";
+
+        /* Occupancy of buckets */
+        if(this->fitted == 1){
+            indexStats stats;
+            errorCode status;
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Vertices");
+        }
     }
 }
 
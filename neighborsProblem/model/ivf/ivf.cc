@@ -0,0 +1,613 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <cmath>
+#include "ivf.h"
+#include "../../indexStats/indexStats.h"
+#include "../../trace/trace.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+#include "../../metric/metric.h"
+
+using namespace std;
+
+/////////////////////////////////
+/* Implementation of ivf class */
+/////////////////////////////////
+
+/* Assignments are split in ranges of points scanned by threads - Small */
+/* sets are assigned by one thread                                      */
+#define MIN_POINTS_PER_THREAD 1000
+
+/* Default constructor */
+ivf::ivf(string metrice):lists(100),probes(8),n(0),dim(0),fitted(0),metrice(metrice),metric(METRIC_EUCLIDEAN){}
+
+ivf::ivf(int lists, int probes, string metrice, errorCode& status):lists(lists),probes(probes),n(0),dim(0),fitted(0),metrice(metrice),metric(METRIC_EUCLIDEAN){
+    /* Check parameters */
+    if(lists < MIN_LISTS || lists > MAX_LISTS || probes < MIN_PROBES || probes > lists){
+        status = INVALID_PARAMETERS;
+        this->lists = -1;
+    }
+}
+
+ivf::~ivf(){}
+
+/* Save given points and build the lists */
+void ivf::fit(list<Item>& points, errorCode& status){
+    listStream stream(points);
+
+    this->points.reserve(points.size());
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are appended in place - Centroids are trained after the last point */
+void ivf::fit(itemStream& points, errorCode& status){
+    int i;
+    vector<const double*> data;
+    vector<int> assignments, positions;
+    vector<Item> ordered;
+
+    status = SUCCESS;
+    TRACE_SCOPE("ivf fit");
+
+    /* Check method */
+    if(this->lists == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Already fitted */
+    if(this->fitted == 1){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    /* Resolve metrice - Search loops never compare strings */
+    if(this->metrice == "euclidean")
+        this->metric = METRIC_EUCLIDEAN;
+    else if(this->metrice == "cosine")
+        this->metric = METRIC_COSINE;
+    else{
+        status = INVALID_METRICE;
+        return;
+    }
+
+    /* Copy points */
+    points.forEach([&](Item& point, errorCode& status){
+
+        /* Dimension of first point */
+        if(this->points.size() == 0)
+            this->dim = point.getDim();
+
+        if(this->dim != point.getDim() || (int)this->points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        this->points.push_back(point);
+    }, status);
+
+    /* Set members */
+    this->n = this->points.size();
+    if(status == SUCCESS && (this->n < MIN_POINTS || this->n > MAX_POINTS))
+        status = INVALID_POINTS;
+
+    /* Every list needs a point */
+    if(status == SUCCESS && this->lists > this->n)
+        status = INVALID_PARAMETERS;
+
+    if(status != SUCCESS){
+        this->points.clear();
+        this->points.shrink_to_fit();
+        return;
+    }
+
+    /* Release spare capacity of growth - Items are moved */
+    this->points.shrink_to_fit();
+
+    ///////////////////
+    /* Set centroids */
+    ///////////////////
+
+    TRACE_BEGIN(trainRegion, "ivf train");
+
+    this->withMetric([&](auto policy){
+        this->trainCentroids<decltype(policy)>();
+    });
+
+    TRACE_END(trainRegion);
+
+    ///////////////
+    /* Set lists */
+    ///////////////
+
+    TRACE_BEGIN(listsRegion, "ivf lists");
+
+    data.resize(this->n);
+    for(i = 0; i < this->n; i++)
+        data[i] = this->points[i].getComponents().data();
+
+    this->withMetric([&](auto policy){
+        this->assignPoints<decltype(policy)>(data, assignments);
+    });
+
+    /* Counting sort of points by list - Items are moved */
+    this->offsets.assign(this->lists + 1, 0);
+    for(i = 0; i < this->n; i++)
+        this->offsets[assignments[i] + 1] += 1;
+
+    for(i = 0; i < this->lists; i++)
+        this->offsets[i + 1] += this->offsets[i];
+
+    positions.assign(this->offsets.begin(), this->offsets.end() - 1);
+    ordered.resize(this->n);
+    for(i = 0; i < this->n; i++)
+        ordered[positions[assignments[i]]++] = move(this->points[i]);
+
+    this->points.swap(ordered);
+
+    TRACE_END(listsRegion);
+
+    /* Method fitted */
+    this->fitted = 1;
+}
+
+/* Call given function with the policy of the metrice - Loops are instantiated per metrice */
+template <typename function>
+void ivf::withMetric(function call){
+    switch(this->metric){
+        case METRIC_EUCLIDEAN:
+            call(euclideanMetric());
+            break;
+        case METRIC_COSINE:
+            call(cosineMetric());
+            break;
+        default:
+            break;
+    } // End switch
+}
+
+/* Lloyd iterations on a random sample: centroids start at sample points, every */
+/* iteration assigns the sample and moves centroids to the mean of their points */
+/* Cosine centroids are means of normalized points(spherical k-means)           */
+template <typename metricPolicy>
+void ivf::trainCentroids(void){
+    int sampleSize, iteration, changed, i, j, c;
+    double scale;
+    vector<int> order(this->n), assignments, previous, counts(this->lists);
+    vector<const double*> sample;
+    vector<double> normalized, sums;
+
+    /* Random sample */
+    sampleSize = ((long)this->lists * KMEANS_SAMPLE < this->n) ? this->lists * KMEANS_SAMPLE : this->n;
+
+    iota(order.begin(), order.end(), 0);
+    this->generator.shuffle(order);
+
+    sample.resize(sampleSize);
+    if(this->metric == METRIC_COSINE){
+        normalized.resize((size_t)sampleSize * this->dim);
+
+        for(i = 0; i < sampleSize; i++){
+            const double* point = this->points[order[i]].getComponents().data();
+
+            scale = metricPolicy::norm(point, this->dim);
+            scale = (scale == 0) ? 0 : 1 / scale;
+
+            for(j = 0; j < this->dim; j++)
+                normalized[(size_t)i * this->dim + j] = point[j] * scale;
+
+            sample[i] = &normalized[(size_t)i * this->dim];
+        } // End for
+    }
+    else
+        for(i = 0; i < sampleSize; i++)
+            sample[i] = this->points[order[i]].getComponents().data();
+
+    /* First points of sample */
+    this->centroids.resize((size_t)this->lists * this->dim);
+    this->centroidsNorm.resize(this->lists);
+    for(c = 0; c < this->lists; c++){
+        copy(sample[c], sample[c] + this->dim, this->centroids.begin() + (size_t)c * this->dim);
+        this->centroidsNorm[c] = metricPolicy::norm(sample[c], this->dim);
+    } // End for
+
+    for(iteration = 0; iteration < KMEANS_ITERATIONS; iteration++){
+        this->assignPoints<metricPolicy>(sample, assignments);
+
+        /* Assignments converged */
+        changed = (previous.size() == 0) ? 1 : !equal(assignments.begin(), assignments.end(), previous.begin());
+        if(changed == 0)
+            break;
+
+        previous = assignments;
+
+        /* Means of lists */
+        sums.assign((size_t)this->lists * this->dim, 0);
+        fill(counts.begin(), counts.end(), 0);
+
+        for(i = 0; i < sampleSize; i++){
+            c = assignments[i];
+            counts[c] += 1;
+
+            for(j = 0; j < this->dim; j++)
+                sums[(size_t)c * this->dim + j] += sample[i][j];
+        } // End for
+
+        for(c = 0; c < this->lists; c++){
+            double* centroid = &this->centroids[(size_t)c * this->dim];
+
+            /* Empty list - Centroid moves to a random point of the sample */
+            if(counts[c] == 0){
+                i = this->generator.uniformInt(0, sampleSize - 1);
+                copy(sample[i], sample[i] + this->dim, centroid);
+            }
+            else
+                for(j = 0; j < this->dim; j++)
+                    centroid[j] = sums[(size_t)c * this->dim + j] / counts[c];
+
+            this->centroidsNorm[c] = metricPolicy::norm(centroid, this->dim);
+        } // End for - Lists
+    } // End for - Iterations
+}
+
+/* Closest centroid of every given point - Ranges of points are assigned in parallel */
+template <typename metricPolicy>
+void ivf::assignPoints(vector<const double*>& data, vector<int>& assignments){
+    int i, ranges, size = data.size();
+    vector<thread> pool;
+
+    assignments.resize(size);
+
+    ranges = thread::hardware_concurrency();
+    if(ranges > size / MIN_POINTS_PER_THREAD)
+        ranges = size / MIN_POINTS_PER_THREAD;
+    if(ranges <= 0)
+        ranges = 1;
+
+    auto work = [&](int first, int last){
+        int i, c, best;
+        double currRank, minRank, pointNorm;
+
+        for(i = first; i < last; i++){
+            pointNorm = metricPolicy::norm(data[i], this->dim);
+            best = 0;
+            minRank = HUGE_VAL;
+
+            /* Farther centroids than the closest are abandoned early */
+            for(c = 0; c < this->lists; c++){
+                currRank = metricPolicy::rankBounded(data[i], &this->centroids[(size_t)c * this->dim], this->dim, pointNorm, this->centroidsNorm[c], minRank);
+
+                if(currRank < minRank){
+                    minRank = currRank;
+                    best = c;
+                }
+            } // End for - Centroids
+
+            assignments[i] = best;
+        } // End for - Points
+    };
+
+    for(i = 1; i < ranges; i++)
+        pool.push_back(thread(work, (int)((long)i * size / ranges), (int)((long)(i + 1) * size / ranges)));
+
+    work(0, (int)((long)size / ranges));
+
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+}
+
+/* Closest probes lists of a query - Sorted by rank */
+void ivf::closestLists(Item& query, vector<int>& result){
+    const double* queryData = query.getComponents().data();
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        double queryNorm = metricPolicy::norm(queryData, this->dim);
+        vector<double> ranks(this->lists);
+        int c;
+
+        for(c = 0; c < this->lists; c++)
+            ranks[c] = metricPolicy::rankBounded(queryData, &this->centroids[(size_t)c * this->dim], this->dim, queryNorm, this->centroidsNorm[c], HUGE_VAL);
+
+        result.resize(this->lists);
+        iota(result.begin(), result.end(), 0);
+        partial_sort(result.begin(), result.begin() + this->probes, result.end(), [&](int x, int y){
+            return ranks[x] < ranks[y];
+        });
+        result.resize(this->probes);
+    });
+
+    STATS_ADD(this->lastStats, distanceComputations, this->lists);
+}
+
+/* Find the radius neighbors of a given point - Points of the closest lists are scanned */
+void ivf::radiusNeighbors(Item& query, int radius, list<Item>& neighbors, list<double>* neighborsDistances, errorCode& status){
+    int i, j;
+    double currDist; // Distance of a point in list
+    vector<int> closest;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(radius < MIN_RADIUS || radius > MAX_RADIUS){
+        status = INVALID_RADIUS;
+        return;
+    }
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->lists == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    /* Clear given lists */
+    neighbors.clear();
+    if(neighborsDistances != NULL)
+        neighborsDistances->clear();
+
+    TRACE_SCOPE("ivf radiusNeighbors");
+    STATS_RESET(this->lastStats);
+
+    /* Find lists */
+    STATS_START(hashTimer);
+    this->closestLists(query, closest);
+    STATS_STOP(this->lastStats, hashTime, hashTimer);
+
+    STATS_START(scanTimer);
+
+    /* Scan lists */
+    for(i = 0; i < this->probes; i++){
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+
+        for(j = this->offsets[closest[i]]; j < this->offsets[closest[i] + 1]; j++){
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            /* Points out of radius are abandoned early */
+            if(this->metric == METRIC_EUCLIDEAN)
+                currDist = this->points[j].euclideanDist(query, radius, status);
+            else
+                currDist = this->points[j].cosineDist(query, status);
+
+            if(status != SUCCESS)
+                return;
+
+            /* Keep neighbor */
+            if(currDist < radius){
+                neighbors.push_back(this->points[j]);
+                if(neighborsDistances != NULL)
+                    neighborsDistances->push_back(currDist);
+            }
+        } // End for - Points of list
+    } // End for - Lists
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+}
+
+/* Find the nearest neighbor of a given point - Points of the closest lists are scanned */
+void ivf::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status){
+    int i, j, posMin = -1;
+    double minDist = -1; // Current minimum distance
+    double currDist; // Distance of a point in list
+    vector<int> closest;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->lists == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    TRACE_SCOPE("ivf nNeighbor");
+    STATS_RESET(this->lastStats);
+
+    /* Find lists */
+    STATS_START(hashTimer);
+    this->closestLists(query, closest);
+    STATS_STOP(this->lastStats, hashTime, hashTimer);
+
+    STATS_START(scanTimer);
+
+    /* Scan lists */
+    for(i = 0; i < this->probes; i++){
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+
+        for(j = this->offsets[closest[i]]; j < this->offsets[closest[i] + 1]; j++){
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            /* Farther points than the nearest are abandoned early */
+            if(this->metric == METRIC_EUCLIDEAN)
+                currDist = this->points[j].euclideanDist(query, (posMin == -1) ? HUGE_VAL : minDist, status);
+            else
+                currDist = this->points[j].cosineDist(query, status);
+
+            if(status != SUCCESS)
+                return;
+
+            if(posMin == -1 || minDist > currDist){
+                posMin = j;
+                minDist = currDist;
+            }
+        } // End for - Points of list
+    } // End for - Lists
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+
+    /* Empty lists */
+    if(posMin == -1){
+        status = INVALID_POINTS;
+        return;
+    }
+
+    /* Set nearest neighbor */
+    nNeighbor = this->points[posMin];
+    if(neighborDistance != NULL)
+        *neighborDistance = minDist;
+}
+
+///////////////
+/* Accessors */
+///////////////
+
+int ivf::getNumberOfPoints(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->lists == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->n;
+}
+
+int ivf::getDim(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->lists == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->dim;
+}
+
+/* Bytes of points, offsets of lists and centroids - Every allocation is counted */
+void ivf::getMemoryReport(memoryReport& report, errorCode& status){
+    int i;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->lists == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
+
+    addAllocation(this->points.capacity() * sizeof(Item), report.points, report);
+    for(i = 0; i < this->n; i++)
+        addItem(this->points[i], report);
+
+    /* Lists */
+    addAllocation(this->offsets.capacity() * sizeof(int), report.buckets, report);
+
+    /* Quantizer */
+    addAllocation(this->centroids.capacity() * sizeof(double), report.hashFunctions, report);
+    addAllocation(this->centroidsNorm.capacity() * sizeof(double), report.hashFunctions, report);
+
+    sumMemoryReport(report);
+}
+
+/* Centroids are trained on a random sample - Not saved */
+void ivf::save(string fileName, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
+}
+
+/* Occupancy of lists - Queries scan the lists of probes centroids */
+void ivf::getIndexStats(indexStats& stats, errorCode& status){
+    int i;
+    vector<int> sizes;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->lists == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    for(i = 0; i < this->lists; i++)
+        sizes.push_back(this->offsets[i + 1] - this->offsets[i]);
+
+    stats.tables.resize(1);
+    computeBucketStats(sizes, stats.tables[0]);
+
+    stats.expectedCandidates = this->probes * stats.tables[0].expectedCandidates;
+    if(stats.expectedCandidates > this->n)
+        stats.expectedCandidates = this->n;
+}
+
+/* Print statistics */
+void ivf::print(void){
+
+    if(this->lists == -1)
+        cout << "Invalid method\n";
+    else{
+
+        cout << "Ivf statistics\n";
+        cout << "Lists: " << this->lists << "\n";
+        cout << "Probes: " << this->probes << "\n";
+
+        /* Occupancy of lists */
+        if(this->fitted == 1){
+            indexStats stats;
+            errorCode status;
+
+            cout << "Dimension: " << this->dim << "\n";
+            cout << "Total points: " << this->n << "\n";
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Lists");
+        }
+    }
+}
+
+void ivf::printHashFunctions(void){
+    cout << "Ivf hasn't hash functions - Points are assigned to the closest of " << this->lists << " centroids\n\n";
+}
+
+// Petropoulakis Panagiotis
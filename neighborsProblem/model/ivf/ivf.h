@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include "../model.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+#include "../../metric/metric.h"
+
+/* Centroids are trained with Lloyd iterations on a sample of */
+/* KMEANS_SAMPLE points per list at most                      */
+#define KMEANS_ITERATIONS 20
+#define KMEANS_SAMPLE 256
+
+/* Neighbors problem using an inverted file(ivf) - Metrices: euclidean, cosine     */
+/* Points are assigned to the closest centroid of a k-means quantizer and kept in  */
+/* contiguous lists of the point table. Queries scan the probes closest lists only */
+class ivf: public model{
+    private:
+        std::vector<Item> points; // All points are kept in a single table - In order of lists
+        std::vector<int> offsets; // Points of list-i: [offsets[i], offsets[i + 1])
+        std::vector<double> centroids; // lists * dim components
+        std::vector<double> centroidsNorm; // Norms of centroids(metric.h)
+        int lists; // Number of centroids
+        int probes; // Lists scanned per query
+        int n; // Number of items
+        int dim; // Dimension
+        int fitted; // Method is fitted with data
+        std::string metrice;
+        metricType metric; // Resolved at fit
+
+        /* Call given function with the policy type of the metrice(euclideanMetric, cosineMetric) */
+        template <typename function>
+        void withMetric(function call);
+
+        /* Lloyd iterations on a sample of the points - Assignments run in parallel */
+        template <typename metricPolicy>
+        void trainCentroids(void);
+
+        /* Closest centroid of every given point - Points are split in ranges of threads */
+        template <typename metricPolicy>
+        void assignPoints(std::vector<const double*>& data, std::vector<int>& assignments);
+
+        /* Closest probes lists of a query - Sorted by rank */
+        void closestLists(Item& query, std::vector<int>& result);
+
+    public:
+
+        ivf(std::string metrice="euclidean");
+        ivf(int lists, int probes, std::string metrice, errorCode& status);
+
+        ~ivf();
+
+        void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
+
+        void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
+        void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+
+        int getNumberOfPoints(errorCode& status);
+        int getDim(errorCode& status);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
+
+        void print(void);
+        void printHashFunctions(void);
+};
+
+// Petropoulakis Panagiotis
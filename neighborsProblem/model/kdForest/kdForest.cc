@@ -0,0 +1,652 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <climits>
+#include <type_traits>
+#include <cmath>
+#include "kdForest.h"
+#include "../../indexStats/indexStats.h"
+#include "../../trace/trace.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+#include "../../metric/metric.h"
+
+using namespace std;
+
+////////////////////////////////////////
+/* Implementation of k-d forest class */
+////////////////////////////////////////
+
+/* Default constructor */
+kdForest::kdForest(string metrice):numTrees(4),checks(256),n(0),dim(0),fitted(0),metrice(metrice){}
+
+kdForest::kdForest(int trees, int checks, string metrice, errorCode& status):numTrees(trees),checks(checks),n(0),dim(0),fitted(0),metrice(metrice){
+    /* Check parameters */
+    if(trees < MIN_TREES || trees > MAX_TREES || checks < MIN_CHECKS || checks > MAX_POINTS){
+        status = INVALID_PARAMETERS;
+        this->numTrees = -1;
+    }
+}
+
+kdForest::~kdForest(){
+    int i;
+
+    /* Delete marks of queries */
+    for(i = 0; i < (int)this->freeMarks.size(); i++)
+        delete this->freeMarks[i];
+}
+
+/* Save given points and build the trees */
+void kdForest::fit(list<Item>& points, errorCode& status){
+    listStream stream(points);
+
+    this->points.reserve(points.size());
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are appended in place - Trees are built after the last point */
+void kdForest::fit(itemStream& points, errorCode& status){
+    int i, j;
+
+    status = SUCCESS;
+    TRACE_SCOPE("kd forest fit");
+
+    /* Check method */
+    if(this->numTrees == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Already fitted */
+    if(this->fitted == 1){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    /* Resolve metrice - Queries don't compare strings */
+    if(this->metrice == "euclidean")
+        this->metric = METRIC_EUCLIDEAN;
+    else if(this->metrice == "cosine")
+        this->metric = METRIC_COSINE;
+    else{
+        status = INVALID_METRICE;
+        return;
+    }
+
+    /* Copy points */
+    points.forEach([&](Item& point, errorCode& status){
+
+        /* Dimension of first point */
+        if(this->points.size() == 0)
+            this->dim = point.getDim();
+
+        if(this->dim != point.getDim() || (int)this->points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        this->points.push_back(point);
+    }, status);
+
+    /* Set members */
+    this->n = this->points.size();
+    if(status == SUCCESS && (this->n < MIN_POINTS || this->n > MAX_POINTS))
+        status = INVALID_POINTS;
+
+    if(status != SUCCESS){
+        this->points.clear();
+        this->points.shrink_to_fit();
+        return;
+    }
+
+    /* Release spare capacity of growth - Items are moved */
+    this->points.shrink_to_fit();
+
+    /* Norms of metrice */
+    this->norms.resize(this->n);
+    this->withMetric([&](auto policy){
+        for(i = 0; i < this->n; i++)
+            this->norms[i] = decltype(policy)::norm(this->points[i].getComponents().data(), this->dim);
+    });
+
+    ////////////////
+    /* Set trees */
+    ////////////////
+
+    TRACE_BEGIN(treesRegion, "kd forest trees");
+
+    this->trees.resize(this->numTrees);
+    this->indexes.resize(this->numTrees);
+
+    for(i = 0; i < this->numTrees; i++){
+        this->indexes[i].resize(this->n);
+        for(j = 0; j < this->n; j++)
+            this->indexes[i][j] = j;
+
+        /* About 2 * n / LEAF_SIZE nodes */
+        this->trees[i].reserve(2 * (this->n / LEAF_SIZE + 1));
+        this->buildTree(i, 0, this->n);
+        this->trees[i].shrink_to_fit();
+    } // End for - Trees
+
+    TRACE_END(treesRegion);
+
+    /* Method fitted */
+    this->fitted = 1;
+}
+
+/* Call given function with the policy of the metrice - Loops are instantiated per metrice */
+template <typename function>
+void kdForest::withMetric(function call){
+    switch(this->metric){
+        case METRIC_EUCLIDEAN:
+            call(euclideanMetric());
+            break;
+        case METRIC_COSINE:
+            call(cosineMetric());
+            break;
+        default:
+            break;
+    } // End switch
+}
+
+/* Marks of a query - New marks are allocated if every one is used by a running query */
+kdForest::visitedMarks* kdForest::takeMarks(void){
+    visitedMarks* visited;
+
+    {
+        lock_guard<mutex> guard(this->marksLock);
+
+        if(this->freeMarks.size() != 0){
+            visited = this->freeMarks.back();
+            this->freeMarks.pop_back();
+            return visited;
+        }
+    }
+
+    visited = new visitedMarks;
+    visited->marks.assign(this->n, 0);
+    visited->curr = 0;
+
+    return visited;
+}
+
+void kdForest::returnMarks(visitedMarks* visited){
+    lock_guard<mutex> guard(this->marksLock);
+
+    this->freeMarks.push_back(visited);
+}
+
+/* Split indexes [first, last) of given tree - Returns the new node */
+int kdForest::buildTree(int tree, int first, int last){
+    int i, j, node, count = last - first, stride, samples = 0, top, split, middle;
+    double value;
+    vector<double> mean(this->dim, 0), variance(this->dim, 0);
+    vector<int> dimensions(this->dim);
+    vector<int>& curr = this->indexes[tree];
+    treeNode newNode;
+
+    node = this->trees[tree].size();
+
+    /* Leaf */
+    if(count <= LEAF_SIZE){
+        newNode.dimension = -1;
+        newNode.value = 0;
+        newNode.left = first;
+        newNode.right = last;
+
+        this->trees[tree].push_back(newNode);
+        return node;
+    }
+
+    /* Mean and variance of a sample */
+    stride = (count > VARIANCE_SAMPLE) ? count / VARIANCE_SAMPLE : 1;
+    for(i = first; i < last; i += stride){
+        const vector<double>& components = this->points[curr[i]].getComponents();
+
+        for(j = 0; j < this->dim; j++)
+            mean[j] += components[j];
+
+        samples += 1;
+    } // End for
+
+    for(j = 0; j < this->dim; j++)
+        mean[j] /= samples;
+
+    for(i = first; i < last; i += stride){
+        const vector<double>& components = this->points[curr[i]].getComponents();
+
+        for(j = 0; j < this->dim; j++)
+            variance[j] += (components[j] - mean[j]) * (components[j] - mean[j]);
+    } // End for
+
+    /* Random dimension between the top variances */
+    for(j = 0; j < this->dim; j++)
+        dimensions[j] = j;
+
+    top = (this->dim < TOP_DIMENSIONS) ? this->dim : TOP_DIMENSIONS;
+    partial_sort(dimensions.begin(), dimensions.begin() + top, dimensions.end(), [&](int x, int y){
+        return variance[x] > variance[y];
+    });
+
+    split = dimensions[this->generator.uniformInt(0, top - 1)];
+
+    /* Split at the mean */
+    value = mean[split];
+    middle = partition(curr.begin() + first, curr.begin() + last, [&](int x){
+        return this->points[x].getComponents()[split] < value;
+    }) - curr.begin();
+
+    /* Unbalanced split - Split at the median */
+    if(middle == first || middle == last){
+        middle = first + count / 2;
+        nth_element(curr.begin() + first, curr.begin() + middle, curr.begin() + last, [&](int x, int y){
+            return this->points[x].getComponents()[split] < this->points[y].getComponents()[split];
+        });
+
+        value = this->points[curr[middle]].getComponents()[split];
+    }
+
+    newNode.dimension = split;
+    newNode.value = value;
+    this->trees[tree].push_back(newNode);
+
+    /* Children - Nodes may be moved by push_back */
+    i = this->buildTree(tree, first, middle);
+    j = this->buildTree(tree, middle, last);
+
+    this->trees[tree][node].left = i;
+    this->trees[tree][node].right = j;
+
+    return node;
+}
+
+/* Descend every tree to the leaf of the query, then continue from the closest */
+/* branch of all trees until checks points are scanned. Bounds of branches are */
+/* squared distances of the query from the split planes on the path            */
+template <typename visitor>
+void kdForest::search(Item& query, double initialBound, visitedMarks& visited, visitor visit){
+    int i, p, scanned = 0;
+    double bound = initialBound, diff;
+    const vector<double>& components = query.getComponents();
+    vector<branch> branches;
+
+    /* New search - Marks are cleared after overflow */
+    if(visited.curr == INT_MAX){
+        fill(visited.marks.begin(), visited.marks.end(), 0);
+        visited.curr = 0;
+    }
+
+    visited.curr += 1;
+
+    /* Descend from given node - Returns 0 if the search is stopped */
+    auto descend = [&](int tree, int node, double nodeBound){
+        treeNode* curr = &this->trees[tree][node];
+
+        while(curr->dimension != -1){
+            diff = components[curr->dimension] - curr->value;
+
+            /* Follow side of the query - Keep the other side */
+            if(diff < 0){
+                branches.push_back(branch(nodeBound + diff * diff, tree, curr->right));
+                curr = &this->trees[tree][curr->left];
+            }
+            else{
+                branches.push_back(branch(nodeBound + diff * diff, tree, curr->left));
+                curr = &this->trees[tree][curr->right];
+            }
+            push_heap(branches.begin(), branches.end(), branchesCompare());
+        } // End while
+
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+
+        /* Scan leaf */
+        for(i = curr->left; i < curr->right; i++){
+            p = this->indexes[tree][i];
+
+            /* Scanned from an other tree */
+            if(visited.marks[p] == visited.curr){
+                STATS_ADD(this->lastStats, duplicatesSkipped, 1);
+                continue;
+            }
+
+            visited.marks[p] = visited.curr;
+
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
+
+            bound = visit(p);
+            scanned += 1;
+
+            if(bound < 0)
+                return 0;
+        } // End for - Leaf
+
+        return 1;
+    };
+
+    /* Leaf of the query in every tree */
+    for(int tree = 0; tree < this->numTrees; tree++){
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+
+        if(descend(tree, 0, 0) == 0)
+            return;
+    } // End for - Trees
+
+    /* Closest branches */
+    while(branches.size() != 0 && scanned < this->checks){
+        pop_heap(branches.begin(), branches.end(), branchesCompare());
+        branch next = branches.back();
+        branches.pop_back();
+
+        /* Farther than the bound of visitor */
+        if(next.bound >= bound)
+            break;
+
+        if(descend(next.tree, next.node, next.bound) == 0)
+            return;
+    } // End while
+}
+
+/* Find the radius neighbors of a given point - Up to checks points are scanned */
+void kdForest::radiusNeighbors(Item& query, int radius, list<Item>& neighbors, list<double>* neighborsDistances, errorCode& status){
+    const double* queryData;
+    double queryNorm;
+    visitedMarks* visited; // Marks of this query
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(radius < MIN_RADIUS || radius > MAX_RADIUS){
+        status = INVALID_RADIUS;
+        return;
+    }
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->numTrees == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    /* Clear given lists */
+    neighbors.clear();
+    if(neighborsDistances != NULL)
+        neighborsDistances->clear();
+
+    TRACE_SCOPE("kd forest radiusNeighbors");
+    STATS_RESET(this->lastStats);
+    STATS_START(scanTimer);
+
+    queryData = query.getComponents().data();
+    visited = this->takeMarks();
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        /* Bounds of branches are squared distances - Euclidean branches out of radius are skipped */
+        const bool branchBounds = is_same<metricPolicy, euclideanMetric>::value;
+        double rankRadius = metricPolicy::rankRadius(radius), currDist;
+
+        queryNorm = metricPolicy::norm(queryData, this->dim);
+
+        this->search(query, branchBounds ? rankRadius : HUGE_VAL, *visited, [&](int p){
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            /* Points out of radius are abandoned early */
+            currDist = metricPolicy::distanceOfRank(metricPolicy::rankBounded(this->points[p].getComponents().data(), queryData, this->dim, this->norms[p], queryNorm, rankRadius));
+
+            /* Keep neighbor */
+            if(currDist < radius){
+                neighbors.push_back(this->points[p]);
+                if(neighborsDistances != NULL)
+                    neighborsDistances->push_back(currDist);
+            }
+
+            return branchBounds ? rankRadius : HUGE_VAL;
+        });
+    });
+
+    this->returnMarks(visited);
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+}
+
+/* Find the nearest neighbor of a given point - Up to checks points are scanned */
+void kdForest::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status){
+    int posMin = -1;
+    double minDist = -1; // Current minimum distance
+    const double* queryData;
+    double queryNorm;
+    visitedMarks* visited; // Marks of this query
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->numTrees == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    TRACE_SCOPE("kd forest nNeighbor");
+    STATS_RESET(this->lastStats);
+    STATS_START(scanTimer);
+
+    queryData = query.getComponents().data();
+    visited = this->takeMarks();
+
+    this->withMetric([&](auto policy){
+        typedef decltype(policy) metricPolicy;
+
+        /* Bounds of branches are squared distances - Euclidean branches farther than the nearest are skipped */
+        const bool branchBounds = is_same<metricPolicy, euclideanMetric>::value;
+        double minRank = HUGE_VAL, currRank;
+
+        queryNorm = metricPolicy::norm(queryData, this->dim);
+
+        this->search(query, HUGE_VAL, *visited, [&](int p){
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            /* Farther points than the nearest are abandoned early */
+            currRank = metricPolicy::rankBounded(this->points[p].getComponents().data(), queryData, this->dim, this->norms[p], queryNorm, minRank);
+
+            if(posMin == -1 || minRank > currRank){
+                posMin = p;
+                minRank = currRank;
+            }
+
+            return branchBounds ? minRank : HUGE_VAL;
+        });
+
+        minDist = metricPolicy::distanceOfRank(minRank);
+    });
+
+    this->returnMarks(visited);
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+
+    /* Set nearest neighbor */
+    nNeighbor = this->points[posMin];
+    if(neighborDistance != NULL)
+        *neighborDistance = minDist;
+}
+
+///////////////
+/* Accessors */
+///////////////
+
+int kdForest::getNumberOfPoints(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->numTrees == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->n;
+}
+
+int kdForest::getDim(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->numTrees == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->dim;
+}
+
+/* Bytes of points, nodes and indexes of trees - Every allocation is counted */
+void kdForest::getMemoryReport(memoryReport& report, errorCode& status){
+    int i;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->numTrees == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
+
+    addAllocation(this->points.capacity() * sizeof(Item), report.points, report);
+    for(i = 0; i < this->n; i++)
+        addItem(this->points[i], report);
+
+    addAllocation(this->norms.capacity() * sizeof(double), report.points, report);
+
+    /* Trees */
+    addAllocation(this->trees.capacity() * sizeof(vector<treeNode>), report.buckets, report);
+    addAllocation(this->indexes.capacity() * sizeof(vector<int>), report.buckets, report);
+    for(i = 0; i < this->numTrees; i++){
+        addAllocation(this->trees[i].capacity() * sizeof(treeNode), report.buckets, report);
+        addAllocation(this->indexes[i].capacity() * sizeof(int), report.buckets, report);
+    } // End for
+
+    /* Marks of queries */
+    {
+        lock_guard<mutex> guard(this->marksLock);
+
+        addAllocation(this->freeMarks.capacity() * sizeof(visitedMarks*), report.overhead, report);
+        for(i = 0; i < (int)this->freeMarks.size(); i++){
+            addAllocation(sizeof(visitedMarks), report.overhead, report);
+            addAllocation(this->freeMarks[i]->marks.capacity() * sizeof(int), report.overhead, report);
+        }
+    }
+
+    sumMemoryReport(report);
+}
+
+/* Trees are built with random dimensions - Not saved */
+void kdForest::save(string fileName, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
+}
+
+/* Occupancy of leaves of every tree */
+void kdForest::getIndexStats(indexStats& stats, errorCode& status){
+    int i, j;
+    double leavesScanned = 0;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->numTrees == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    stats.tables.resize(this->numTrees);
+    for(i = 0; i < this->numTrees; i++){
+        vector<int> sizes;
+
+        for(j = 0; j < (int)this->trees[i].size(); j++)
+            if(this->trees[i][j].dimension == -1)
+                sizes.push_back(this->trees[i][j].right - this->trees[i][j].left);
+
+        computeBucketStats(sizes, stats.tables[i]);
+        leavesScanned += stats.tables[i].expectedCandidates;
+    } // End for
+
+    /* Leaf of the query in every tree, then closest leaves up to checks points */
+    stats.expectedCandidates = max(leavesScanned, (double)this->checks);
+    if(stats.expectedCandidates > this->n)
+        stats.expectedCandidates = this->n;
+}
+
+/* Print statistics */
+void kdForest::print(void){
+
+    if(this->numTrees == -1)
+        cout << "Invalid method\n";
+    else{
+
+        cout << "K-d forest statistics\n";
+        cout << "Trees: " << this->numTrees << "\n";
+        cout << "Checks: " << this->checks << "\n";
+        cout << "Leaf size: " << LEAF_SIZE << "\n";
+
+        /* Occupancy of leaves */
+        if(this->fitted == 1){
+            indexStats stats;
+            errorCode status;
+
+            cout << "Dimension: " << this->dim << "\n";
+            cout << "Total points: " << this->n << "\n";
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Tree");
+        }
+    }
+}
+
+void kdForest::printHashFunctions(void){
+    cout << "K-d forest hasn't hash functions\n\n";
+}
+
+// Petropoulakis Panagiotis
@@ -0,0 +1,112 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <mutex>
+#include "../model.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+#include "../../metric/metric.h"
+
+/* Split dimension is chosen randomly between the TOP_DIMENSIONS dimensions with */
+/* the highest variance of a sample of VARIANCE_SAMPLE points(randomized k-d)    */
+#define TOP_DIMENSIONS 5
+#define VARIANCE_SAMPLE 100
+
+/* Max points of a leaf */
+#define LEAF_SIZE 16
+
+/* Neighbors problem using a forest of randomized k-d trees - Metrices: euclidean, cosine */
+/* Queries descend every tree and continue from the closest unexplored branches of all    */
+/* trees(best bin first) until checks points are scanned                                  */
+class kdForest: public model{
+    private:
+
+        /* Node of a tree - Leaves keep a range of the indexes of their tree */
+        typedef struct treeNode{
+            int dimension; // Split dimension - -1 for leaves
+            double value; // Split value - Left child keeps components < value
+            int left; // Child(inner node) or first index(leaf)
+            int right; // Child(inner node) or last index(leaf)
+        }treeNode;
+
+        /* Points scanned by a query - Points are in every tree. A point is scanned if its mark is curr */
+        typedef struct visitedMarks{
+            std::vector<int> marks;
+            int curr;
+        }visitedMarks;
+
+        /* Unexplored branch - With min heap */
+        typedef struct branch{
+            double bound; // Squared distance of query from the cell of the branch(lower bound of euclidean rank)
+            int tree;
+            int node;
+
+            branch(double bound, int tree, int node){
+                this->bound = bound;
+                this->tree = tree;
+                this->node = node;
+            }
+        }branch;
+
+        /* Create a compare class based in bound - Closest branch first */
+        struct branchesCompare{
+            bool operator()(const branch& x, const branch& y) const{
+                return x.bound > y.bound;
+            }
+        };
+
+        std::vector<Item> points; // All points are kept in a single table
+        std::vector<double> norms; // Norms of points(metric.h)
+        std::vector<std::vector<treeNode> > trees; // Root is node 0
+        std::vector<std::vector<int> > indexes; // Points of every tree in order of leaves
+        std::vector<visitedMarks*> freeMarks; // Marks of finished queries - A running query has its own
+        std::mutex marksLock; // Free marks - Concurrent queries
+        int numTrees;
+        int checks; // Max points scanned per query
+        int n; // Number of items
+        int dim; // Dimension
+        int fitted; // Method is fitted with data
+        std::string metrice;
+        metricType metric; // Resolved at fit
+
+        /* Call given function with the policy type of the metrice(euclideanMetric, cosineMetric) */
+        template <typename function>
+        void withMetric(function call);
+
+        /* Marks of a query - Free marks are reused, so concurrent queries never share marks */
+        visitedMarks* takeMarks(void);
+        void returnMarks(visitedMarks* visited);
+
+        /* Split indexes [first, last) of given tree - Returns the new node */
+        int buildTree(int tree, int first, int last);
+
+        /* Best bin first search of all trees - visit(point) returns the bound of branches: */
+        /* farther branches are skipped and a negative bound stops the search               */
+        template <typename visitor>
+        void search(Item& query, double initialBound, visitedMarks& visited, visitor visit);
+
+    public:
+
+        kdForest(std::string metrice="euclidean");
+        kdForest(int trees, int checks, std::string metrice, errorCode& status);
+
+        ~kdForest();
+
+        void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
+
+        void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
+        void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+
+        int getNumberOfPoints(errorCode& status);
+        int getDim(errorCode& status);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
+
+        void print(void);
+        void printHashFunctions(void);
+};
+
+// Petropoulakis Panagiotis
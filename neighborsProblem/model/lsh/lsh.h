@@ -5,6 +5,7 @@
 #include "../../item/item.h"
 #include "../../utils/utils.h"
 #include "../../hashFunction/hashFunction.h"
+#include "../../candidateFilter/candidateFilter.h"
 
 /* Neighbors problem using lsh euclidean */
 class lshEuclidean: public model{
@@ -26,6 +27,7 @@ class lshEuclidean: public model{
         int dim; // Dimension
         int w; // Window size
         int fitted; // Method is fitted with data
+        rerankStage rerankCandidates; // Nearest neighbor ranks candidates of buckets by quantized distances
     
     public:
 
@@ -36,13 +38,17 @@ class lshEuclidean: public model{
         ~lshEuclidean();
 
         void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
 
         void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
         void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+        void setRerank(int rerank, int sketch, errorCode& status);
         
         int getNumberOfPoints(errorCode& status);
         int getDim(errorCode& status);
-        unsigned size(void);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
         
         void print(void);
         void printHashFunctions(void);
@@ -60,6 +66,7 @@ class lshCosine: public model{
         int k; // Number of sub hash functions
         int dim; // Dimension
         int fitted;
+        rerankStage rerankCandidates; // Nearest neighbor ranks candidates of buckets by quantized distances or sign sketches
     
     public:
 
@@ -69,13 +76,17 @@ class lshCosine: public model{
         ~lshCosine();
 
         void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
 
         void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
         void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+        void setRerank(int rerank, int sketch, errorCode& status);
         
         int getNumberOfPoints(errorCode& status);
         int getDim(errorCode& status);
-        unsigned size(void);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
 
         void print(void);
         void printHashFunctions(void);
@@ -4,8 +4,14 @@
 #include <list>
 #include <cmath>
 #include <new>
+#include <fstream>
+#include <stdint.h>
+#include <thread>
 #include "lsh.h"
+#include "../../indexFile/indexFile.h"
 #include "../../hashFunction/hashFunction.h"
+#include "../../indexStats/indexStats.h"
+#include "../../trace/trace.h"
 #include "../../item/item.h"
 #include "../../utils/utils.h"
 
@@ -63,14 +69,27 @@ lshCosine::~lshCosine(){
 
 /* Fix hash table, members of lsh cosine and add given points in the hash tables */
 void lshCosine::fit(list<Item>& points, errorCode& status){
+    listStream stream(points);
+
+    /* Number of points is known - Avoid reallocations */
+    this->points.reserve(points.size());
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are appended in place - Hash tables are built after the last point */
+void lshCosine::fit(itemStream& points, errorCode& status){
     int i, j, p;
     int pos; // Pos(line) in current hash table
+    int threads;
+    vector<uint64_t> seeds; // Seeds of hash functions
+    vector<thread> pool;
 
     /* Iteratiors */
-    list<Item>::iterator iterPoints = points.begin(); // Iterate through points
     list<Item>::iterator iterTables;  // Iterate through table
    
     status = SUCCESS;
+    TRACE_SCOPE("lsh cosine fit");
 
     /* Check method */
     if(this->k == -1){
@@ -84,13 +103,32 @@ void lshCosine::fit(list<Item>& points, errorCode& status){
         return;
     }
 
+    /* Set points */
+    TRACE_BEGIN(readRegion, "lsh cosine read points");
+    points.forEach([&](Item& point, errorCode& status){
+        if((int)this->points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        this->points.push_back(point);
+    }, status);
+    TRACE_END(readRegion);
+
     /* Set members */
-    this->n = points.size();
-    if(this->n < MIN_POINTS || this->n > MAX_POINTS){
+    this->n = this->points.size();
+    if(status == SUCCESS && (this->n < MIN_POINTS || this->n > MAX_POINTS))
         status = INVALID_POINTS;
+
+    if(status != SUCCESS){
+        this->points.clear();
+        this->points.shrink_to_fit();
         return;
     }
 
+    /* Release spare capacity of growth - Items are moved */
+    this->points.shrink_to_fit();
+
     /* Set table size */
     this->tableSize = pow(2, this->k);
 
@@ -102,73 +140,62 @@ void lshCosine::fit(list<Item>& points, errorCode& status){
     }
 
     /* Set dimension */
-    this->dim = iterPoints->getDim();
+    this->dim = this->points[0].getDim();
     if(this->dim <= 0){
         status = INVALID_DIM;
+        this->points.clear();
         return;
     }
-    
-    /* Set points */
-    this->points.reserve(this->n);
-
-    for(iterPoints = points.begin(); iterPoints != points.end(); iterPoints++)
-        this->points.push_back(*iterPoints);
-
 
     ////////////////////////
     /* Set hash functions */
     ////////////////////////
 
-    /* Function that will be inserted in hash functions table */
-    hashFunctionCosine* newFunc = NULL;  
-   
-    for(i = 0; i < this->l; i++){
-        newFunc = new hashFunctionCosine(this->dim, this->k);
-       
-        /* Truncate same hash functions */
-        for(j = 0; j < i; j++){
-            if(this->hashFunctions[j]->compare(*newFunc, status) == 0){
-                delete newFunc;
-                break;
-            }
+    /* Hash functions of different seeds are different - Tables are split among threads */
+    this->generator.uniqueSeeds(this->l, seeds);
+    this->hashFunctions.assign(this->l, NULL);
 
-            if(status != SUCCESS){
-                delete newFunc;
-                this->k = -1;
-                break;
-            }
+    threads = thread::hardware_concurrency();
+    if(threads > this->l)
+        threads = this->l;
+    if(threads <= 0)
+        threads = 1;
 
-        } // End for
-        
-        if(status != SUCCESS)
-            break;
+    auto build = [&](int first){
+        for(int curr = first; curr < this->l; curr += threads)
+            this->hashFunctions[curr] = new hashFunctionCosine(this->dim, this->k, seeds[curr]);
+    };
+
+    for(i = 1; i < threads; i++)
+        pool.push_back(thread(build, i));
+
+    build(0);
 
-        if(i == j){
-            this->hashFunctions[i] = newFunc; // Add hash function
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+
+    for(i = 0; i < this->l; i++)
+        if(this->hashFunctions[i] == NULL){
+            status = ALLOCATION_FAILED;
+            this->k = -1;
         }
-        else
-            i -= 1;
-    } // End for - Hash functions
 
     /* Delete remaining hash functions */
     if(status != SUCCESS){
-        for(j = 0; j < i; j++)
-            delete this->hashFunctions[j];
+        for(i = 0; i < this->l; i++)
+            if(this->hashFunctions[i] != NULL)
+                delete this->hashFunctions[i];
+        this->hashFunctions.clear();
+        this->points.clear();
         return;
     }
 
-
-    /* Set points */
-    this->points.reserve(this->n);
-
-    for(iterPoints = points.begin(); iterPoints != points.end(); iterPoints++)
-        this->points.push_back(*iterPoints);
-   
     /////////////////////
     /* Set hash tables */
     /////////////////////
 
     /* Scan each table */
+    TRACE_BEGIN(tablesRegion, "lsh cosine hash tables");
     for(i = 0; i < this->l; i++){
     
         /* Scan given points */
@@ -200,6 +227,17 @@ void lshCosine::fit(list<Item>& points, errorCode& status){
         if(status != SUCCESS)
             break;
     } // End for - Hash tables
+    TRACE_END(tablesRegion);
+
+    /* Compressed points of the rerank stage */
+    if(status == SUCCESS){
+        vector<Item*> candidatePoints(this->n);
+
+        for(p = 0; p < this->n; p++)
+            candidatePoints[p] = &(this->points[p]);
+
+        this->rerankCandidates.fit(candidatePoints, this->generator.next(), status);
+    }
   
     /* Error occured - Clear structures */
     if(status != SUCCESS){
@@ -254,20 +292,34 @@ void lshCosine::radiusNeighbors(Item& query, int radius, list<Item>& neighbors,
     if(neighborsDistances != NULL)
         neighborsDistances->clear();
 
+    TRACE_SCOPE("lsh cosine radiusNeighbors");
+    STATS_RESET(this->lastStats);
+
     /* Scan all tables */
     for(i = 0; i < this->l; i++){
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+        STATS_START(hashTimer);
+        TRACE_BEGIN(hashRegion, "lsh cosine hash");
     
         /* Find position in table */
         pos = this->hashFunctions[i]->hash(query, status);
         if(status != SUCCESS)
             return;
 
+        STATS_STOP(this->lastStats, hashTime, hashTimer);
+        TRACE_END(hashRegion);
+
         /* Empty list */
         if(this->tables[i][pos].size() == 0)
             continue;
 
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+        STATS_START(scanTimer);
+        TRACE_BEGIN(scanRegion, "lsh cosine scan");
+
         /* Scan list of specific bucket */
         for(iter = this->tables[i][pos].begin(); iter != this->tables[i][pos].end(); iter++){  
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
 
             ptrPoint = *iter;
             currId = ptrPoint->getId();
@@ -277,6 +329,8 @@ void lshCosine::radiusNeighbors(Item& query, int radius, list<Item>& neighbors,
             currDist = ptrPoint->cosineDist(query, status);
             if(status != SUCCESS)
                 return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
             
             /* Keep neighbor */
             if(currDist < radius){
@@ -285,15 +339,22 @@ void lshCosine::radiusNeighbors(Item& query, int radius, list<Item>& neighbors,
                     visited.insert(currId);
                 }
                 /* Vidited - Discard it */
-                else
+                else{
+                    STATS_ADD(this->lastStats, duplicatesSkipped, 1);
                     continue;
+                }
 
                 neighbors.push_back(*ptrPoint);
                 if(neighborsDistances != NULL)
                     neighborsDistances->push_back(currDist);
             }
         } // End for - Scan list
+
+        STATS_STOP(this->lastStats, scanTime, scanTimer);
+        TRACE_END(scanRegion);
     } // End for - Tables
+
+    STATS_RECORD(this->stats, this->lastStats);
 }
 
 /* Find the nearest neighbor of a given point */
@@ -304,6 +365,8 @@ void lshCosine::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance
     list<Item*>::iterator iter;
     Item* ptrPoint;
     Item* nearestPtr;
+    int rerank = this->rerankCandidates.enabled(); // Two stage search
+    rerankQuery scratch; // Candidates of the rerank stage - One per call
 
     status = SUCCESS;
 
@@ -318,27 +381,56 @@ void lshCosine::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance
         return;
     }
 
+    TRACE_SCOPE("lsh cosine nNeighbor");
+    STATS_RESET(this->lastStats);
+
+    if(rerank == 1){
+        this->rerankCandidates.begin(query, scratch, status);
+        if(status != SUCCESS)
+            return;
+    }
+
     /* Scan all tables */
     for(i = 0; i < this->l; i++){
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+        STATS_START(hashTimer);
+        TRACE_BEGIN(hashRegion, "lsh cosine hash");
     
         /* Find position in table */
         pos = this->hashFunctions[i]->hash(query, status);
         if(status != SUCCESS)
             return;
 
+        STATS_STOP(this->lastStats, hashTime, hashTimer);
+        TRACE_END(hashRegion);
+
         /* Empty list */
         if(this->tables[i][pos].size() == 0)
             continue;
 
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+        STATS_START(scanTimer);
+        TRACE_BEGIN(scanRegion, "lsh cosine scan");
+
         /* Scan list of specific bucket */
         for(iter = this->tables[i][pos].begin(); iter != this->tables[i][pos].end(); iter++){  
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
 
             ptrPoint = *iter;
 
+            /* Rank candidate by quantized distance - Exact distances are found after the scan */
+            if(rerank == 1){
+                if(this->rerankCandidates.add(scratch, ptrPoint - &(this->points[0])) == 0)
+                    STATS_ADD(this->lastStats, duplicatesSkipped, 1);
+                continue;
+            }
+
             /* Find current distance */
             currDist = ptrPoint->cosineDist(query, status);
             if(status != SUCCESS)
                 return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
             
             /* First neighbor */
             if(flag == 0){     
@@ -357,8 +449,36 @@ void lshCosine::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance
                 nearestPtr = ptrPoint;
             }
         } // End for - Scan list
+
+        STATS_STOP(this->lastStats, scanTime, scanTimer);
+        TRACE_END(scanRegion);
     } // End for - Tables
 
+    /* Exact distances of the best candidates */
+    if(rerank == 1){
+        vector<pair<double, int> >& candidates = this->rerankCandidates.candidates(scratch);
+
+        STATS_START(rerankTimer);
+        for(i = 0; i < (int)candidates.size(); i++){
+            ptrPoint = &(this->points[candidates[i].second]);
+
+            currDist = ptrPoint->cosineDist(query, status);
+            if(status != SUCCESS)
+                return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            if(found == 0 || minDist > currDist){
+                minDist = currDist;
+                nearestPtr = ptrPoint;
+                found = 1;
+            }
+        } // End for - Candidates
+        STATS_STOP(this->lastStats, scanTime, rerankTimer);
+    }
+
+    STATS_RECORD(this->stats, this->lastStats);
+
     /* Nearest neighbor found */
     if(found == 1){
         nNeighbor = *nearestPtr;
@@ -372,6 +492,25 @@ void lshCosine::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance
     }
 }
 
+/* Candidates checked with exact distances by nearest neighbor - Radius neighbors stay exact */
+/* Candidates are ranked by quantized distances or by sign sketches(sketch 1)                */
+void lshCosine::setRerank(int rerank, int sketch, errorCode& status){
+    status = SUCCESS;
+
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Compressed points are built at fit */
+    if(this->fitted == 1){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    this->rerankCandidates.setRerank(rerank, (sketch == 1) ? FILTER_SIGN_SKETCH : FILTER_QUANTIZED_COSINE, status);
+}
+
 ///////////////
 /* Accessors */
 ///////////////
@@ -406,62 +545,172 @@ int lshCosine::getDim(errorCode& status){
         return this->dim;
 }
 
-unsigned lshCosine::size(void){
-    unsigned result = 0;
+/* Bytes of points, hash tables and hash functions - Every allocation is counted */
+void lshCosine::getMemoryReport(memoryReport& report, errorCode& status){
+    int i, j;
 
-    if(fitted == 0){
-        return -1;
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
     }
-    
+
     if(this->k == -1){
-        return -1;
+        status = INVALID_METHOD;
+        return;
     }
-    
-    result += sizeof(this->tableSize);
-    result += sizeof(this->n);
-    result += sizeof(this->l);
-    result += sizeof(this->k);
-    result += sizeof(this->dim);
-    result += sizeof(this->fitted);
-    
-    int i, j;
 
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
+
+    /* Points */
+    addAllocation(this->points.capacity() * sizeof(Item), report.points, report);
+    for(i = 0; i < this->n; i++)
+        addItem(this->points[i], report);
+
+    /* Hash functions */
+    addAllocation(this->hashFunctions.capacity() * sizeof(hashFunction*), report.hashFunctions, report);
+    for(i = 0; i < this->l; i++)
+        report.hashFunctions += this->hashFunctions[i]->size();
+
+    /* Tables: buckets and nodes of pointers */
+    addAllocation(this->tables.capacity() * sizeof(vector<list<Item*> >), report.buckets, report);
     for(i = 0; i < this->l; i++){
-        result += this->hashFunctions[i]->size();
-    }
+        addAllocation(this->tables[i].capacity() * sizeof(list<Item*>), report.buckets, report);
+
+        for(j = 0; j < this->tableSize; j++)
+            addAllocation(LIST_NODE_BYTES(Item*), report.buckets, report, this->tables[i][j].size());
+    } // End for - Tables
 
-    result += this->hashFunctions.capacity() * sizeof(hashFunction*);
+    /* Quantized points */
+    this->rerankCandidates.getMemoryReport(report);
 
-    result += sizeof(hashFunctions);
+    sumMemoryReport(report);
+}
 
+/* Save hash functions, points and hash tables in a binary index file */
+/* Buckets are flattened: offsets per bucket and positions of points  */
+void lshCosine::save(string fileName, errorCode& status){
+    int i, j;
+    int32_t currOffset, currPos;
+    ofstream file;
+    indexHeader header;
     list<Item*>::iterator iter;
 
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    file.open(fileName, ios::binary | ios::trunc);
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    /* Set header */
+    initIndexHeader(header);
+    header.type = INDEX_LSH_COSINE;
+    header.metrice = INDEX_COSINE;
+    header.n = this->n;
+    header.dim = this->dim;
+    header.l = this->l;
+    header.k = this->k;
+    header.tableSize = this->tableSize;
+
+    writeIndexHeader(file, header, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Write hash functions */
+    for(i = 0; i < this->l; i++){
+        this->hashFunctions[i]->save(file, status);
+        if(status != SUCCESS)
+            return;
+    }
+
+    /* Write points */
+    writeIndexPoints(file, this->points, header, status);
+    if(status != SUCCESS)
+        return;
+
+    /* First entry of each bucket */
+    header.bucketOffsetsOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
+
     for(i = 0; i < this->l; i++){
+        currOffset = 0;
+        file.write((const char*)&currOffset, sizeof(int32_t));
+
         for(j = 0; j < this->tableSize; j++){
-            for(iter = this->tables[i][j].begin(); iter != this->tables[i][j].end(); iter++){
-                result += sizeof(Item*);
-            } // End for - iter
-        } // End for - table size
-    } // End for - l
+            currOffset += this->tables[i][j].size();
+            file.write((const char*)&currOffset, sizeof(int32_t));
+        }
+    } // End for - Tables
+
+    /* Positions of points in each bucket */
+    header.bucketEntriesOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
 
     for(i = 0; i < this->l; i++){
         for(j = 0; j < this->tableSize; j++){
-            result += sizeof(list<Item>);
-        } // End for - table size
-    } // End for - l
+            for(iter = this->tables[i][j].begin(); iter != this->tables[i][j].end(); iter++){
+                currPos = *iter - &(this->points[0]);
+                file.write((const char*)&currPos, sizeof(int32_t));
+            }
+        }
+    } // End for - Tables
 
-    result += this->tables.capacity() * sizeof(vector<list<Item> >);
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
 
-    for(i = 0; i < this->n; i++)
-        result += this->points[i].size();
+    /* Fix offsets */
+    header.fileSize = file.tellp();
+    writeIndexHeader(file, header, status);
+}
 
-    result += this->points.capacity() * sizeof(Item);
+/* Occupancy of buckets of every table */
+void lshCosine::getIndexStats(indexStats& stats, errorCode& status){
+    int i, j;
+    vector<int> sizes(this->tableSize);
 
-    result += sizeof(this->points);
+    status = SUCCESS;
 
-    result += sizeof(this->tables);
-    
-    return result;
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    stats.tables.resize(this->l);
+    stats.expectedCandidates = 0;
+
+    for(i = 0; i < this->l; i++){
+        for(j = 0; j < this->tableSize; j++)
+            sizes[j] = this->tables[i][j].size();
+
+        computeBucketStats(sizes, stats.tables[i]);
+        stats.expectedCandidates += stats.tables[i].expectedCandidates;
+    } // End for - Tables
 }
 
 /* Print statistics */
@@ -474,7 +723,18 @@ void lshCosine::print(void){
         cout << "Lsh Cosine statistics\n";
         cout << "Number of hash tables(l): " << this->l << "\n";
         cout << "Size per table: " << this->tableSize << "\n";
-        cout << "Number of sub hash functions(k): " << this->k << "\n\n";
+        cout << "Number of sub hash functions(k): " << this->k << "\n";
+        cout << "Candidates reranked: " << this->rerankCandidates.getRerank() << "\n\n";
+
+        /* Occupancy of buckets */
+        if(this->fitted == 1){
+            indexStats stats;
+            errorCode status;
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Table");
+        }
     }
 }
 
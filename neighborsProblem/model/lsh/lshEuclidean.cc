@@ -4,8 +4,14 @@
 #include <cmath>
 #include <unordered_set>
 #include <new>
+#include <fstream>
+#include <stdint.h>
+#include <thread>
 #include "lsh.h"
+#include "../../indexFile/indexFile.h"
 #include "../../hashFunction/hashFunction.h"
+#include "../../indexStats/indexStats.h"
+#include "../../trace/trace.h"
 #include "../../item/item.h"
 #include "../../utils/utils.h"
 
@@ -82,15 +88,28 @@ lshEuclidean::~lshEuclidean(){
 
 /* Fix hash table, members of lsh euclidean and add given points in the hash tables */
 void lshEuclidean::fit(list<Item>& points, errorCode& status){
+    listStream stream(points);
+
+    /* Number of points is known - Avoid reallocations */
+    this->points.reserve(points.size());
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are appended in place - Hash tables are built after the last point */
+void lshEuclidean::fit(itemStream& points, errorCode& status){
     int i, j, p;
     int pos; // Pos(line) in current hash table
+    int threads;
+    vector<uint64_t> seeds; // Seeds of hash functions
+    vector<thread> pool;
     entry newEntry;
 
     /* Iteratiors */
-    list<Item>::iterator iterPoints = points.begin(); // Iterate through points
     list<entry>::iterator iterEntries;  // Iterate through entries
 
     status = SUCCESS;
+    TRACE_SCOPE("lsh euclidean fit");
 
     /* Check method */
     if(this->k == -1){
@@ -104,12 +123,31 @@ void lshEuclidean::fit(list<Item>& points, errorCode& status){
         return;
     }
 
+    /* Set points */
+    TRACE_BEGIN(readRegion, "lsh euclidean read points");
+    points.forEach([&](Item& point, errorCode& status){
+        if((int)this->points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        this->points.push_back(point);
+    }, status);
+    TRACE_END(readRegion);
+
     /* Set members */
-    this->n = points.size();
-    if(this->n < MIN_POINTS || this->n > MAX_POINTS){
+    this->n = this->points.size();
+    if(status == SUCCESS && (this->n < MIN_POINTS || this->n > MAX_POINTS))
         status = INVALID_POINTS;
+
+    if(status != SUCCESS){
+        this->points.clear();
+        this->points.shrink_to_fit();
         return;
     }
+
+    /* Release spare capacity of growth - Items are moved */
+    this->points.shrink_to_fit();
     
     /* Set table size */
     this->tableSize = (int)(this->n * this->coefficient);
@@ -125,9 +163,10 @@ void lshEuclidean::fit(list<Item>& points, errorCode& status){
     }
 
     /* Set dimension */
-    this->dim = iterPoints->getDim();
+    this->dim = this->points[0].getDim();
     if(this->dim <= 0){
         status = INVALID_DIM;
+        this->points.clear();
         return;
     }
     
@@ -135,59 +174,51 @@ void lshEuclidean::fit(list<Item>& points, errorCode& status){
     /* Set hash functions */
     ////////////////////////
 
-    /* Function that will be inserted in hash functions table */
-    hashFunctionEuclidean* newFunc = NULL;  
+    /* Hash functions of different seeds are different - Tables are split among threads */
+    this->generator.uniqueSeeds(this->l, seeds);
+    this->hashFunctions.assign(this->l, NULL);
 
-    for(i = 0; i < this->l; i++){
-        newFunc = new hashFunctionEuclidean(this->dim, this->k, this->w, this->tableSize); 
-        if(newFunc == NULL){
-            status = ALLOCATION_FAILED;
-            this->k = -1;
-            break;
-        }
+    threads = thread::hardware_concurrency();
+    if(threads > this->l)
+        threads = this->l;
+    if(threads <= 0)
+        threads = 1;
 
-        /* Truncate same hash functions */
-        for(j = 0; j < i; j++){
-            if(this->hashFunctions[j]->compare(*newFunc,status) == 0){
-                delete newFunc;
-                break;
-            }
+    auto build = [&](int first){
+        for(int curr = first; curr < this->l; curr += threads)
+            this->hashFunctions[curr] = new hashFunctionEuclidean(this->dim, this->k, this->w, this->tableSize, seeds[curr]);
+    };
 
-            if(status != SUCCESS){
-                delete newFunc;
-                this->k = -1;
-                break;
-            }
-        } // End for
-        
-        if(status != SUCCESS)
-            break;
+    for(i = 1; i < threads; i++)
+        pool.push_back(thread(build, i));
+
+    build(0);
 
-        if(i == j){
-            this->hashFunctions.push_back(newFunc); // Add hash function
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+
+    for(i = 0; i < this->l; i++)
+        if(this->hashFunctions[i] == NULL){
+            status = ALLOCATION_FAILED;
+            this->k = -1;
         }
-        else
-            i -= 1;
-    } // End for - Hash functions
 
     /* Delete remaining hash functions */
     if(status != SUCCESS){
-        for(j = 0; j < i; j++)
-            delete this->hashFunctions[j];
+        for(i = 0; i < this->l; i++)
+            if(this->hashFunctions[i] != NULL)
+                delete this->hashFunctions[i];
+        this->hashFunctions.clear();
+        this->points.clear();
         return;
     }
 
-    /* Set points */
-    this->points.reserve(this->n);
-
-    for(iterPoints = points.begin(); iterPoints != points.end(); iterPoints++)
-        this->points.push_back(*iterPoints);
-
     /////////////////////
     /* Set hash tables */
     /////////////////////
     
     /* Scan each table */
+    TRACE_BEGIN(tablesRegion, "lsh euclidean hash tables");
     for(i = 0; i < this->l; i++){
     
         /* Scan points */
@@ -233,6 +264,17 @@ void lshEuclidean::fit(list<Item>& points, errorCode& status){
         if(status != SUCCESS)
             break;
     } // End for - Hash tables
+    TRACE_END(tablesRegion);
+
+    /* Compressed points of the rerank stage */
+    if(status == SUCCESS){
+        vector<Item*> candidatePoints(this->n);
+
+        for(p = 0; p < this->n; p++)
+            candidatePoints[p] = &(this->points[p]);
+
+        this->rerankCandidates.fit(candidatePoints, this->generator.next(), status);
+    }
   
     /* Error occured - Clear structures */
     if(status != SUCCESS){
@@ -285,18 +327,28 @@ void lshEuclidean::radiusNeighbors(Item& query, int radius, list<Item>& neighbor
     if(neighborsDistances != NULL)
         neighborsDistances->clear();
 
+    TRACE_SCOPE("lsh euclidean radiusNeighbors");
+    STATS_RESET(this->lastStats);
+
     /* Scan all tables */
     for(i = 0; i < this->l; i++){
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+        STATS_START(hashTimer);
+        TRACE_BEGIN(hashRegion, "lsh euclidean hash");
     
         /* Find position in table */
         pos = this->hashFunctions[i]->hash(query, status);
         if(status != SUCCESS)
             return;
 
+        STATS_STOP(this->lastStats, hashTime, hashTimer);
+
         /* Empty list */
         if(this->tables[i][pos].size() == 0)
             continue;
 
+        STATS_START(valueGTimer);
+
         /* Find value g for query */
         vector<int> valueG;
         for(j = 0; j < this->k; j++){
@@ -307,19 +359,30 @@ void lshEuclidean::radiusNeighbors(Item& query, int radius, list<Item>& neighbor
             }
         } // End for
 
+        STATS_STOP(this->lastStats, hashTime, valueGTimer);
+        TRACE_END(hashRegion);
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+        STATS_START(scanTimer);
+        TRACE_BEGIN(scanRegion, "lsh euclidean scan");
+
         /* Scan list of specific bucket */
         for(iter = this->tables[i][pos].begin(); iter != this->tables[i][pos].end(); iter++){  
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
             
             currId = iter->point->getId();
 
             /* Compare values g of query and current point */
-            if(!equal(valueG.begin(), valueG.end(), iter->valueG.begin()))
+            if(!equal(valueG.begin(), valueG.end(), iter->valueG.begin())){
+                STATS_ADD(this->lastStats, rejectionsG, 1);
                 continue;
+            }
 
-            /* Find current distance */
-            currDist = iter->point->euclideanDist(query, status);
+            /* Find current distance - Points out of radius are abandoned early */
+            currDist = iter->point->euclideanDist(query, radius, status);
             if(status != SUCCESS)
                 return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
            
             /* Keep neighbor */
             if(currDist < radius){
@@ -328,15 +391,22 @@ void lshEuclidean::radiusNeighbors(Item& query, int radius, list<Item>& neighbor
                     visited.insert(currId);
                 }
                 /* Vidited - Discard it */
-                else
+                else{
+                    STATS_ADD(this->lastStats, duplicatesSkipped, 1);
                     continue;
+                }
                 
                 neighbors.push_back(*(iter->point));
                 if(neighborsDistances != NULL)
                     neighborsDistances->push_back(currDist);
             }
         } // End for - Scan list
+
+        STATS_STOP(this->lastStats, scanTime, scanTimer);
+        TRACE_END(scanRegion);
     } // End for - Tables
+
+    STATS_RECORD(this->stats, this->lastStats);
 }
 
 /* Find the nearest neighbor of a given point */
@@ -345,7 +415,10 @@ void lshEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighborDista
     double minDist = -1; // Current minimum distance 
     double currDist; // Distance of a point in list
     list<entry>::iterator iter;
-    list<entry>::iterator iterNearestNeighbor;
+    Item* ptrPoint;
+    Item* nearestPtr;
+    int rerank = this->rerankCandidates.enabled(); // Two stage search
+    rerankQuery scratch; // Candidates of the rerank stage - One per call
     
     status = SUCCESS;
 
@@ -360,18 +433,34 @@ void lshEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighborDista
         return;
     }
 
+    TRACE_SCOPE("lsh euclidean nNeighbor");
+    STATS_RESET(this->lastStats);
+
+    if(rerank == 1){
+        this->rerankCandidates.begin(query, scratch, status);
+        if(status != SUCCESS)
+            return;
+    }
+
     /* Scan all tables */
     for(i = 0; i < this->l; i++){
+        STATS_ADD(this->lastStats, tablesProbed, 1);
+        STATS_START(hashTimer);
+        TRACE_BEGIN(hashRegion, "lsh euclidean hash");
     
         /* Find position in table */
         pos = this->hashFunctions[i]->hash(query, status);
         if(status != SUCCESS)
             return;
 
+        STATS_STOP(this->lastStats, hashTime, hashTimer);
+
         /* Empty list */
         if(this->tables[i][pos].size() == 0)
             continue;
 
+        STATS_START(valueGTimer);
+
         /* Find value g for query */
         vector<int> valueG;
         for(j = 0; j < k; j++){
@@ -381,24 +470,41 @@ void lshEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighborDista
                 break;
             }
         } // End for
+
+        STATS_STOP(this->lastStats, hashTime, valueGTimer);
+        TRACE_END(hashRegion);
+        STATS_ADD(this->lastStats, bucketsVisited, 1);
+        STATS_START(scanTimer);
+        TRACE_BEGIN(scanRegion, "lsh euclidean scan");
         
         /* Scan list of specific bucket */
         for(iter = this->tables[i][pos].begin(); iter != this->tables[i][pos].end(); iter++){  
-
+            STATS_ADD(this->lastStats, candidatesScanned, 1);
                         
             /* Compare values g of query and current point */
-            if(!equal(valueG.begin(), valueG.end(), iter->valueG.begin()))
+            if(!equal(valueG.begin(), valueG.end(), iter->valueG.begin())){
+                STATS_ADD(this->lastStats, rejectionsG, 1);
                 continue;            
+            }
+
+            /* Rank candidate by quantized distance - Exact distances are found after the scan */
+            if(rerank == 1){
+                if(this->rerankCandidates.add(scratch, iter->point - &(this->points[0])) == 0)
+                    STATS_ADD(this->lastStats, duplicatesSkipped, 1);
+                continue;
+            }
 
-            /* Find current distance */
-            currDist = iter->point->euclideanDist(query, status);
+            /* Find current distance - Farther points than the nearest are abandoned early */
+            currDist = iter->point->euclideanDist(query, (flag == 0) ? HUGE_VAL : minDist, status);
             if(status != SUCCESS)
                 return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
             
             /* First neighbor */
             if(flag == 0){
                 minDist = currDist;
-                iterNearestNeighbor = iter;
+                nearestPtr = iter->point;
                 
                 found = 1;
                 flag = 1;
@@ -407,14 +513,42 @@ void lshEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighborDista
             /* Change min distance */
             else if(minDist > currDist){
                 minDist = currDist;
-                iterNearestNeighbor = iter;
+                nearestPtr = iter->point;
             }
         } // End for - Scan list
+
+        STATS_STOP(this->lastStats, scanTime, scanTimer);
+        TRACE_END(scanRegion);
     } // End for - Tables
 
+    /* Exact distances of the best candidates */
+    if(rerank == 1){
+        vector<pair<double, int> >& candidates = this->rerankCandidates.candidates(scratch);
+
+        STATS_START(rerankTimer);
+        for(i = 0; i < (int)candidates.size(); i++){
+            ptrPoint = &(this->points[candidates[i].second]);
+
+            currDist = ptrPoint->euclideanDist(query, (found == 0) ? HUGE_VAL : minDist, status);
+            if(status != SUCCESS)
+                return;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            if(found == 0 || minDist > currDist){
+                minDist = currDist;
+                nearestPtr = ptrPoint;
+                found = 1;
+            }
+        } // End for - Candidates
+        STATS_STOP(this->lastStats, scanTime, rerankTimer);
+    }
+
+    STATS_RECORD(this->stats, this->lastStats);
+
     /* Nearest neighbor found */
     if(found == 1){
-        nNeighbor = *(iterNearestNeighbor->point);
+        nNeighbor = *nearestPtr;
         if(neighborDistance != NULL)
             *neighborDistance = minDist;
     }
@@ -425,6 +559,30 @@ void lshEuclidean::nNeighbor(Item& query, Item& nNeighbor, double* neighborDista
     }
 }
 
+/* Candidates checked with exact distances by nearest neighbor - Radius neighbors stay exact */
+void lshEuclidean::setRerank(int rerank, int sketch, errorCode& status){
+    status = SUCCESS;
+
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Compressed points are built at fit */
+    if(this->fitted == 1){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    /* Sign sketches estimate angles only */
+    if(sketch != 0){
+        status = INVALID_PARAMETERS;
+        return;
+    }
+
+    this->rerankCandidates.setRerank(rerank, FILTER_QUANTIZED_EUCLIDEAN, status);
+}
+
 ///////////////
 /* Accessors */
 ///////////////
@@ -459,67 +617,187 @@ int lshEuclidean::getDim(errorCode& status){
         return this->dim;
 }
 
-unsigned lshEuclidean::size(void){
-    unsigned result = 0;
+/* Bytes of points, hash tables and hash functions - Every allocation is counted */
+void lshEuclidean::getMemoryReport(memoryReport& report, errorCode& status){
+    int i, j;
+    list<entry>::iterator iter;
 
-    if(fitted == 0){
-        return -1;
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
     }
-    
+
     if(this->k == -1){
-        return -1;
+        status = INVALID_METHOD;
+        return;
     }
 
-    
-    result += sizeof(this->tableSize);
-    result += sizeof(this->coefficient);
-    result += sizeof(this->n);
-    result += sizeof(this->l);
-    result += sizeof(this->k);
-    result += sizeof(this->dim);
-    result += sizeof(this->w);
-    result += sizeof(this->fitted);
-    
-    int i, j;
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
+
+    /* Points */
+    addAllocation(this->points.capacity() * sizeof(Item), report.points, report);
+    for(i = 0; i < this->n; i++)
+        addItem(this->points[i], report);
 
+    /* Hash functions */
+    addAllocation(this->hashFunctions.capacity() * sizeof(hashFunction*), report.hashFunctions, report);
     for(i = 0; i < this->l; i++)
-        result += this->hashFunctions[i]->size();
+        report.hashFunctions += this->hashFunctions[i]->size();
 
-    result += this->hashFunctions.capacity() * sizeof(hashFunction*);
+    /* Tables: buckets, nodes of entries and values g */
+    addAllocation(this->tables.capacity() * sizeof(vector<list<entry> >), report.buckets, report);
+    for(i = 0; i < this->l; i++){
+        addAllocation(this->tables[i].capacity() * sizeof(list<entry>), report.buckets, report);
 
-    result += sizeof(hashFunctions);
+        for(j = 0; j < this->tableSize; j++){
+            addAllocation(LIST_NODE_BYTES(entry), report.buckets, report, this->tables[i][j].size());
 
+            for(iter = this->tables[i][j].begin(); iter != this->tables[i][j].end(); iter++)
+                addAllocation(iter->valueG.capacity() * sizeof(int), report.buckets, report);
+        } // End for - Buckets
+    } // End for - Tables
+
+    /* Quantized points */
+    this->rerankCandidates.getMemoryReport(report);
+
+    sumMemoryReport(report);
+}
+
+/* Save hash functions, points and hash tables in a binary index file */
+/* Buckets are flattened: offsets per bucket and positions of points  */
+void lshEuclidean::save(string fileName, errorCode& status){
+    int i, j;
+    int32_t currOffset, currPos;
+    ofstream file;
+    indexHeader header;
     list<entry>::iterator iter;
 
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    file.open(fileName, ios::binary | ios::trunc);
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    /* Set header */
+    initIndexHeader(header);
+    header.type = INDEX_LSH_EUCLIDEAN;
+    header.metrice = INDEX_EUCLIDEAN;
+    header.n = this->n;
+    header.dim = this->dim;
+    header.l = this->l;
+    header.k = this->k;
+    header.tableSize = this->tableSize;
+
+    writeIndexHeader(file, header, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Write hash functions */
+    for(i = 0; i < this->l; i++){
+        this->hashFunctions[i]->save(file, status);
+        if(status != SUCCESS)
+            return;
+    }
+
+    /* Write points */
+    writeIndexPoints(file, this->points, header, status);
+    if(status != SUCCESS)
+        return;
+
+    /* First entry of each bucket */
+    header.bucketOffsetsOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
+
     for(i = 0; i < this->l; i++){
+        currOffset = 0;
+        file.write((const char*)&currOffset, sizeof(int32_t));
+
         for(j = 0; j < this->tableSize; j++){
-            for(iter = this->tables[i][j].begin(); iter!= this->tables[i][j].end(); iter++){
-                result += sizeof(Item*);
+            currOffset += this->tables[i][j].size();
+            file.write((const char*)&currOffset, sizeof(int32_t));
+        }
+    } // End for - Tables
 
-                result += iter->valueG.capacity() * sizeof(int);
-                result += sizeof(iter->valueG);
-            } // End for - iter
-        } // End for - table size
-    } // End for - l
+    /* Positions of points in each bucket */
+    header.bucketEntriesOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
 
     for(i = 0; i < this->l; i++){
         for(j = 0; j < this->tableSize; j++){
-            result += sizeof(list<entry>);
-        } // End for - table size
-    } // End for - l
+            for(iter = this->tables[i][j].begin(); iter != this->tables[i][j].end(); iter++){
+                currPos = iter->point - &(this->points[0]);
+                file.write((const char*)&currPos, sizeof(int32_t));
+            }
+        }
+    } // End for - Tables
 
-    result += this->tables.capacity() * sizeof(vector<list<entry> >);
+    /* Values g of entries - Same order with entries */
+    header.valuesGOffset = beginIndexSection(file, status);
+    if(status != SUCCESS)
+        return;
 
-    result += sizeof(this->tables);
+    for(i = 0; i < this->l; i++)
+        for(j = 0; j < this->tableSize; j++)
+            for(iter = this->tables[i][j].begin(); iter != this->tables[i][j].end(); iter++)
+                file.write((const char*)iter->valueG.data(), sizeof(int) * this->k);
 
-    for(i = 0; i < this->n; i++)
-        result += this->points[i].size();
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
 
-    result += sizeof(Item) * this->points.capacity();
+    /* Fix offsets */
+    header.fileSize = file.tellp();
+    writeIndexHeader(file, header, status);
+}
+
+/* Occupancy of buckets of every table */
+void lshEuclidean::getIndexStats(indexStats& stats, errorCode& status){
+    int i, j;
+    vector<int> sizes(this->tableSize);
 
-    result += sizeof(this->points);
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
 
-    return result;
+    if(this->k == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    stats.tables.resize(this->l);
+    stats.expectedCandidates = 0;
+
+    for(i = 0; i < this->l; i++){
+        for(j = 0; j < this->tableSize; j++)
+            sizes[j] = this->tables[i][j].size();
+
+        computeBucketStats(sizes, stats.tables[i]);
+        stats.expectedCandidates += stats.tables[i].expectedCandidates;
+    } // End for - Tables
 }
 
 /* Print statistics */
@@ -534,7 +812,18 @@ void lshEuclidean::print(void){
         cout << "Size per table: " << this->tableSize << "\n";
         cout << "Coefficient factor: " << this->coefficient << "\n";
         cout << "Window size(w): " << this->w << "\n";
-        cout << "Number of sub hash functions(k): " << this->k << "\n\n";
+        cout << "Number of sub hash functions(k): " << this->k << "\n";
+        cout << "Candidates reranked: " << this->rerankCandidates.getRerank() << "\n\n";
+
+        /* Occupancy of buckets */
+        if(this->fitted == 1){
+            indexStats stats;
+            errorCode status;
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Table");
+        }
     }
 }
 
@@ -0,0 +1,603 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <unordered_set>
+#include <stdint.h>
+#include "mappedIndex.h"
+#include "../../indexFile/indexFile.h"
+#include "../../hashFunction/hashFunction.h"
+#include "../../indexStats/indexStats.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+
+using namespace std;
+
+/* Check that an array of the mapped file is inside the file */
+static int validSection(uint64_t offset, uint64_t bytes, uint64_t length){
+    if(offset % INDEX_ALIGNMENT != 0 || offset > length || bytes > length - offset)
+        return 0;
+
+    return 1;
+}
+
+/////////////////////////////////////////
+/* Implementation of mapped index class */
+/////////////////////////////////////////
+
+/* Read header and hash functions, map points and buckets */
+mappedIndex::mappedIndex(string fileName, errorCode& status):data(NULL),length(0),points(NULL),idOffsets(NULL),ids(NULL),bucketOffsets(NULL),bucketEntries(NULL),valuesG(NULL),type(0),metrice(0),tableSize(0),n(0),l(0),k(0),dim(0),fitted(0){
+    int i, j, first;
+    uint64_t tables, entries, entry;
+    ifstream file;
+    indexHeader header;
+    hashFunction* newFunc;
+
+    status = SUCCESS;
+
+    file.open(fileName, ios::binary);
+    if(!file){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    readIndexHeader(file, header, status);
+    if(status != SUCCESS)
+        return;
+
+    /* Check type of model */
+    if(header.type != INDEX_EXHAUSTIVE && header.type != INDEX_LSH_EUCLIDEAN && header.type != INDEX_LSH_COSINE){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    if(header.metrice != INDEX_EUCLIDEAN && header.metrice != INDEX_COSINE){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    /* Check parameters of lsh */
+    if(header.type != INDEX_EXHAUSTIVE){
+        if(header.l < MIN_L || header.l > MAX_L || header.k < MIN_K || header.k > MAX_K || header.tableSize <= 0){
+            status = INVALID_INDEX_FILE;
+            return;
+        }
+    }
+    else{
+        header.l = 0;
+        header.k = 0;
+        header.tableSize = 0;
+    }
+
+    this->type = header.type;
+    this->metrice = header.metrice;
+    this->n = header.n;
+    this->dim = header.dim;
+    this->l = header.l;
+    this->k = header.k;
+    this->tableSize = header.tableSize;
+
+    ////////////////////////
+    /* Read hash functions */
+    ////////////////////////
+
+    this->hashFunctions.reserve(this->l);
+
+    for(i = 0; i < this->l; i++){
+        if(this->type == INDEX_LSH_EUCLIDEAN)
+            newFunc = new hashFunctionEuclidean(file);
+        else
+            newFunc = new hashFunctionCosine(file);
+
+        /* Invalid hash function */
+        if(newFunc->size() == 0){
+            delete newFunc;
+            status = INVALID_INDEX_FILE;
+            return;
+        }
+
+        this->hashFunctions.push_back(newFunc);
+    } // End for
+
+    file.close();
+
+    ///////////////////////////////
+    /* Map points and hash tables */
+    ///////////////////////////////
+
+    this->data = mapIndexFile(fileName, this->length, status);
+    if(status != SUCCESS)
+        return;
+
+    if(header.fileSize != this->length){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    /* Check arrays */
+    if(!validSection(header.pointsOffset, (uint64_t)this->n * this->dim * sizeof(double), this->length) ||
+       !validSection(header.idOffsetsOffset, (uint64_t)(this->n + 1) * sizeof(uint64_t), this->length)){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    this->points = (const double*)(this->data + header.pointsOffset);
+    this->idOffsets = (const uint64_t*)(this->data + header.idOffsetsOffset);
+
+    if(header.idsOffset > this->length || this->idOffsets[this->n] > this->length - header.idsOffset){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    this->ids = this->data + header.idsOffset;
+
+    /* Offsets of ids are sorted - Every id is in the file */
+    for(i = 0; i < this->n; i++){
+        if(this->idOffsets[i] > this->idOffsets[i + 1]){
+            status = INVALID_INDEX_FILE;
+            return;
+        }
+    } // End for
+
+    if(this->type != INDEX_EXHAUSTIVE){
+        tables = (uint64_t)this->l * (this->tableSize + 1);
+        entries = (uint64_t)this->l * this->n;
+
+        if(!validSection(header.bucketOffsetsOffset, tables * sizeof(int32_t), this->length) ||
+           !validSection(header.bucketEntriesOffset, entries * sizeof(int32_t), this->length)){
+            status = INVALID_INDEX_FILE;
+            return;
+        }
+
+        if(this->type == INDEX_LSH_EUCLIDEAN && !validSection(header.valuesGOffset, entries * this->k * sizeof(int32_t), this->length)){
+            status = INVALID_INDEX_FILE;
+            return;
+        }
+
+        this->bucketOffsets = (const int32_t*)(this->data + header.bucketOffsetsOffset);
+        this->bucketEntries = (const int32_t*)(this->data + header.bucketEntriesOffset);
+        if(this->type == INDEX_LSH_EUCLIDEAN)
+            this->valuesG = (const int32_t*)(this->data + header.valuesGOffset);
+
+        /* Offsets of buckets are sorted and cover all points */
+        for(i = 0; i < this->l; i++){
+            first = 0;
+
+            for(j = 0; j <= this->tableSize; j++){
+                if(this->bucketOffsets[(uint64_t)i * (this->tableSize + 1) + j] < first){
+                    status = INVALID_INDEX_FILE;
+                    return;
+                }
+
+                first = this->bucketOffsets[(uint64_t)i * (this->tableSize + 1) + j];
+            } // End for - Buckets
+
+            if(first != this->n){
+                status = INVALID_INDEX_FILE;
+                return;
+            }
+        } // End for - Tables
+
+        /* Entries of buckets are points */
+        for(entry = 0; entry < entries; entry++){
+            if(this->bucketEntries[entry] < 0 || this->bucketEntries[entry] >= this->n){
+                status = INVALID_INDEX_FILE;
+                return;
+            }
+        } // End for - Entries
+    }
+
+    /* Method fitted */
+    this->fitted = 1;
+}
+
+mappedIndex::~mappedIndex(){
+    int i;
+
+    /* Delete hash functions */
+    for(i = 0; i < (int)this->hashFunctions.size(); i++)
+        delete this->hashFunctions[i];
+
+    unmapIndexFile(this->data, this->length);
+}
+
+/* Index is fitted when it is saved */
+void mappedIndex::fit(list<Item>& points, errorCode& status){
+    status = METHOD_ALREADY_USED;
+}
+
+void mappedIndex::fit(itemStream& points, errorCode& status){
+    status = METHOD_ALREADY_USED;
+}
+
+/* Distance of query and point-i - Euclidean stops at bound(a value >= bound is returned) */
+double mappedIndex::distance(Item& query, int index, double bound, errorCode& status){
+    const double* point = this->points + (uint64_t)index * this->dim;
+
+    if(this->metrice == INDEX_EUCLIDEAN)
+        return query.euclideanDist(point, this->dim, bound, status);
+    else
+        return query.cosineDist(point, this->dim, status);
+}
+
+/* Copy point-i in given item */
+void mappedIndex::getPoint(int index, Item& point, errorCode& status){
+    const double* first = this->points + (uint64_t)index * this->dim;
+    vector<double> components(first, first + this->dim);
+    string id(this->ids + this->idOffsets[index], this->ids + this->idOffsets[index + 1]);
+
+    point = Item(id, components, status);
+}
+
+/* Find the radius neighbors of a given point */
+void mappedIndex::radiusNeighbors(Item& query, int radius, list<Item>& neighbors, list<double>* neighborsDistances, errorCode& status){
+    int i, j, pos, p, first, last;
+    uint64_t entry;
+    double currDist; // Distance of a point in list
+    unordered_set<int> visited; // Visited points
+    Item currPoint;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(radius < MIN_RADIUS || radius > MAX_RADIUS){
+        status = INVALID_RADIUS;
+        return;
+    }
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    /* Clear given lists */
+    neighbors.clear();
+    if(neighborsDistances != NULL)
+        neighborsDistances->clear();
+
+    /* Scann all points */
+    if(this->type == INDEX_EXHAUSTIVE){
+        for(p = 0; p < this->n; p++){
+            currDist = this->distance(query, p, radius, status);
+            if(status != SUCCESS)
+                return;
+
+            /* Keep neighbor */
+            if(currDist < radius){
+                this->getPoint(p, currPoint, status);
+                if(status != SUCCESS)
+                    return;
+
+                neighbors.push_back(currPoint);
+                if(neighborsDistances != NULL)
+                    neighborsDistances->push_back(currDist);
+            }
+        } // End for
+
+        return;
+    }
+
+    /* Scan all tables */
+    for(i = 0; i < this->l; i++){
+
+        /* Find position in table */
+        pos = this->hashFunctions[i]->hash(query, status);
+        if(status != SUCCESS)
+            return;
+
+        if(pos < 0 || pos >= this->tableSize){
+            status = INVALID_HASH_FUNCTION;
+            return;
+        }
+
+        first = this->bucketOffsets[(uint64_t)i * (this->tableSize + 1) + pos];
+        last = this->bucketOffsets[(uint64_t)i * (this->tableSize + 1) + pos + 1];
+
+        /* Empty bucket */
+        if(first == last)
+            continue;
+
+        /* Find value g for query */
+        vector<int> valueG;
+        if(this->type == INDEX_LSH_EUCLIDEAN){
+            for(j = 0; j < this->k; j++){
+                valueG.push_back(this->hashFunctions[i]->hashSubFunction(query, j, status));
+                if(status != SUCCESS)
+                    return;
+            }
+        }
+
+        /* Scan bucket */
+        for(entry = (uint64_t)i * this->n + first; entry < (uint64_t)i * this->n + last; entry++){
+
+            /* Compare values g of query and current point */
+            if(this->type == INDEX_LSH_EUCLIDEAN && !equal(valueG.begin(), valueG.end(), this->valuesG + entry * this->k))
+                continue;
+
+            p = this->bucketEntries[entry];
+            if(p < 0 || p >= this->n){
+                status = INVALID_INDEX_FILE;
+                return;
+            }
+
+            /* Find current distance */
+            currDist = this->distance(query, p, radius, status);
+            if(status != SUCCESS)
+                return;
+
+            /* Keep neighbor */
+            if(currDist < radius){
+                /* Vidited - Discard it */
+                if(visited.find(p) != visited.end())
+                    continue;
+
+                visited.insert(p);
+
+                this->getPoint(p, currPoint, status);
+                if(status != SUCCESS)
+                    return;
+
+                neighbors.push_back(currPoint);
+                if(neighborsDistances != NULL)
+                    neighborsDistances->push_back(currDist);
+            }
+        } // End for - Scan bucket
+    } // End for - Tables
+}
+
+/* Find the nearest neighbor of a given point */
+void mappedIndex::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status){
+    int i, j, pos, p, first, last, posMin = -1;
+    uint64_t entry;
+    double minDist = -1; // Current minimum distance
+    double currDist; // Distance of a point in list
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    /* Scann all points */
+    if(this->type == INDEX_EXHAUSTIVE){
+        for(p = 0; p < this->n; p++){
+            currDist = this->distance(query, p, (posMin == -1) ? HUGE_VAL : minDist, status);
+            if(status != SUCCESS)
+                return;
+
+            if(posMin == -1 || minDist > currDist){
+                posMin = p;
+                minDist = currDist;
+            }
+        } // End for
+    }
+
+    /* Scan all tables */
+    for(i = 0; i < this->l; i++){
+
+        /* Find position in table */
+        pos = this->hashFunctions[i]->hash(query, status);
+        if(status != SUCCESS)
+            return;
+
+        if(pos < 0 || pos >= this->tableSize){
+            status = INVALID_HASH_FUNCTION;
+            return;
+        }
+
+        first = this->bucketOffsets[(uint64_t)i * (this->tableSize + 1) + pos];
+        last = this->bucketOffsets[(uint64_t)i * (this->tableSize + 1) + pos + 1];
+
+        /* Empty bucket */
+        if(first == last)
+            continue;
+
+        /* Find value g for query */
+        vector<int> valueG;
+        if(this->type == INDEX_LSH_EUCLIDEAN){
+            for(j = 0; j < this->k; j++){
+                valueG.push_back(this->hashFunctions[i]->hashSubFunction(query, j, status));
+                if(status != SUCCESS)
+                    return;
+            }
+        }
+
+        /* Scan bucket */
+        for(entry = (uint64_t)i * this->n + first; entry < (uint64_t)i * this->n + last; entry++){
+
+            /* Compare values g of query and current point */
+            if(this->type == INDEX_LSH_EUCLIDEAN && !equal(valueG.begin(), valueG.end(), this->valuesG + entry * this->k))
+                continue;
+
+            p = this->bucketEntries[entry];
+            if(p < 0 || p >= this->n){
+                status = INVALID_INDEX_FILE;
+                return;
+            }
+
+            /* Find current distance */
+            currDist = this->distance(query, p, (posMin == -1) ? HUGE_VAL : minDist, status);
+            if(status != SUCCESS)
+                return;
+
+            if(posMin == -1 || minDist > currDist){
+                posMin = p;
+                minDist = currDist;
+            }
+        } // End for - Scan bucket
+    } // End for - Tables
+
+    /* Nearest neighbor found */
+    if(posMin != -1){
+        this->getPoint(posMin, nNeighbor, status);
+        if(status != SUCCESS)
+            return;
+    }
+    else
+        nNeighbor.setId("Nearest neighbor not found");
+
+    if(neighborDistance != NULL)
+        *neighborDistance = minDist;
+}
+
+///////////////
+/* Accessors */
+///////////////
+
+int mappedIndex::getNumberOfPoints(errorCode& status){
+    status = SUCCESS;
+
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else
+        return this->n;
+}
+
+int mappedIndex::getDim(errorCode& status){
+    status = SUCCESS;
+
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else
+        return this->dim;
+}
+
+/* Mapped bytes are shared - Counted once per process          */
+/* Header, saved hash functions and padding of file are overhead */
+void mappedIndex::getMemoryReport(memoryReport& report, errorCode& status){
+    int i;
+    uint64_t entries;
+
+    status = SUCCESS;
+
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    resetMemoryReport(report);
+
+    /* Arrays of file */
+    report.points = (uint64_t)this->n * this->dim * sizeof(double);
+    report.ids = (uint64_t)(this->n + 1) * sizeof(uint64_t) + this->idOffsets[this->n];
+
+    if(this->type != INDEX_EXHAUSTIVE){
+        entries = (uint64_t)this->l * this->n;
+
+        report.buckets = (uint64_t)this->l * (this->tableSize + 1) * sizeof(int32_t) + entries * sizeof(int32_t);
+        if(this->type == INDEX_LSH_EUCLIDEAN)
+            report.buckets += entries * this->k * sizeof(int32_t);
+    }
+
+    report.overhead = this->length - report.points - report.ids - report.buckets;
+    report.overhead += sizeof(*this);
+
+    /* Hash functions are read in memory */
+    addAllocation(this->hashFunctions.capacity() * sizeof(hashFunction*), report.hashFunctions, report);
+    for(i = 0; i < this->l; i++)
+        report.hashFunctions += this->hashFunctions[i]->size();
+
+    sumMemoryReport(report);
+}
+
+/* Index is already saved */
+void mappedIndex::save(string fileName, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
+}
+
+/* Occupancy of mapped buckets - Sizes are differences of offsets */
+void mappedIndex::getIndexStats(indexStats& stats, errorCode& status){
+    int i, j;
+    const int32_t* currOffsets;
+    vector<int> sizes(this->tableSize);
+
+    status = SUCCESS;
+
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    /* Exhaustive search hasn't buckets */
+    if(this->type == INDEX_EXHAUSTIVE){
+        status = METHOD_NOT_IMPLEMENTED;
+        return;
+    }
+
+    stats.tables.resize(this->l);
+    stats.expectedCandidates = 0;
+
+    for(i = 0; i < this->l; i++){
+        currOffsets = this->bucketOffsets + (uint64_t)i * (this->tableSize + 1);
+
+        for(j = 0; j < this->tableSize; j++)
+            sizes[j] = currOffsets[j + 1] - currOffsets[j];
+
+        computeBucketStats(sizes, stats.tables[i]);
+        stats.expectedCandidates += stats.tables[i].expectedCandidates;
+    } // End for - Tables
+}
+
+/* Print statistics */
+void mappedIndex::print(void){
+
+    if(this->fitted == 0)
+        cout << "Invalid method\n";
+    else{
+
+        cout << "Mapped index statistics\n";
+        if(this->type == INDEX_EXHAUSTIVE)
+            cout << "Saved model: exhaustive search\n";
+        else if(this->type == INDEX_LSH_EUCLIDEAN)
+            cout << "Saved model: lsh euclidean\n";
+        else
+            cout << "Saved model: lsh cosine\n";
+
+        cout << "Dimension: " << this->dim << "\n";
+        cout << "Total points: " << this->n << "\n";
+        cout << "Mapped bytes: " << this->length << "\n";
+
+        if(this->type != INDEX_EXHAUSTIVE){
+            cout << "Number of hash tables(l): " << this->l << "\n";
+            cout << "Size per table: " << this->tableSize << "\n";
+            cout << "Number of sub hash functions(k): " << this->k << "\n";
+
+            /* Occupancy of buckets */
+            indexStats stats;
+            errorCode status;
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Table");
+        }
+        cout << "\n";
+    }
+}
+
+void mappedIndex::printHashFunctions(void){
+
+    if(this->fitted == 0)
+        cout << "Method not fitted\n";
+    else if(this->type == INDEX_EXHAUSTIVE)
+        cout << "Exhaustive search hans't hash fucntions\n\n";
+    else{
+
+        int i;
+
+        cout << "Hash functions of mapped index\n";
+        for(i = 0; i < this->l; i++)
+            this->hashFunctions[i]->print();
+    }
+}
+
+// Petropoulakis Panagiotis
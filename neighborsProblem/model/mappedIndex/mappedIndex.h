@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <stdint.h>
+#include "../model.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+#include "../../hashFunction/hashFunction.h"
+#include "../../indexFile/indexFile.h"
+
+/* Neighbors problem using a saved index(exhaustive search, lsh euclidean, lsh cosine) */
+/* Points and buckets are mapped read only and searched in place - No copies          */
+class mappedIndex: public model{
+    private:
+        const char* data; // Mapped file
+        uint64_t length; // Size of mapped file
+        const double* points; // n x dim matrix
+        const uint64_t* idOffsets; // Start of each id
+        const char* ids;
+        const int32_t* bucketOffsets; // l x (tableSize + 1)
+        const int32_t* bucketEntries; // l x n
+        const int32_t* valuesG; // l x n x k - Only lsh euclidean
+        std::vector<hashFunction*> hashFunctions; // Each table has one hash function
+        int type; // Type of saved model
+        int metrice;
+        int tableSize;
+        int n; // Number of items
+        int l; // Total tables
+        int k; // Number of sub hash functions
+        int dim; // Dimension
+        int fitted; // Method is fitted with data
+
+        /* Distance of query and point-i - Euclidean stops at bound */
+        double distance(Item& query, int index, double bound, errorCode& status);
+
+        /* Copy point-i in given item */
+        void getPoint(int index, Item& point, errorCode& status);
+    public:
+
+        mappedIndex(std::string fileName, errorCode& status);
+
+        ~mappedIndex();
+
+        void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
+
+        void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
+        void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+
+        int getNumberOfPoints(errorCode& status);
+        int getDim(errorCode& status);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
+
+        void print(void);
+        void printHashFunctions(void);
+};
+
+// Petropoulakis Panagiotis
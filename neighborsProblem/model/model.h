@@ -1,28 +1,95 @@
 #pragma once
 #include <vector>
 #include <list>
+#include <string>
 #include "../item/item.h"
 #include "../utils/utils.h"
 #include "../hashFunction/hashFunction.h"
+#include "../fileHandler/fileHandler.h"
+#include "../queryStats/queryStats.h"
+#include "../indexStats/indexStats.h"
 
 /* Abstract class for neighbors problem */
 class model{
+    protected:
+        queryStats lastStats; // Counters of last query
+        queryStatsHistograms stats; // Counters of every query
+        randomGenerator generator; // Random choices of fit - DEFAULT_SEED unless setSeed is called
+
     public:
+        model() { resetQueryStats(this->lastStats); };
         virtual ~model() {};
 
         /* Fit the model with data */
         virtual void fit(std::list<Item>& points, errorCode& status) = 0;
 
+        /* Fit the model with items of a stream - Points are stored while they are read */
+        virtual void fit(itemStream& points, errorCode& status) = 0;
+
         /* Finds the neighbors within a given radius of an item */
         virtual void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status) = 0;
         
         /* Find the nearest neighbor of an item */
         virtual void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status) =  0;
 
+        /* Find the k nearest neighbors of an item - Sorted by distance. Available in hnsw */
+        virtual void kNeighbors(Item& query, int k, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status){
+            status = METHOD_NOT_IMPLEMENTED;
+        }
+
+        /* Check only the rerank best candidates of a cheap filter with exact distances - Called before fit */
+        /* Available in hashing models, 0 checks every candidate. Candidates are ranked by scalar quantized */
+        /* distances or by sign sketches(sketch 1, cosine - smaller and faster, but lower recall)           */
+        virtual void setRerank(int rerank, int sketch, errorCode& status){
+            status = METHOD_NOT_IMPLEMENTED;
+        }
+
+        /* Seed of random choices(hash functions, samples, levels) - Called before fit. */
+        /* Models fitted with the same seed and points are the same in every run       */
+        void setSeed(uint64_t seed){
+            this->generator.seed(seed);
+        }
+
         /* Accessors */
         virtual int getNumberOfPoints(errorCode& status) = 0;
         virtual int getDim(errorCode& status) = 0;
-        virtual unsigned size(void) = 0;
+
+        /* Bytes of fitted model per component */
+        virtual void getMemoryReport(memoryReport& report, errorCode& status) = 0;
+
+        /* Bytes of fitted model - 0 if model is unfitted or invalid */
+        size_t size(void){
+            memoryReport report;
+            errorCode status;
+
+            this->getMemoryReport(report, status);
+            if(status != SUCCESS)
+                return 0;
+
+            return report.total;
+        }
+
+        /* Save fitted model in a binary index file */
+        virtual void save(std::string fileName, errorCode& status) = 0;
+
+        /* Occupancy of buckets of fitted model */
+        virtual void getIndexStats(indexStats& stats, errorCode& status) = 0;
+
+        /* Counters of queries - Available if compiled with QUERY_STATS */
+        void getQueryStats(queryStats& lastQuery, queryStatsHistograms& allQueries, errorCode& status){
+        #ifdef QUERY_STATS
+            status = SUCCESS;
+            lastQuery = this->lastStats;
+            allQueries = this->stats;
+        #else
+            status = METHOD_NOT_IMPLEMENTED;
+        #endif
+        }
+
+        void clearQueryStats(void){
+            resetQueryStats(this->lastStats);
+            this->stats.clear();
+        }
 
         /* Print some statistics */
         virtual void print(void) = 0;
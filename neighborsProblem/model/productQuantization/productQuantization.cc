@@ -0,0 +1,830 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <cmath>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+#include "productQuantization.h"
+#include "../../indexFile/indexFile.h"
+#include "../../indexStats/indexStats.h"
+#include "../../trace/trace.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+
+using namespace std;
+
+//////////////////////////////////////////////////
+/* Implementation of product quantization class */
+//////////////////////////////////////////////////
+
+/* Points are encoded by a pool of threads - Small sets are encoded by one thread */
+#define MIN_POINTS_PER_THREAD 1000
+
+/* Rounding of errors of codes in the radius margin */
+#define PQ_ERROR_SLACK 1e-9
+
+/* Default constructor */
+productQuantization::productQuantization(string metrice):mapped(NULL),mappedLength(0),exactPoints(NULL),subquantizers(16),rerank(100),n(0),dim(0),fitted(0),cosine(0),metrice(metrice){}
+
+productQuantization::productQuantization(int subquantizers, int rerank, string metrice, errorCode& status):mapped(NULL),mappedLength(0),exactPoints(NULL),subquantizers(subquantizers),rerank(rerank),n(0),dim(0),fitted(0),cosine(0),metrice(metrice){
+    /* Check parameters */
+    if(subquantizers < MIN_SUBQUANTIZERS || subquantizers > MAX_SUBQUANTIZERS || rerank < MIN_RERANK || rerank > MAX_RERANK){
+        status = INVALID_PARAMETERS;
+        this->subquantizers = -1;
+    }
+}
+
+/* Unmap points of rerank */
+productQuantization::~productQuantization(){
+    unmapIndexFile(this->mapped, this->mappedLength);
+}
+
+/* Encode given points */
+void productQuantization::fit(list<Item>& points, errorCode& status){
+    listStream stream(points);
+
+    this->points.reserve(points.size());
+
+    this->fit(stream, status);
+}
+
+/* Points of stream are appended in place - Codebooks are trained after the last point */
+/* Items are released after encoding - Points of rerank are mapped from a file        */
+void productQuantization::fit(itemStream& points, errorCode& status){
+    int i, s, threads, sampleSize;
+    vector<const double*> data, sample;
+    vector<double> scales, sampleScales;
+    vector<int> order;
+    vector<randomGenerator> streams;
+    vector<thread> pool;
+
+    status = SUCCESS;
+    TRACE_SCOPE("product quantization fit");
+
+    /* Check method */
+    if(this->subquantizers == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    /* Already fitted */
+    if(this->fitted == 1){
+        status = METHOD_ALREADY_USED;
+        return;
+    }
+
+    /* Check metrice */
+    if(this->metrice == "euclidean")
+        this->cosine = 0;
+    else if(this->metrice == "cosine")
+        this->cosine = 1;
+    else{
+        status = INVALID_METRICE;
+        return;
+    }
+
+    /* Copy points */
+    points.forEach([&](Item& point, errorCode& status){
+
+        /* Dimension of first point */
+        if(this->points.size() == 0)
+            this->dim = point.getDim();
+
+        if(this->dim != point.getDim() || (int)this->points.size() == MAX_POINTS){
+            status = INVALID_POINTS;
+            return;
+        }
+
+        this->points.push_back(point);
+    }, status);
+
+    /* Set members */
+    this->n = this->points.size();
+    if(status == SUCCESS && (this->n < MIN_POINTS || this->n > MAX_POINTS))
+        status = INVALID_POINTS;
+
+    /* Every sub space needs a dimension */
+    if(status == SUCCESS && this->subquantizers > this->dim)
+        status = INVALID_PARAMETERS;
+
+    if(status != SUCCESS){
+        this->points.clear();
+        this->points.shrink_to_fit();
+        return;
+    }
+
+    /* Release spare capacity of growth - Items are moved */
+    this->points.shrink_to_fit();
+
+    /* Sub spaces - First dim % subquantizers sub spaces have one more dimension */
+    this->subOffsets.resize(this->subquantizers + 1);
+    for(s = 0; s <= this->subquantizers; s++)
+        this->subOffsets[s] = (int)((long)s * this->dim / this->subquantizers);
+
+    /* Cosine points are normalized - Scale of every point */
+    data.resize(this->n);
+    scales.assign(this->n, 1);
+    for(i = 0; i < this->n; i++){
+        data[i] = this->points[i].getComponents().data();
+
+        if(this->cosine == 1){
+            double norm = sqrt(inner_product(data[i], data[i] + this->dim, data[i], 0.0));
+            scales[i] = (norm == 0) ? 0 : 1 / norm;
+        }
+    } // End for
+
+    ////////////////////
+    /* Set codebooks */
+    ////////////////////
+
+    TRACE_BEGIN(trainRegion, "product quantization train");
+
+    /* Random sample */
+    sampleSize = (PQ_CENTROIDS * PQ_SAMPLE < this->n) ? PQ_CENTROIDS * PQ_SAMPLE : this->n;
+
+    order.resize(this->n);
+    iota(order.begin(), order.end(), 0);
+    this->generator.shuffle(order);
+
+    for(i = 0; i < sampleSize; i++){
+        sample.push_back(data[order[i]]);
+        sampleScales.push_back(scales[order[i]]);
+    } // End for
+
+    /* Sub spaces are trained in parallel - Own stream per sub space, so */
+    /* codebooks do not depend on the order of threads                   */
+    for(s = 0; s < this->subquantizers; s++){
+        streams.push_back(this->generator);
+        this->generator.jump();
+    }
+
+    this->codebooks.assign((size_t)PQ_CENTROIDS * this->dim, 0);
+
+    threads = thread::hardware_concurrency();
+    if(threads > this->subquantizers)
+        threads = this->subquantizers;
+    if(threads <= 0)
+        threads = 1;
+
+    auto train = [&](int first){
+        for(int curr = first; curr < this->subquantizers; curr += threads)
+            this->trainSubspace(curr, sample, sampleScales, streams[curr]);
+    };
+
+    for(i = 1; i < threads; i++)
+        pool.push_back(thread(train, i));
+
+    train(0);
+
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+
+    TRACE_END(trainRegion);
+
+    ////////////////////
+    /* Encode points */
+    ////////////////////
+
+    TRACE_BEGIN(encodeRegion, "product quantization encode");
+
+    this->encode(data, scales);
+
+    TRACE_END(encodeRegion);
+
+    /* Exact distances read points of a mapped file */
+    if(this->rerank > 0){
+        this->mapPoints(status);
+        if(status != SUCCESS){
+            this->points.clear();
+            this->points.shrink_to_fit();
+            return;
+        }
+    }
+
+    /* Only ids of items are kept */
+    this->idsOffset.resize(this->n + 1);
+    this->idsOffset[0] = 0;
+
+    for(i = 0; i < this->n; i++){
+        string id = this->points[i].getId();
+
+        this->ids.insert(this->ids.end(), id.begin(), id.end());
+        this->idsOffset[i + 1] = this->ids.size();
+    } // End for
+
+    this->ids.shrink_to_fit();
+    this->points.clear();
+    this->points.shrink_to_fit();
+
+    /* Method fitted */
+    this->fitted = 1;
+}
+
+/* Lloyd iterations on the dimensions of a sub space: centroids start at */
+/* points of the sample and move to the mean of their points             */
+void productQuantization::trainSubspace(int subspace, vector<const double*>& sample, vector<double>& scales, randomGenerator& generator){
+    int first = this->subOffsets[subspace], subDim = this->subOffsets[subspace + 1] - first;
+    int sampleSize = sample.size(), iteration, changed, best, i, j, c;
+    double currDist, minDist, diff;
+    double* centroids = &this->codebooks[(size_t)PQ_CENTROIDS * first];
+    vector<int> assignments(sampleSize, -1), counts(PQ_CENTROIDS);
+    vector<double> sums((size_t)PQ_CENTROIDS * subDim);
+
+    /* First points of sample(shuffled) */
+    for(c = 0; c < PQ_CENTROIDS; c++){
+        i = (c < sampleSize) ? c : generator.uniformInt(0, sampleSize - 1);
+
+        for(j = 0; j < subDim; j++)
+            centroids[c * subDim + j] = sample[i][first + j] * scales[i];
+    } // End for
+
+    for(iteration = 0; iteration < PQ_ITERATIONS; iteration++){
+        changed = 0;
+
+        /* Assign sample */
+        for(i = 0; i < sampleSize; i++){
+            best = 0;
+            minDist = HUGE_VAL;
+
+            for(c = 0; c < PQ_CENTROIDS; c++){
+                currDist = 0;
+                for(j = 0; j < subDim; j++){
+                    diff = sample[i][first + j] * scales[i] - centroids[c * subDim + j];
+                    currDist += diff * diff;
+                }
+
+                if(currDist < minDist){
+                    minDist = currDist;
+                    best = c;
+                }
+            } // End for - Centroids
+
+            if(assignments[i] != best){
+                assignments[i] = best;
+                changed = 1;
+            }
+        } // End for - Sample
+
+        /* Assignments converged */
+        if(changed == 0)
+            break;
+
+        /* Means of centroids */
+        fill(sums.begin(), sums.end(), 0);
+        fill(counts.begin(), counts.end(), 0);
+
+        for(i = 0; i < sampleSize; i++){
+            c = assignments[i];
+            counts[c] += 1;
+
+            for(j = 0; j < subDim; j++)
+                sums[c * subDim + j] += sample[i][first + j] * scales[i];
+        } // End for
+
+        for(c = 0; c < PQ_CENTROIDS; c++){
+
+            /* Empty centroid - Moves to a random point of the sample */
+            if(counts[c] == 0){
+                i = generator.uniformInt(0, sampleSize - 1);
+
+                for(j = 0; j < subDim; j++)
+                    centroids[c * subDim + j] = sample[i][first + j] * scales[i];
+            }
+            else
+                for(j = 0; j < subDim; j++)
+                    centroids[c * subDim + j] = sums[c * subDim + j] / counts[c];
+        } // End for - Centroids
+    } // End for - Iterations
+}
+
+/* Closest centroid of every sub space - Ranges of points are encoded in parallel */
+void productQuantization::encode(vector<const double*>& data, vector<double>& scales){
+    int i, ranges, size = data.size();
+    vector<thread> pool;
+
+    this->codes.resize((size_t)size * this->subquantizers);
+    if(this->rerank > 0)
+        this->errors.resize(size);
+
+    ranges = thread::hardware_concurrency();
+    if(ranges > size / MIN_POINTS_PER_THREAD)
+        ranges = size / MIN_POINTS_PER_THREAD;
+    if(ranges <= 0)
+        ranges = 1;
+
+    auto work = [&](int firstPoint, int lastPoint){
+        int i, s, c, j, first, subDim, best;
+        double currDist, minDist, diff, error;
+        const double* centroids;
+
+        for(i = firstPoint; i < lastPoint; i++){
+            error = 0;
+
+            for(s = 0; s < this->subquantizers; s++){
+                first = this->subOffsets[s];
+                subDim = this->subOffsets[s + 1] - first;
+                centroids = &this->codebooks[(size_t)PQ_CENTROIDS * first];
+                best = 0;
+                minDist = HUGE_VAL;
+
+                for(c = 0; c < PQ_CENTROIDS; c++){
+                    currDist = 0;
+                    for(j = 0; j < subDim; j++){
+                        diff = data[i][first + j] * scales[i] - centroids[c * subDim + j];
+                        currDist += diff * diff;
+                    }
+
+                    if(currDist < minDist){
+                        minDist = currDist;
+                        best = c;
+                    }
+                } // End for - Centroids
+
+                this->codes[(size_t)i * this->subquantizers + s] = best;
+                error += minDist;
+            } // End for - Sub spaces
+
+            if(this->rerank > 0)
+                this->errors[i] = sqrt(error);
+        } // End for - Points
+    };
+
+    for(i = 1; i < ranges; i++)
+        pool.push_back(thread(work, (int)((long)i * size / ranges), (int)((long)(i + 1) * size / ranges)));
+
+    work(0, (int)((long)size / ranges));
+
+    for(i = 0; i < (int)pool.size(); i++)
+        pool[i].join();
+}
+
+/* Squared distances of the(normalized) query from every centroid - PQ_CENTROIDS per sub space */
+void productQuantization::distanceTables(Item& query, vector<double>& tables){
+    int s, c, j, first, subDim;
+    double scale = 1, diff;
+    const double* queryData = query.getComponents().data();
+    const double* centroids;
+
+    if(this->cosine == 1){
+        scale = sqrt(inner_product(queryData, queryData + this->dim, queryData, 0.0));
+        scale = (scale == 0) ? 0 : 1 / scale;
+    }
+
+    tables.assign((size_t)PQ_CENTROIDS * this->subquantizers, 0);
+
+    for(s = 0; s < this->subquantizers; s++){
+        first = this->subOffsets[s];
+        subDim = this->subOffsets[s + 1] - first;
+        centroids = &this->codebooks[(size_t)PQ_CENTROIDS * first];
+
+        for(c = 0; c < PQ_CENTROIDS; c++)
+            for(j = 0; j < subDim; j++){
+                diff = queryData[first + j] * scale - centroids[c * subDim + j];
+                tables[s * PQ_CENTROIDS + c] += diff * diff;
+            }
+    } // End for - Sub spaces
+}
+
+/* Euclidean: square root - Cosine: |x - y|^2 == 2 - 2cos(x, y) for normalized points */
+double productQuantization::approxDistance(double sum){
+    if(this->cosine == 1)
+        return sum / 2;
+    else
+        return sqrt(sum);
+}
+
+/* Points of fit are written in an index file(layout of exhaustive search) of the */
+/* temporary directory, which is mapped and unlinked - Pages are freed at unmap   */
+void productQuantization::mapPoints(errorCode& status){
+    int fd;
+    const char* dir = getenv("TMPDIR");
+    string fileName = string((dir != NULL) ? dir : "/tmp") + "/pqPointsXXXXXX";
+    vector<char> name(fileName.begin(), fileName.end());
+    ofstream file;
+    indexHeader header;
+
+    status = SUCCESS;
+
+    name.push_back('\0');
+    fd = mkstemp(name.data());
+    if(fd < 0){
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    close(fd);
+    fileName = name.data();
+
+    file.open(fileName, ios::binary | ios::trunc);
+    if(!file){
+        unlink(fileName.c_str());
+        status = INVALID_INDEX_FILE;
+        return;
+    }
+
+    /* Set header */
+    initIndexHeader(header);
+    header.type = INDEX_EXHAUSTIVE;
+    header.metrice = (this->cosine == 0) ? INDEX_EUCLIDEAN : INDEX_COSINE;
+    header.n = this->n;
+    header.dim = this->dim;
+
+    writeIndexHeader(file, header, status);
+    if(status == SUCCESS)
+        writeIndexPoints(file, this->points, header, status);
+    if(status == SUCCESS){
+        header.fileSize = file.tellp();
+        writeIndexHeader(file, header, status);
+    }
+
+    file.close();
+
+    if(status == SUCCESS)
+        this->mapped = mapIndexFile(fileName, this->mappedLength, status);
+
+    /* Mapping stays valid - File is removed with the last mapping */
+    unlink(fileName.c_str());
+
+    if(status != SUCCESS)
+        return;
+
+    this->exactPoints = (const double*)(this->mapped + header.pointsOffset);
+}
+
+/* Point of given index - Its point of mapped file or the centroids of its code, and its id */
+void productQuantization::getPoint(int index, Item& point, errorCode& status){
+    int s, j, first, subDim;
+    vector<double> components(this->dim);
+    string id;
+
+    status = SUCCESS;
+
+    id.assign(this->ids.begin() + this->idsOffset[index], this->ids.begin() + this->idsOffset[index + 1]);
+
+    if(this->rerank > 0){
+        const double* exact = this->exactPoints + (size_t)index * this->dim;
+
+        components.assign(exact, exact + this->dim);
+        point = Item(id, components, status);
+        return;
+    }
+
+    for(s = 0; s < this->subquantizers; s++){
+        first = this->subOffsets[s];
+        subDim = this->subOffsets[s + 1] - first;
+
+        for(j = 0; j < subDim; j++)
+            components[first + j] = this->codebooks[(size_t)PQ_CENTROIDS * first + this->codes[(size_t)index * this->subquantizers + s] * subDim + j];
+    } // End for
+
+    point = Item(id, components, status);
+}
+
+/* Find the radius neighbors of a given point - Codes within radius plus their */
+/* error are checked with exact distances if items are kept(rerank > 0)        */
+void productQuantization::radiusNeighbors(Item& query, int radius, list<Item>& neighbors, list<double>* neighborsDistances, errorCode& status){
+    int i, s;
+    double currDist, sum, lower; // Distance of a point in list
+    const uint8_t* code;
+    vector<double> tables;
+    Item point;
+
+    status = SUCCESS;
+
+    /* Check parameters */
+    if(radius < MIN_RADIUS || radius > MAX_RADIUS){
+        status = INVALID_RADIUS;
+        return;
+    }
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->subquantizers == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    /* Clear given lists */
+    neighbors.clear();
+    if(neighborsDistances != NULL)
+        neighborsDistances->clear();
+
+    TRACE_SCOPE("product quantization radiusNeighbors");
+    STATS_RESET(this->lastStats);
+
+    STATS_START(hashTimer);
+    this->distanceTables(query, tables);
+    STATS_STOP(this->lastStats, hashTime, hashTimer);
+
+    STATS_START(scanTimer);
+    STATS_ADD(this->lastStats, tablesProbed, 1);
+
+    for(i = 0; i < this->n; i++){
+        code = &this->codes[(size_t)i * this->subquantizers];
+        sum = 0;
+
+        for(s = 0; s < this->subquantizers; s++)
+            sum += tables[s * PQ_CENTROIDS + code[s]];
+
+        STATS_ADD(this->lastStats, candidatesScanned, 1);
+
+        /* Without items distances are approximate */
+        if(this->rerank == 0){
+            currDist = this->approxDistance(sum);
+            if(currDist >= radius)
+                continue;
+        }
+
+        /* Exact distance - A point is at most its error away from its centroids, */
+        /* so codes farther than radius plus the error are skipped                */
+        else{
+            lower = sqrt(sum) - this->errors[i] - PQ_ERROR_SLACK;
+            if(lower > 0 && this->approxDistance(lower * lower) >= radius)
+                continue;
+
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            if(this->cosine == 0)
+                currDist = query.euclideanDist(this->exactPoints + (size_t)i * this->dim, this->dim, radius, status);
+            else
+                currDist = query.cosineDist(this->exactPoints + (size_t)i * this->dim, this->dim, status);
+
+            if(status != SUCCESS)
+                return;
+
+            if(currDist >= radius)
+                continue;
+        }
+
+        /* Keep neighbor */
+        this->getPoint(i, point, status);
+        if(status != SUCCESS)
+            return;
+
+        neighbors.push_back(point);
+        if(neighborsDistances != NULL)
+            neighborsDistances->push_back(currDist);
+    } // End for - Codes
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+}
+
+/* Find the nearest neighbor of a given point - The closest rerank codes are */
+/* checked with exact distances(closest code without rerank)                 */
+void productQuantization::nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status){
+    int i, s, candidates = (this->rerank > 0) ? this->rerank : 1, posMin = -1;
+    double sum, minDist = -1, currDist;
+    const uint8_t* code;
+    vector<double> tables;
+    vector<pair<double, int> > closest; // Max heap of closest codes
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->subquantizers == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    if(query.getDim() != this->dim){
+        status = INVALID_DIM;
+        return;
+    }
+
+    TRACE_SCOPE("product quantization nNeighbor");
+    STATS_RESET(this->lastStats);
+
+    STATS_START(hashTimer);
+    this->distanceTables(query, tables);
+    STATS_STOP(this->lastStats, hashTime, hashTimer);
+
+    STATS_START(scanTimer);
+    STATS_ADD(this->lastStats, tablesProbed, 1);
+
+    /* Closest codes */
+    for(i = 0; i < this->n; i++){
+        code = &this->codes[(size_t)i * this->subquantizers];
+        sum = 0;
+
+        for(s = 0; s < this->subquantizers; s++)
+            sum += tables[s * PQ_CENTROIDS + code[s]];
+
+        STATS_ADD(this->lastStats, candidatesScanned, 1);
+
+        if((int)closest.size() == candidates && sum >= closest.front().first)
+            continue;
+
+        closest.push_back(make_pair(sum, i));
+        push_heap(closest.begin(), closest.end());
+
+        if((int)closest.size() > candidates){
+            pop_heap(closest.begin(), closest.end());
+            closest.pop_back();
+        }
+    } // End for - Codes
+
+    /* Closest first */
+    sort_heap(closest.begin(), closest.end());
+
+    /* Exact distances of closest codes */
+    if(this->rerank > 0){
+        for(i = 0; i < (int)closest.size(); i++){
+            STATS_ADD(this->lastStats, distanceComputations, 1);
+
+            /* Farther points than the nearest are abandoned early */
+            if(this->cosine == 0)
+                currDist = query.euclideanDist(this->exactPoints + (size_t)closest[i].second * this->dim, this->dim, (posMin == -1) ? HUGE_VAL : minDist, status);
+            else
+                currDist = query.cosineDist(this->exactPoints + (size_t)closest[i].second * this->dim, this->dim, status);
+
+            if(status != SUCCESS)
+                return;
+
+            if(posMin == -1 || minDist > currDist){
+                posMin = closest[i].second;
+                minDist = currDist;
+            }
+        } // End for
+    }
+    else{
+        posMin = closest[0].second;
+        minDist = this->approxDistance(closest[0].first);
+    }
+
+    STATS_STOP(this->lastStats, scanTime, scanTimer);
+    STATS_RECORD(this->stats, this->lastStats);
+
+    /* Set nearest neighbor */
+    this->getPoint(posMin, nNeighbor, status);
+    if(status != SUCCESS)
+        return;
+
+    if(neighborDistance != NULL)
+        *neighborDistance = minDist;
+}
+
+///////////////
+/* Accessors */
+///////////////
+
+int productQuantization::getNumberOfPoints(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->subquantizers == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->n;
+}
+
+int productQuantization::getDim(errorCode& status){
+    status = SUCCESS;
+
+    if(fitted == 0){
+        status = METHOD_UNFITTED;
+        return -1;
+    }
+    else if(this->subquantizers == -1){
+        status = INVALID_METHOD;
+        return -1;
+    }
+    else
+        return this->dim;
+}
+
+/* Bytes of codes, ids or items and codebooks - Every allocation is counted */
+void productQuantization::getMemoryReport(memoryReport& report, errorCode& status){
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->subquantizers == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    resetMemoryReport(report);
+    report.overhead += sizeof(*this);
+
+    /* Points are codes - Points of rerank are in a mapped file, */
+    /* not in the heap, and only their errors are counted        */
+    addAllocation(this->codes.capacity() * sizeof(uint8_t), report.points, report);
+    if(this->rerank > 0)
+        addAllocation(this->errors.capacity() * sizeof(double), report.points, report);
+
+    addAllocation(this->ids.capacity() * sizeof(char), report.ids, report);
+    addAllocation(this->idsOffset.capacity() * sizeof(int), report.ids, report);
+
+    /* Codebooks */
+    addAllocation(this->codebooks.capacity() * sizeof(double), report.hashFunctions, report);
+    addAllocation(this->subOffsets.capacity() * sizeof(int), report.hashFunctions, report);
+
+    sumMemoryReport(report);
+}
+
+/* Codebooks are trained on a random sample - Not saved */
+void productQuantization::save(string fileName, errorCode& status){
+    status = METHOD_NOT_IMPLEMENTED;
+}
+
+/* Points per centroid of every sub space - Every code is scanned by a query */
+void productQuantization::getIndexStats(indexStats& stats, errorCode& status){
+    int i, s;
+
+    status = SUCCESS;
+
+    /* Check model */
+    if(this->fitted == 0){
+        status = METHOD_UNFITTED;
+        return;
+    }
+
+    if(this->subquantizers == -1){
+        status = INVALID_METHOD;
+        return;
+    }
+
+    stats.tables.resize(this->subquantizers);
+    for(s = 0; s < this->subquantizers; s++){
+        vector<int> sizes(PQ_CENTROIDS, 0);
+
+        for(i = 0; i < this->n; i++)
+            sizes[this->codes[(size_t)i * this->subquantizers + s]] += 1;
+
+        computeBucketStats(sizes, stats.tables[s]);
+    } // End for - Sub spaces
+
+    stats.expectedCandidates = this->n;
+}
+
+/* Print statistics */
+void productQuantization::print(void){
+
+    if(this->subquantizers == -1)
+        cout << "Invalid method\n";
+    else{
+
+        cout << "Product quantization statistics\n";
+        cout << "Sub quantizers: " << this->subquantizers << "\n";
+        cout << "Rerank: " << this->rerank << "\n";
+
+        /* Occupancy of centroids */
+        if(this->fitted == 1){
+            indexStats stats;
+            errorCode status;
+
+            cout << "Dimension: " << this->dim << "\n";
+            cout << "Total points: " << this->n << "\n";
+
+            this->getIndexStats(stats, status);
+            if(status == SUCCESS)
+                printIndexStats(stats, "Sub space");
+        }
+    }
+}
+
+void productQuantization::printHashFunctions(void){
+    int s;
+
+    if(this->subquantizers == -1 || this->fitted == 0){
+        cout << "Product quantization hasn't codebooks\n\n";
+        return;
+    }
+
+    for(s = 0; s < this->subquantizers; s++)
+        cout << "Sub space " << s << ": dimensions [" << this->subOffsets[s] << ", " << this->subOffsets[s + 1] << "), " << PQ_CENTROIDS << " centroids\n";
+
+    cout << "\n";
+}
+
+// Petropoulakis Panagiotis
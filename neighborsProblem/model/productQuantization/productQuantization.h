@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <cstdint>
+#include "../model.h"
+#include "../../item/item.h"
+#include "../../utils/utils.h"
+
+/* Centroids of a sub space - A centroid is a byte of a code */
+#define PQ_CENTROIDS 256
+
+/* Codebooks are trained with Lloyd iterations on a sample of */
+/* PQ_SAMPLE points per centroid at most                      */
+#define PQ_ITERATIONS 10
+#define PQ_SAMPLE 256
+
+/* Neighbors problem using product quantization - Metrices: euclidean, cosine              */
+/* Dimensions are split in sub spaces and a point is kept as the closest centroid of every */
+/* sub space(one byte). Queries sum distances of a table per sub space(asymmetric          */
+/* distances) and the rerank closest codes are checked with exact distances of points in   */
+/* a mapped file(outside the heap). Only codes and ids are kept in memory                  */
+class productQuantization: public model{
+    private:
+        std::vector<Item> points; // Points of fit - Released after encoding
+        const char* mapped; // Unlinked index file of points(rerank > 0) - Pages are read by the kernel
+        uint64_t mappedLength;
+        const double* exactPoints; // n x dim matrix of mapped file
+        std::vector<uint8_t> codes; // subquantizers centroids per point
+        std::vector<double> errors; // Distance of a(normalized) point from its centroids - Margin of radius(rerank > 0)
+        std::vector<char> ids; // Ids of points without items - Concatenated
+        std::vector<int> idsOffset; // Id of point-i: [idsOffset[i], idsOffset[i + 1])
+        std::vector<double> codebooks; // PQ_CENTROIDS centroids of every sub space
+        std::vector<int> subOffsets; // Dimensions of sub space-i: [subOffsets[i], subOffsets[i + 1])
+        int subquantizers; // Bytes of a code
+        int rerank; // Codes checked with exact distances
+        int n; // Number of items
+        int dim; // Dimension
+        int fitted; // Method is fitted with data
+        int cosine; // Points and queries are normalized - Cosine distance is half the squared distance
+        std::string metrice;
+
+        /* Lloyd iterations of the centroids of a sub space - Points are scaled by given scales */
+        void trainSubspace(int subspace, std::vector<const double*>& sample, std::vector<double>& scales, randomGenerator& generator);
+
+        /* Closest centroid of every sub space of given scaled points */
+        void encode(std::vector<const double*>& data, std::vector<double>& scales);
+
+        /* Squared distances of the query from every centroid of every sub space */
+        void distanceTables(Item& query, std::vector<double>& tables);
+
+        /* Distance of a sum of tables(squared distance of normalized points for cosine) */
+        double approxDistance(double sum);
+
+        /* Write points in an unlinked temporary index file and map it */
+        void mapPoints(errorCode& status);
+
+        /* Point of given index - Reconstructed from its code without rerank */
+        void getPoint(int index, Item& point, errorCode& status);
+
+    public:
+
+        productQuantization(std::string metrice="euclidean");
+        productQuantization(int subquantizers, int rerank, std::string metrice, errorCode& status);
+
+        ~productQuantization();
+
+        void fit(std::list<Item>& points, errorCode& status);
+        void fit(itemStream& points, errorCode& status);
+
+        void radiusNeighbors(Item& query, int radius, std::list<Item>& neighbors, std::list<double>* neighborsDistances, errorCode& status);
+        void nNeighbor(Item& query, Item& nNeighbor, double* neighborDistance, errorCode& status);
+
+        int getNumberOfPoints(errorCode& status);
+        int getDim(errorCode& status);
+        void getMemoryReport(memoryReport& report, errorCode& status);
+        void save(std::string fileName, errorCode& status);
+        void getIndexStats(indexStats& stats, errorCode& status);
+
+        void print(void);
+        void printHashFunctions(void);
+};
+
+// Petropoulakis Panagiotis
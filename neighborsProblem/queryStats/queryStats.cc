@@ -0,0 +1,162 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include "queryStats.h"
+
+using namespace std;
+
+/* Number of buckets - Values up to 2^62 */
+#define HISTOGRAM_BUCKETS 64
+
+/* Reset counters of a query */
+void resetQueryStats(queryStats& stats){
+    stats.tablesProbed = 0;
+    stats.bucketsVisited = 0;
+    stats.candidatesScanned = 0;
+    stats.rejectionsG = 0;
+    stats.distanceComputations = 0;
+    stats.distancesAbandoned = 0;
+    stats.duplicatesSkipped = 0;
+    stats.hashTime = 0;
+    stats.scanTime = 0;
+}
+
+//////////////////////////////////////////
+/* Implementation of histogram of stats */
+//////////////////////////////////////////
+
+statsHistogram::statsHistogram():buckets(HISTOGRAM_BUCKETS, 0),count(0),sum(0),max(0){}
+
+void statsHistogram::add(double value){
+    int bucket = 0;
+
+    if(value < 0)
+        value = 0;
+
+    /* Find bucket: [2^(bucket-1), 2^bucket) */
+    if(value >= 1){
+        bucket = (int)log2(value) + 1;
+        if(bucket >= HISTOGRAM_BUCKETS)
+            bucket = HISTOGRAM_BUCKETS - 1;
+    }
+
+    this->buckets[bucket] += 1;
+    this->count += 1;
+    this->sum += value;
+
+    if(value > this->max)
+        this->max = value;
+}
+
+void statsHistogram::clear(void){
+    this->buckets.assign(HISTOGRAM_BUCKETS, 0);
+    this->count = 0;
+    this->sum = 0;
+    this->max = 0;
+}
+
+long statsHistogram::getCount(void){
+    return this->count;
+}
+
+double statsHistogram::getMean(void){
+    if(this->count == 0)
+        return 0;
+
+    return this->sum / this->count;
+}
+
+double statsHistogram::getMax(void){
+    return this->max;
+}
+
+/* Upper bound of bucket that contains percentile p */
+double statsHistogram::percentile(double p){
+    int i;
+    long seen = 0, target;
+
+    if(this->count == 0)
+        return 0;
+
+    target = (long)ceil(p * this->count);
+    if(target < 1)
+        target = 1;
+
+    for(i = 0; i < HISTOGRAM_BUCKETS; i++){
+        seen += this->buckets[i];
+        if(seen >= target)
+            break;
+    }
+
+    if(i == 0)
+        return 0;
+
+    /* Max is a tighter bound */
+    return min(pow(2, i), this->max);
+}
+
+void statsHistogram::print(string name, ostream& out){
+    int i;
+
+    out << name << ": mean " << this->getMean() << ", p50 <= " << this->percentile(0.5) << ", p99 <= " << this->percentile(0.99) << ", max " << this->max << "\n";
+
+    /* Non empty buckets */
+    for(i = 0; i < HISTOGRAM_BUCKETS; i++){
+        if(this->buckets[i] == 0)
+            continue;
+
+        if(i == 0)
+            out << "    [0]: " << this->buckets[i] << "\n";
+        else
+            out << "    [" << pow(2, i - 1) << ", " << pow(2, i) << "): " << this->buckets[i] << "\n";
+    } // End for
+}
+
+///////////////////////////////////////////////
+/* Implementation of histograms of all stats */
+///////////////////////////////////////////////
+
+void queryStatsHistograms::add(queryStats& stats){
+    this->tablesProbed.add(stats.tablesProbed);
+    this->bucketsVisited.add(stats.bucketsVisited);
+    this->candidatesScanned.add(stats.candidatesScanned);
+    this->rejectionsG.add(stats.rejectionsG);
+    this->distanceComputations.add(stats.distanceComputations);
+    this->distancesAbandoned.add(stats.distancesAbandoned);
+    this->duplicatesSkipped.add(stats.duplicatesSkipped);
+    this->hashTime.add(stats.hashTime);
+    this->scanTime.add(stats.scanTime);
+}
+
+void queryStatsHistograms::clear(void){
+    this->tablesProbed.clear();
+    this->bucketsVisited.clear();
+    this->candidatesScanned.clear();
+    this->rejectionsG.clear();
+    this->distanceComputations.clear();
+    this->distancesAbandoned.clear();
+    this->duplicatesSkipped.clear();
+    this->hashTime.clear();
+    this->scanTime.clear();
+}
+
+long queryStatsHistograms::getQueries(void){
+    return this->tablesProbed.getCount();
+}
+
+void queryStatsHistograms::print(ostream& out){
+    out << "Queries: " << this->getQueries() << "\n";
+
+    this->tablesProbed.print("Tables probed", out);
+    this->bucketsVisited.print("Buckets visited", out);
+    this->candidatesScanned.print("Candidates scanned", out);
+    this->rejectionsG.print("Rejections of g", out);
+    this->distanceComputations.print("Distance computations", out);
+    this->distancesAbandoned.print("Distances abandoned", out);
+    this->duplicatesSkipped.print("Duplicates skipped", out);
+    this->hashTime.print("Hash time(us)", out);
+    this->scanTime.print("Scan time(us)", out);
+}
+
+// Petropoulakis Panagiotis
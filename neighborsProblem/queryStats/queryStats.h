@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+
+/* Per query instrumentation of models                                      */
+/* Counters are updated only if the library is compiled with -DQUERY_STATS, */
+/* otherwise the macros are empty and queries pay nothing                   */
+/* Counters live in the model - Concurrent queries of a model race on them  */
+
+/* Counters of a single query */
+typedef struct queryStats{
+    long tablesProbed; // Hash tables(lsh) or cubes probed
+    long bucketsVisited; // Non empty buckets(lsh) or vertices(cube) scanned
+    long candidatesScanned; // Entries of visited buckets
+    long rejectionsG; // Entries with different value g(lsh euclidean)
+    long distanceComputations;
+    long distancesAbandoned; // Distance computations stopped early at a bound - Part of distanceComputations
+    long duplicatesSkipped; // Points found in many tables(radius neighbors)
+    double hashTime; // Microseconds in hash functions
+    double scanTime; // Microseconds in bucket scans
+}queryStats;
+
+/* Histogram of a counter - Bucket 0 keeps zeros, bucket i keeps [2^(i-1), 2^i) */
+class statsHistogram{
+    private:
+        std::vector<long> buckets;
+        long count; // Values added
+        double sum;
+        double max;
+
+    public:
+        statsHistogram();
+
+        void add(double value);
+        void clear(void);
+
+        /* Accessors */
+        long getCount(void);
+        double getMean(void);
+        double getMax(void);
+        double percentile(double p); // Upper bound of bucket that contains percentile p
+
+        void print(std::string name, std::ostream& out = std::cout);
+};
+
+/* Histograms of every counter of many queries */
+class queryStatsHistograms{
+    private:
+        statsHistogram tablesProbed;
+        statsHistogram bucketsVisited;
+        statsHistogram candidatesScanned;
+        statsHistogram rejectionsG;
+        statsHistogram distanceComputations;
+        statsHistogram distancesAbandoned;
+        statsHistogram duplicatesSkipped;
+        statsHistogram hashTime;
+        statsHistogram scanTime;
+
+    public:
+        void add(queryStats& stats);
+        void clear(void);
+
+        long getQueries(void);
+
+        void print(std::ostream& out = std::cout);
+};
+
+/* Reset counters of a query */
+void resetQueryStats(queryStats& stats);
+
+#ifdef QUERY_STATS
+#define STATS_RESET(stats) resetQueryStats(stats)
+#define STATS_ADD(stats, counter, value) ((stats).counter += (value))
+#define STATS_START(timer) std::chrono::steady_clock::time_point timer = std::chrono::steady_clock::now()
+#define STATS_STOP(stats, counter, timer) ((stats).counter += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - (timer)).count())
+#define STATS_RECORD(histograms, stats) (histograms).add(stats)
+#else
+#define STATS_RESET(stats) ((void)0)
+#define STATS_ADD(stats, counter, value) ((void)0)
+#define STATS_START(timer) ((void)0)
+#define STATS_STOP(stats, counter, timer) ((void)0)
+#define STATS_RECORD(histograms, stats) ((void)0)
+#endif
+
+// Petropoulakis Panagiotis
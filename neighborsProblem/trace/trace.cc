@@ -0,0 +1,105 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include "trace.h"
+#include "../utils/utils.h"
+
+using namespace std;
+
+/* Recorded region */
+typedef struct traceEvent{
+    const char* name;
+    double begin; // Microseconds from start of program
+    double duration; // Microseconds
+    int thread;
+}traceEvent;
+
+/* Regions of every thread */
+static vector<traceEvent> events;
+static mutex eventsLock;
+
+/* Start of timestamps */
+static const chrono::steady_clock::time_point traceStart = chrono::steady_clock::now();
+
+/* Small ids of threads - Given in order of first region */
+static atomic<int> nextThread(1);
+static thread_local int threadId = 0;
+
+//////////////////////////////////////
+/* Implementation of traced regions */
+//////////////////////////////////////
+
+traceRegion::traceRegion(const char* name):name(name),begin(chrono::steady_clock::now()),ended(0){}
+
+traceRegion::~traceRegion(){
+    this->end();
+}
+
+/* Record region - Once */
+void traceRegion::end(void){
+    chrono::steady_clock::time_point finish = chrono::steady_clock::now();
+    traceEvent newEvent;
+
+    if(this->ended == 1)
+        return;
+
+    this->ended = 1;
+
+    if(threadId == 0)
+        threadId = nextThread++;
+
+    newEvent.name = this->name;
+    newEvent.begin = chrono::duration<double, micro>(this->begin - traceStart).count();
+    newEvent.duration = chrono::duration<double, micro>(finish - this->begin).count();
+    newEvent.thread = threadId;
+
+    lock_guard<mutex> guard(eventsLock);
+
+    if(events.size() < MAX_TRACE_EVENTS)
+        events.push_back(newEvent);
+}
+
+////////////////////
+/* Export regions */
+////////////////////
+
+/* Complete events("ph": "X") of one process */
+void writeTrace(string fileName, errorCode& status){
+    int i;
+    ofstream file;
+
+    status = SUCCESS;
+
+    file.open(fileName, ios::trunc);
+    if(!file){
+        status = INVALID_TRACE_FILE;
+        return;
+    }
+
+    lock_guard<mutex> guard(eventsLock);
+
+    file << "{\"traceEvents\": [\n";
+
+    for(i = 0; i < (int)events.size(); i++){
+        file << "  {\"name\": \"" << events[i].name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << events[i].thread;
+        file << ", \"ts\": " << fixed << events[i].begin << ", \"dur\": " << events[i].duration << "}";
+        file << (i + 1 < (int)events.size() ? ",\n" : "\n");
+    } // End for
+
+    file << "], \"displayTimeUnit\": \"ms\"}\n";
+
+    if(!file)
+        status = INVALID_TRACE_FILE;
+}
+
+void clearTrace(void){
+    lock_guard<mutex> guard(eventsLock);
+
+    events.clear();
+}
+
+// Petropoulakis Panagiotis
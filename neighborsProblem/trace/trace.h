@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <chrono>
+#include "../utils/utils.h"
+
+/* Timed regions of fit and queries(hash, scan) exported as a chrome trace       */
+/* (chrome://tracing or ui.perfetto.dev). Regions are recorded only if the       */
+/* library is compiled with -DTRACE_REGIONS, otherwise the macros are empty      */
+/* Up to MAX_TRACE_EVENTS regions are kept - Later regions are dropped           */
+#define MAX_TRACE_EVENTS 1000000
+
+/* Region that ends with end() or when it leaves its scope */
+class traceRegion{
+    private:
+        const char* name; // Literal
+        std::chrono::steady_clock::time_point begin;
+        int ended;
+
+    public:
+        traceRegion(const char* name);
+        ~traceRegion();
+
+        void end(void);
+};
+
+/* Write recorded regions in chrome trace format(json) */
+void writeTrace(std::string fileName, errorCode& status);
+
+/* Forget recorded regions */
+void clearTrace(void);
+
+#ifdef TRACE_REGIONS
+#define TRACE_SCOPE(name) traceRegion traceScope(name)
+#define TRACE_BEGIN(region, name) traceRegion region(name)
+#define TRACE_END(region) (region).end()
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_BEGIN(region, name) ((void)0)
+#define TRACE_END(region) ((void)0)
+#endif
+
+// Petropoulakis Panagiotis
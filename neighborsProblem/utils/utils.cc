@@ -1,7 +1,6 @@
 #include <iostream>
-#include <random>
 #include <bitset>
-#include <chrono>
+#include <unordered_set>
 #include <limits>
 #include <cmath>
 #include <time.h>
@@ -10,30 +9,136 @@
 
 using namespace std;
 
-/* Get random float number */
-/* Type 0: uniform float   */
-/* Type 1: standard float  */
-/* Type 2: uniform float   */
-float getRandom(int type, int w){
-    /* Set random engine */
-    static unsigned seed = chrono::system_clock::now().time_since_epoch().count();    
-    static default_random_engine generator(seed);
-        
-    /* Set uniform and standard distribution */
-    static uniform_real_distribution<float> uniformDist1(0, w); // [0,W)
-    static uniform_int_distribution<int> uniformDist2(MY_MIN_RANDOM, MY_MAX_RANDOM);
-    static normal_distribution<float> normalDist(0, 1); 
-
-    if(type == 0)
-        return uniformDist1(generator);
-    else if(type == 1)
-        return normalDist(generator);
-    else if(type == 2)
-        return (float)uniformDist2(generator);
-    else
-        return -1;
+//////////////////////////////////////////////
+/* Implementation of random generator class */
+//////////////////////////////////////////////
+
+static inline uint64_t rotateLeft(uint64_t x, int bits){
+    return (x << bits) | (x >> (64 - bits));
+}
+
+randomGenerator::randomGenerator(uint64_t seed){
+    this->seed(seed);
+}
+
+void randomGenerator::seed(uint64_t seed){
+    int i;
+    uint64_t z;
+
+    for(i = 0; i < 4; i++){
+        seed += 0x9e3779b97f4a7c15ULL;
+        z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        this->state[i] = z ^ (z >> 31);
+    }
+
+    this->hasSpare = 0;
+    this->spareNormal = 0;
+}
+
+uint64_t randomGenerator::next(void){
+    uint64_t result = rotateLeft(this->state[1] * 5, 7) * 9;
+    uint64_t t = this->state[1] << 17;
+
+    this->state[2] ^= this->state[0];
+    this->state[3] ^= this->state[1];
+    this->state[1] ^= this->state[2];
+    this->state[0] ^= this->state[3];
+    this->state[2] ^= t;
+    this->state[3] = rotateLeft(this->state[3], 45);
+
+    return result;
 }
 
+/* Upper 53 bits are the mantissa */
+double randomGenerator::uniform(void){
+    return (this->next() >> 11) * 0x1.0p-53;
+}
+
+double randomGenerator::uniform(double low, double high){
+    return low + (high - low) * this->uniform();
+}
+
+int randomGenerator::uniformInt(int low, int high){
+    uint64_t range = (uint64_t)((int64_t)high - low + 1);
+
+    return (int)(low + (int64_t)((this->next() >> 11) % range));
+}
+
+/* Polar method - Values are made in pairs */
+double randomGenerator::normal(void){
+    double x, y, s;
+
+    if(this->hasSpare == 1){
+        this->hasSpare = 0;
+        return this->spareNormal;
+    }
+
+    do{
+        x = this->uniform(-1, 1);
+        y = this->uniform(-1, 1);
+        s = x * x + y * y;
+    }while(s >= 1 || s == 0);
+
+    s = sqrt(-2 * log(s) / s);
+    this->spareNormal = y * s;
+    this->hasSpare = 1;
+
+    return x * s;
+}
+
+/* Fisher-Yates */
+void randomGenerator::shuffle(vector<int>& values){
+    int i, j, temp;
+
+    for(i = (int)values.size() - 1; i > 0; i--){
+        j = this->uniformInt(0, i);
+        temp = values[i];
+        values[i] = values[j];
+        values[j] = temp;
+    }
+}
+
+/* Repeated numbers are skipped - A set replaces comparisons of whole functions */
+void randomGenerator::uniqueSeeds(int count, vector<uint64_t>& seeds){
+    unordered_set<uint64_t> used;
+    uint64_t curr;
+
+    seeds.clear();
+    seeds.reserve(count);
+
+    while((int)seeds.size() < count){
+        curr = this->next();
+
+        if(used.insert(curr).second)
+            seeds.push_back(curr);
+    } // End while
+}
+
+void randomGenerator::jump(void){
+    static const uint64_t jumps[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t result[4] = {0, 0, 0, 0};
+    int i, b, j;
+
+    for(i = 0; i < 4; i++){
+        for(b = 0; b < 64; b++){
+            if(jumps[i] & ((uint64_t)1 << b))
+                for(j = 0; j < 4; j++)
+                    result[j] ^= this->state[j];
+
+            this->next();
+        }
+    } // End for
+
+    for(j = 0; j < 4; j++)
+        this->state[j] = result[j];
+}
+
+///////////////////////
+/* Usefull functions */
+///////////////////////
+
 /* Get mod of given number */
 int myMod(int x, int y){
     return ((x % y) + y) % y;
@@ -186,6 +291,28 @@ int hammingDistance(int x, int y){
     return bitset<32>(x^y).count();
 }
 
+/* Dot products of x with DOT_TILE vectors */
+void dotProducts(const double* x, const double* const* y, int dim, double* products){
+    double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    const double *y0 = y[0], *y1 = y[1], *y2 = y[2], *y3 = y[3];
+    double curr;
+    int i;
+
+    for(i = 0; i < dim; i++){
+        curr = x[i];
+
+        sum0 += curr * y0[i];
+        sum1 += curr * y1[i];
+        sum2 += curr * y2[i];
+        sum3 += curr * y3[i];
+    } // End for
+
+    products[0] = sum0;
+    products[1] = sum1;
+    products[2] = sum2;
+    products[3] = sum3;
+}
+
 /* Print type of error */
 void printError(errorCode& status){
 
@@ -267,6 +394,14 @@ void printError(errorCode& status){
         case(INVALID_METRICE):
             cout << "Models does not support give metrice\n";
             break;
+
+        case(INVALID_INDEX_FILE):
+            cout << "Please give a valid index file\n";
+            break;
+
+        case(INVALID_TRACE_FILE):
+            cout << "Can't write trace file\n";
+            break;
     } // End switch
 }
 
@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+#include <cstdint>
 
 /* Set limits */
 #define MAX_DIM 20000 // Max dimension
@@ -11,6 +13,19 @@
 #define MIN_PROBES 1// Min vertices probed  
 #define MAX_L 80 // Max  number of hash tables
 #define MIN_L 1
+#define MAX_TREES 64 // Max trees of a k-d forest
+#define MIN_TREES 1
+#define MIN_CHECKS 1 // Min points scanned by a query of a k-d forest
+#define MAX_DEGREE 100 // Max neighbors of a node of a hnsw graph(M)
+#define MIN_DEGREE 2
+#define MAX_EF 10000 // Max beam of a hnsw search
+#define MIN_EF 1
+#define MAX_LISTS 65536 // Max lists of an inverted file
+#define MIN_LISTS 1
+#define MAX_SUBQUANTIZERS 256 // Max bytes of a code of product quantization
+#define MIN_SUBQUANTIZERS 1
+#define MAX_RERANK 10000 // Max candidates checked with exact distances(pq, two stage search)
+#define MIN_RERANK 0
 #define MAX_C 1 // Max coefficient
 #define MIN_C 0.03125 // 1/32
 #define MAX_POINTS 1500000 // Max points that models can handle
@@ -19,6 +34,7 @@
 #define MIN_RADIUS 0
 #define MY_MAX_RANDOM 5
 #define MY_MIN_RANDOM -5
+#define DEFAULT_SEED 1 // Seed of models without a given seed
 
 /* Errors */
 typedef enum errorCode{
@@ -40,15 +56,43 @@ typedef enum errorCode{
     INVALID_RADIUS,
     INVALID_DATA_SET,
     METHOD_NOT_IMPLEMENTED,
-    INVALID_METRICE
+    INVALID_METRICE,
+    INVALID_INDEX_FILE,
+    INVALID_TRACE_FILE
 }errorCode;
 
 ///////////////////////
 /* Usefull functions */
 ///////////////////////
 
-/* Get random number - standard or uniform distribution */
-float getRandom(int type, int w = 4);
+/* Random generator of a model or a hash function(xoshiro256**) - A seed gives the same  */
+/* numbers in every process. Threads of a parallel fit take independent streams: copies */
+/* of a generator separated by jump                                                     */
+class randomGenerator{
+    private:
+        uint64_t state[4];
+        double spareNormal; // Second value of the polar method
+        int hasSpare;
+
+    public:
+        randomGenerator(uint64_t seed = DEFAULT_SEED);
+
+        /* Restart with given seed - States are filled by splitmix64 */
+        void seed(uint64_t seed);
+
+        uint64_t next(void);
+        double uniform(void); // [0, 1)
+        double uniform(double low, double high); // [low, high)
+        int uniformInt(int low, int high); // [low, high]
+        double normal(void); // Standard distribution
+        void shuffle(std::vector<int>& values);
+
+        /* Count different numbers - Seeds of functions that can not be the same */
+        void uniqueSeeds(int count, std::vector<uint64_t>& seeds);
+
+        /* Skip 2^128 numbers - Start of the next independent stream */
+        void jump(void);
+};
 
 /* My mod function. Works also with negative values */
 int myMod(int x, int y);
@@ -67,6 +111,14 @@ int myDivInt(int x, int y, errorCode& status);
 /* Hamming distance of two integers */
 int hammingDistance(int x, int y);
 
+/* Dot products of x with DOT_TILE vectors - Components of x are loaded once and */
+/* the independent sums hide the latency of additions(blocked exact search)      */
+#define DOT_TILE 4
+void dotProducts(const double* x, const double* const* y, int dim, double* products);
+
+/* Bounded euclidean distances check the partial sum once per block of dimensions */
+#define EARLY_ABANDON_BLOCK 16
+
 /* Print message of given error */
 void printError(errorCode& status);
 // Petropoulakis Panagiotis